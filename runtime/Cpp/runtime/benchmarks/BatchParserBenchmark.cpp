@@ -0,0 +1,140 @@
+/* Copyright (c) 2012-2017 The ANTLR Project. All rights reserved.
+ * Use of this file is governed by the BSD 3-clause license that
+ * can be found in the LICENSE.txt file in the project root.
+ */
+
+// antlr4_batch_benchmark: measures the time per document of parsing many small documents with the test grammar
+// of the runtime tests (tests/ExprGrammar.h).
+//
+//   antlr4_batch_benchmark [<documents> [<max threads>]]
+//
+// It compares creating recognizers for each document, taking them from a RecognizerPool for each document (one
+// lock for acquiring and one for returning them per document, which the threads contend for), and a BatchParser
+// (no locks per document). For the BatchParser it also prints how often threads stole work from others.
+
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <thread>
+
+#include "ANTLRInputStream.h"
+#include "BatchParser.h"
+#include "CommonTokenStream.h"
+#include "ParserInterpreter.h"
+#include "ParserRuleContext.h"
+#include "RecognizerPool.h"
+
+#include "ExprGrammar.h"
+
+using namespace antlr4;
+using antlr4::test::ExprGrammar;
+
+namespace {
+
+  std::unique_ptr<Lexer> createLexer(CharStream *input) {
+    auto lexer = ExprGrammar::createLexer(input);
+    lexer->removeErrorListeners();
+    return lexer;
+  }
+
+  std::unique_ptr<Parser> createParser(TokenStream *input) {
+    auto parser = ExprGrammar::createParser(input);
+    parser->removeErrorListeners();
+    return parser;
+  }
+
+  size_t parse(Parser &parser) {
+    static_cast<ParserInterpreter &>(parser).parse(ExprGrammar::RULE_prog);
+    return parser.getNumberOfSyntaxErrors();
+  }
+
+  std::vector<std::string> createDocuments(size_t count) {
+    std::vector<std::string> documents;
+    for (size_t i = 0; i < count; ++i) {
+      std::string name(1, static_cast<char>('a' + i % 26));
+      documents.push_back("def " + name + "(x, y) { x = " + std::to_string(i) + " * (y + " + name + ");\n"
+                          "  return x / 2 - y; }\n");
+    }
+    return documents;
+  }
+
+  template<typename Function>
+  void measure(const std::string &name, size_t threadCount, size_t documentCount, Function function) {
+    auto start = std::chrono::steady_clock::now();
+    size_t errors = function();
+    std::chrono::duration<double, std::micro> elapsed = std::chrono::steady_clock::now() - start;
+    std::cout << std::left << std::setw(24) << name << std::right << std::setw(8) << threadCount
+              << std::setw(14) << std::fixed << std::setprecision(2) << elapsed.count() / documentCount
+              << std::setw(14) << std::setprecision(0) << documentCount / elapsed.count() * 1e6;
+    if (errors > 0) {
+      std::cout << "  (" << errors << " syntax errors)";
+    }
+  }
+
+  /// Runs function(index) for all documents on the given number of threads, which share one counter.
+  template<typename Function>
+  size_t runShared(size_t threadCount, size_t documentCount, Function function) {
+    std::atomic<size_t> next(0);
+    std::atomic<size_t> errors(0);
+    std::vector<std::thread> threads;
+    for (size_t t = 0; t < threadCount; ++t) {
+      threads.emplace_back([&]() {
+        for (size_t i = next++; i < documentCount; i = next++) {
+          errors += function(i);
+        }
+      });
+    }
+    for (std::thread &thread : threads) {
+      thread.join();
+    }
+    return errors;
+  }
+
+}
+
+int main(int argc, const char *argv[]) {
+  size_t documentCount = argc > 1 ? std::stoul(argv[1]) : 20000;
+  size_t maxThreads = argc > 2 ? std::stoul(argv[2]) : std::max<size_t>(std::thread::hardware_concurrency(), 1);
+  std::vector<std::string> documents = createDocuments(documentCount);
+
+  std::cout << std::left << std::setw(24) << "method" << std::right << std::setw(8) << "threads"
+            << std::setw(14) << "us/document" << std::setw(14) << "documents/s" << std::endl;
+
+  for (size_t threadCount = 1; threadCount <= maxThreads; threadCount *= 2) {
+    measure("new recognizers", threadCount, documentCount, [&]() {
+      return runShared(threadCount, documentCount, [&](size_t i) {
+        ANTLRInputStream input(documents[i]);
+        std::unique_ptr<Lexer> lexer = createLexer(&input);
+        CommonTokenStream tokens(lexer.get());
+        std::unique_ptr<Parser> parser = createParser(&tokens);
+        return parse(*parser);
+      });
+    });
+    std::cout << std::endl;
+
+    RecognizerPool pool(createLexer, createParser);
+    measure("pool per document", threadCount, documentCount, [&]() {
+      return runShared(threadCount, documentCount, [&](size_t i) {
+        ANTLRInputStream input(documents[i]);
+        RecognizerPool::Lease lease = pool.acquire(&input);
+        return parse(*lease.getParser());
+      });
+    });
+    std::cout << std::endl;
+
+    // The first batch creates the recognizers and warms their DFAs, the second one is measured.
+    BatchParser batchParser(createLexer, createParser);
+    batchParser.setThreadCount(threadCount);
+    BatchParser::ParseFunction<size_t> parseFunction = parse;
+    batchParser.parse(documents, parseFunction);
+    measure("batch parser", threadCount, documentCount, [&]() {
+      size_t errors = 0;
+      for (const auto &outcome : batchParser.parse(documents, parseFunction)) {
+        errors += outcome.result;
+      }
+      return errors;
+    });
+    std::cout << "  (" << batchParser.getSteals() << " steals)" << std::endl;
+  }
+  return 0;
+}
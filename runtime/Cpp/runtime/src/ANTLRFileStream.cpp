@@ -7,6 +7,8 @@
 
 #include "ANTLRFileStream.h"
 
+#include <typeinfo>
+
 using namespace antlr4;
 
 void ANTLRFileStream::loadFromFile(const std::string &fileName) {
@@ -27,3 +29,11 @@ void ANTLRFileStream::loadFromFile(const std::string &fileName) {
 std::string ANTLRFileStream::getSourceName() const {
   return _fileName;
 }
+
+const char32_t* ANTLRFileStream::getContiguousData(size_t &size) {
+  if (typeid(*this) != typeid(ANTLRFileStream)) {
+    return nullptr;
+  }
+  size = _data.size();
+  return _data.data();
+}
@@ -23,6 +23,9 @@ namespace antlr4 {
     virtual void loadFromFile(const std::string &fileName);
     virtual std::string getSourceName() const override;
 
+    /// Returns the decoded input, unless a subclass may have changed LA() (see ANTLRInputStream).
+    virtual const char32_t* getContiguousData(size_t &size) override;
+
   private:
     std::string _fileName; // UTF-8 encoded file name.
   };
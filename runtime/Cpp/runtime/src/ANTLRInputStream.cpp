@@ -14,6 +14,8 @@
 
 #include "ANTLRInputStream.h"
 
+#include <typeinfo>
+
 using namespace antlr4;
 using namespace antlrcpp;
 
@@ -68,6 +70,14 @@ void ANTLRInputStream::load(std::istream &stream, bool lenient) {
   load(s.data(), s.length(), lenient);
 }
 
+void ANTLRInputStream::replace(size_t start, size_t length, std::u32string_view text) {
+  if (start > _data.size()) {
+    throw IllegalArgumentException("Replace start " + std::to_string(start) + " is beyond the end of the input.");
+  }
+  _data.replace(start, length, text);
+  p = std::min(p, _data.size());
+}
+
 void ANTLRInputStream::reset() {
   p = 0;
 }
@@ -124,15 +134,15 @@ void ANTLRInputStream::release(ssize_t /* marker */) {
 }
 
 void ANTLRInputStream::seek(size_t index) {
-  if (index <= p) {
-    p = index; // just jump; don't update stream state (line, ...)
-    return;
-  }
-  // seek forward, consume until p hits index or n (whichever comes first)
-  index = std::min(index, _data.size());
-  while (p < index) {
-    consume();
+  p = std::min(index, _data.size());
+}
+
+const char32_t* ANTLRInputStream::getContiguousData(size_t &size) {
+  if (typeid(*this) != typeid(ANTLRInputStream)) {
+    return nullptr;
   }
+  size = _data.size();
+  return _data.data();
 }
 
 std::string ANTLRInputStream::getText(const Interval &interval) {
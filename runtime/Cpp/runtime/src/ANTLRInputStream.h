@@ -42,6 +42,10 @@ namespace antlr4 {
     virtual void load(const char *data, size_t length) { load(data, length, false); }
     virtual void load(std::istream &stream) { load(stream, false); }
 
+    /// Replaces length code points from start on by text, e.g. to apply an edit of a document. The stream
+    /// position is kept, but not beyond the end of the input.
+    virtual void replace(size_t start, size_t length, std::u32string_view text);
+
     /// Reset the stream so that it's in the same state it was
     /// when the object was created *except* the data array is not
     /// touched.
@@ -63,15 +67,17 @@ namespace antlr4 {
     virtual ssize_t mark() override;
     virtual void release(ssize_t marker) override;
 
-    /// <summary>
-    /// consume() ahead until p==index; can't just set p=index as we must
-    ///  update line and charPositionInLine. If we seek backwards, just set p
-    /// </summary>
+    /// Set p=index, but not beyond the end of the input. There is no line or column state to update.
     virtual void seek(size_t index) override;
     virtual std::string getText(const misc::Interval &interval) override;
     virtual std::string getSourceName() const override;
     virtual std::string toString() const override;
 
+    /// Returns the decoded input, but only for exactly this class. Subclasses may override LA(), e.g. to lex case
+    /// insensitively, so they get nullptr and the lexer calls LA() for them. A subclass which leaves LA() alone
+    /// can opt in by overriding this to return _data.
+    virtual const char32_t* getContiguousData(size_t &size) override;
+
   private:
     void InitializeInstanceFields();
   };
@@ -0,0 +1,180 @@
+/* Copyright (c) 2012-2017 The ANTLR Project. All rights reserved.
+ * Use of this file is governed by the BSD 3-clause license that
+ * can be found in the LICENSE.txt file in the project root.
+ */
+
+#include "ANTLRInputStream.h"
+#include "BaseErrorListener.h"
+#include "Exceptions.h"
+#include "Lexer.h"
+#include "Parser.h"
+#include "support/CPPUtils.h"
+
+#include "BatchParser.h"
+
+#include <optional>
+
+using namespace antlrcpp;
+using namespace antlr4;
+
+namespace {
+
+  /// The syntax errors of the document the current thread parses.
+  thread_local std::vector<std::string> *currentSyntaxErrors = nullptr;
+
+  /// Collects the syntax errors of all recognizers of batch parsers, for the document their thread parses.
+  class SyntaxErrorCollector : public BaseErrorListener {
+  public:
+    virtual void syntaxError(Recognizer * /*recognizer*/, Token * /*offendingSymbol*/, size_t line,
+                             size_t charPositionInLine, const std::string &msg, std::exception_ptr /*e*/) override {
+      if (currentSyntaxErrors != nullptr) {
+        currentSyntaxErrors->push_back("line " + std::to_string(line) + ":" + std::to_string(charPositionInLine) +
+                                       " " + msg);
+      }
+    }
+  };
+
+  SyntaxErrorCollector syntaxErrorCollector;
+
+  /// The documents not yet parsed, a range of indexes per thread. A thread takes documents from the start of its
+  /// own range, and steals half of the range of another from its end, once its own is empty. The ranges are packed
+  /// into 64 bits each (start in the upper half), so all changes are single atomic operations.
+  class WorkQueues {
+  public:
+    WorkQueues(size_t count, size_t threadCount) : _ranges(threadCount) {
+      for (size_t i = 0; i < threadCount; ++i) {
+        _ranges[i].bounds.store(pack(count * i / threadCount, count * (i + 1) / threadCount));
+      }
+    }
+
+    /// Returns the index of the next document for the given thread, false if there is none left.
+    bool next(size_t thread, size_t &index) {
+      while (true) {
+        if (take(thread, index)) {
+          return true;
+        }
+        if (!steal(thread)) {
+          return false;
+        }
+      }
+    }
+
+    size_t getSteals() const {
+      return _steals.load();
+    }
+
+  private:
+    struct alignas(64) Range {
+      std::atomic<uint64_t> bounds { 0 };
+    };
+
+    std::vector<Range> _ranges;
+    std::atomic<size_t> _steals { 0 };
+
+    static uint64_t pack(size_t start, size_t end) {
+      return (static_cast<uint64_t>(start) << 32) | static_cast<uint64_t>(end);
+    }
+
+    bool take(size_t thread, size_t &index) {
+      std::atomic<uint64_t> &bounds = _ranges[thread].bounds;
+      uint64_t current = bounds.load();
+      while (true) {
+        size_t start = static_cast<size_t>(current >> 32);
+        size_t end = static_cast<size_t>(current & 0xFFFFFFFF);
+        if (start >= end) {
+          return false;
+        }
+        if (bounds.compare_exchange_weak(current, pack(start + 1, end))) {
+          index = start;
+          return true;
+        }
+      }
+    }
+
+    bool steal(size_t thread) {
+      for (size_t i = 1; i < _ranges.size(); ++i) {
+        std::atomic<uint64_t> &bounds = _ranges[(thread + i) % _ranges.size()].bounds;
+        uint64_t current = bounds.load();
+        while (true) {
+          size_t start = static_cast<size_t>(current >> 32);
+          size_t end = static_cast<size_t>(current & 0xFFFFFFFF);
+          if (start >= end) {
+            break;
+          }
+          size_t middle = end - (end - start + 1) / 2;
+          if (bounds.compare_exchange_weak(current, pack(start, middle))) {
+            // Only this thread adds to its own range, which is empty, so others can only fail to take from it.
+            _ranges[thread].bounds.store(pack(middle, end));
+            ++_steals;
+            return true;
+          }
+        }
+      }
+      return false;
+    }
+  };
+
+}
+
+BatchParser::BatchParser(RecognizerPool::LexerFactory lexerFactory, RecognizerPool::ParserFactory parserFactory)
+  : _pool([lexerFactory](CharStream *input) {
+      std::unique_ptr<Lexer> lexer = lexerFactory(input);
+      lexer->addErrorListener(&syntaxErrorCollector);
+      return lexer;
+    }, [parserFactory](TokenStream *input) {
+      std::unique_ptr<Parser> parser = parserFactory(input);
+      parser->addErrorListener(&syntaxErrorCollector);
+      return parser;
+    }) {
+}
+
+BatchParser::~BatchParser() {
+}
+
+void BatchParser::setThreadCount(size_t threadCount) {
+  _threadCount = threadCount;
+}
+
+RecognizerPool& BatchParser::getRecognizerPool() {
+  return _pool;
+}
+
+size_t BatchParser::getSteals() const {
+  return _steals;
+}
+
+std::vector<std::vector<std::string>> BatchParser::run(const std::vector<std::string> &documents,
+  const std::function<void(size_t index, Parser &parser)> &parseDocument) {
+  if (documents.size() >= 0xFFFFFFFF) {
+    throw IllegalArgumentException("too many documents for one batch: " + std::to_string(documents.size()));
+  }
+
+  size_t threadCount = std::max<size_t>(std::min(getThreadCount(_threadCount), documents.size()), 1);
+
+  std::vector<std::vector<std::string>> syntaxErrors(documents.size());
+  WorkQueues queues(documents.size(), threadCount);
+
+  // One task per work queue, the steals are counted even if a document fails.
+  auto countSteals = finally([&] {
+    _steals = queues.getSteals();
+  });
+  runConcurrently(threadCount, threadCount, [&](size_t thread) {
+    std::optional<RecognizerPool::Lease> lease;
+    size_t index;
+    while (queues.next(thread, index)) {
+      ANTLRInputStream input(documents[index]);
+      if (lease.has_value()) {
+        lease->setInputStream(&input);
+      } else {
+        lease.emplace(_pool.acquire(&input));
+      }
+
+      currentSyntaxErrors = &syntaxErrors[index];
+      auto onExit = finally([] {
+        currentSyntaxErrors = nullptr;
+      });
+      parseDocument(index, *lease->getParser());
+    }
+  });
+  return syntaxErrors;
+}
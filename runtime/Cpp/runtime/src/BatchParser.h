@@ -0,0 +1,81 @@
+/* Copyright (c) 2012-2017 The ANTLR Project. All rights reserved.
+ * Use of this file is governed by the BSD 3-clause license that
+ * can be found in the LICENSE.txt file in the project root.
+ */
+
+#pragma once
+
+#include "RecognizerPool.h"
+
+namespace antlr4 {
+
+  /// Parses many small documents, e.g. queries or filter expressions, on several threads. The documents are
+  /// distributed over the threads by work stealing: each thread starts on its own share of them and, when done,
+  /// takes half of what is left of the share of another. Each thread acquires one set of recognizers from a
+  /// RecognizerPool and resets it for each of its documents, so a batch takes no locks per document, and the
+  /// recognizers are kept for the next batch. Parsers of the same generated class share their DFA, so the threads
+  /// warm it together.
+  class ANTLR4CPP_PUBLIC BatchParser {
+  public:
+    /// What parsing a document gave.
+    template<typename Result>
+    struct Outcome {
+      /// What the parse function returned.
+      Result result = Result();
+
+      /// The syntax errors the lexer and parser reported, as "line <line>:<column> <message>".
+      std::vector<std::string> syntaxErrors;
+
+      /// What the parse function threw, if it did.
+      std::exception_ptr error;
+    };
+
+    /// Parses a document with the given parser, which is set up to read it, and returns the result, e.g. by
+    /// calling its start rule and converting the tree. The tree and tokens are deleted when the next document is
+    /// parsed, so they must not be part of the result.
+    template<typename Result>
+    using ParseFunction = std::function<Result(Parser &parser)>;
+
+    BatchParser(RecognizerPool::LexerFactory lexerFactory, RecognizerPool::ParserFactory parserFactory);
+    virtual ~BatchParser();
+
+    /// Sets the number of threads to use, the calling one included. The default of 0 uses as many as there are
+    /// hardware threads.
+    void setThreadCount(size_t threadCount);
+
+    /// Parses the documents and returns what each gave, in their order.
+    template<typename Result>
+    std::vector<Outcome<Result>> parse(const std::vector<std::string> &documents,
+                                       const ParseFunction<Result> &parseFunction) {
+      std::vector<Outcome<Result>> outcomes(documents.size());
+      std::vector<std::vector<std::string>> syntaxErrors = run(documents, [&](size_t index, Parser &parser) {
+        try {
+          outcomes[index].result = parseFunction(parser);
+        } catch (...) {
+          outcomes[index].error = std::current_exception();
+        }
+      });
+      for (size_t i = 0; i < outcomes.size(); ++i) {
+        outcomes[i].syntaxErrors = std::move(syntaxErrors[i]);
+      }
+      return outcomes;
+    }
+
+    /// The pool the recognizers are taken from.
+    RecognizerPool& getRecognizerPool();
+
+    /// The number of times a thread took documents from the share of another in the last batch.
+    size_t getSteals() const;
+
+  private:
+    RecognizerPool _pool;
+    size_t _threadCount = 0;
+    size_t _steals = 0;
+
+    /// Calls parseDocument for each document with recognizers set up for it, and returns the syntax errors of
+    /// each. Rethrows the first exception thrown outside of parseDocument, e.g. by the recognizer factories.
+    std::vector<std::vector<std::string>> run(const std::vector<std::string> &documents,
+                                              const std::function<void(size_t index, Parser &parser)> &parseDocument);
+  };
+
+} // namespace antlr4
@@ -91,24 +91,30 @@ size_t BufferedTokenStream::fetch(size_t n) {
     return 0;
   }
 
-  size_t i = 0;
-  while (i < n) {
-    std::unique_ptr<Token> t(_tokenSource->nextToken());
-
-    if (is<WritableToken *>(t.get())) {
-      (static_cast<WritableToken *>(t.get()))->setTokenIndex(_tokens.size());
+  size_t start = _tokens.size();
+  auto setTokenIndexes = [this, start]() {
+    for (size_t i = start; i < _tokens.size(); ++i) {
+      if (is<WritableToken *>(_tokens[i].get())) {
+        (static_cast<WritableToken *>(_tokens[i].get()))->setTokenIndex(i);
+      }
     }
+  };
 
-    _tokens.push_back(std::move(t));
-    ++i;
+  size_t fetched;
+  try {
+    fetched = _tokenSource->nextTokens(_tokens, n);
+  } catch (...) {
+    // The tokens of the batch appended before the error stay in the buffer, as they did when fetching one at a time.
+    setTokenIndexes();
+    throw;
+  }
+  setTokenIndexes();
 
-    if (_tokens.back()->getType() == Token::EOF) {
-      _fetchedEOF = true;
-      break;
-    }
+  if (fetched > 0 && _tokens.back()->getType() == Token::EOF) {
+    _fetchedEOF = true;
   }
 
-  return i;
+  return fetched;
 }
 
 Token* BufferedTokenStream::get(size_t i) const {
@@ -408,6 +414,35 @@ void BufferedTokenStream::fill() {
   }
 }
 
+std::vector<std::unique_ptr<Token>> BufferedTokenStream::replace(size_t start, size_t stop,
+                                                                 std::vector<std::unique_ptr<Token>> tokens) {
+  if (start > stop || stop > _tokens.size()) {
+    throw IndexOutOfBoundsException("replace(" + std::to_string(start) + ", " + std::to_string(stop) +
+                                    ") with " + std::to_string(_tokens.size()) + " tokens");
+  }
+
+  std::vector<std::unique_ptr<Token>> replaced;
+  for (size_t i = start; i < stop; ++i) {
+    replaced.push_back(std::move(_tokens[i]));
+  }
+  size_t count = tokens.size();
+  _tokens.erase(_tokens.begin() + static_cast<ssize_t>(start), _tokens.begin() + static_cast<ssize_t>(stop));
+  _tokens.insert(_tokens.begin() + static_cast<ssize_t>(start), std::make_move_iterator(tokens.begin()),
+                 std::make_move_iterator(tokens.end()));
+
+  // The tokens after the replaced ones keep their index if the count did not change.
+  size_t end = count == stop - start ? start + count : _tokens.size();
+  for (size_t i = start; i < end; ++i) {
+    if (is<WritableToken *>(_tokens[i].get())) {
+      (static_cast<WritableToken *>(_tokens[i].get()))->setTokenIndex(i);
+    }
+  }
+  _fetchedEOF = !_tokens.empty() && _tokens.back()->getType() == Token::EOF;
+
+  reset();
+  return replaced;
+}
+
 void BufferedTokenStream::InitializeInstanceFields() {
   _needSetup = true;
   _fetchedEOF = false;
@@ -94,6 +94,12 @@ namespace antlr4 {
     /// Get all tokens from lexer until EOF.
     virtual void fill();
 
+    /// Replaces the tokens from start up to (not including) stop by the given ones and renumbers the tokens
+    /// after them, e.g. after re-lexing part of the input (see IncrementalLexer). The replaced tokens are
+    /// returned, as they may still be referred to. The stream is reset to its first token.
+    virtual std::vector<std::unique_ptr<Token>> replace(size_t start, size_t stop,
+                                                        std::vector<std::unique_ptr<Token>> tokens);
+
   protected:
     /**
      * The {@link TokenSource} from which tokens for this stream are fetched.
@@ -9,3 +9,8 @@ using namespace antlr4;
 
 CharStream::~CharStream() {
 }
+
+const char32_t* CharStream::getContiguousData(size_t &size) {
+  size = 0;
+  return nullptr;
+}
@@ -31,6 +31,12 @@ namespace antlr4 {
     /// getting the text of the specified interval </exception>
     virtual std::string getText(const misc::Interval &interval) = 0;
 
+    /// If this stream keeps all its code points in one buffer, such that LA(1) is {@code data[index()]} and seek()
+    /// is cheap, returns the buffer and sets {@code size} to the number of code points. Otherwise returns nullptr
+    /// (the default). The lexer then matches tokens directly on the buffer instead of calling LA() and consume()
+    /// for every character.
+    virtual const char32_t* getContiguousData(size_t &size);
+
     virtual std::string toString() const = 0;
   };
 
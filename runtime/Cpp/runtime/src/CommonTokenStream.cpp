@@ -25,19 +25,12 @@ Token* CommonTokenStream::LB(size_t k) {
     return nullptr;
   }
 
-  ssize_t i = static_cast<ssize_t>(_p);
-  size_t n = 1;
-  // find k good tokens looking backwards
-  while (n <= k) {
-    // skip off-channel tokens
-    i = previousTokenOnChannel(i - 1, channel);
-    n++;
-  }
-  if (i < 0) {
+  indexTokens();
+  size_t position = _onChannelBefore[_p];
+  if (k > position) {
     return nullptr;
   }
-
-  return _tokens[i].get();
+  return _tokens[_onChannelTokens[position - k]].get();
 }
 
 Token* CommonTokenStream::LT(ssize_t k) {
@@ -48,31 +41,101 @@ Token* CommonTokenStream::LT(ssize_t k) {
   if (k < 0) {
     return LB(static_cast<size_t>(-k));
   }
-  size_t i = _p;
-  ssize_t n = 1; // we know tokens[p] is a good one
-                 // find k good tokens
-  while (n < k) {
-    // skip off-channel tokens, but make sure to not look past EOF
-    if (sync(i + 1)) {
-      i = nextTokenOnChannel(i + 1, channel);
-    }
-    n++;
+
+  // tokens[p] is on the channel, the k-th one is k - 1 further. Past EOF it stays at EOF.
+  indexTokens();
+  size_t position = _onChannelBefore[_p] + static_cast<size_t>(k) - 1;
+  syncOnChannel(position);
+  if (position >= _onChannelTokens.size()) {
+    return _tokens.back().get();
   }
+  return _tokens[_onChannelTokens[position]].get();
+}
 
-  return _tokens[i].get();
+void CommonTokenStream::setTokenSource(TokenSource *tokenSource) {
+  _onChannelTokens.clear();
+  _onChannelBefore.clear();
+  BufferedTokenStream::setTokenSource(tokenSource);
+}
+
+std::vector<std::unique_ptr<Token>> CommonTokenStream::replace(size_t start, size_t stop,
+                                                               std::vector<std::unique_ptr<Token>> tokens) {
+  // The tokens before start stay, so does their part of the index.
+  if (start < _onChannelBefore.size()) {
+    _onChannelTokens.resize(_onChannelBefore[start]);
+    _onChannelBefore.resize(start);
+  }
+  return BufferedTokenStream::replace(start, stop, std::move(tokens));
 }
 
 int CommonTokenStream::getNumberOfOnChannelTokens() {
-  int n = 0;
   fill();
-  for (size_t i = 0; i < _tokens.size(); i++) {
-    Token *t = _tokens[i].get();
-    if (t->getChannel() == channel) {
-      n++;
+  indexTokens();
+  if (_onChannelTokens.empty()) {
+    return 0;
+  }
+
+  // The EOF token is indexed as on every channel, but counts only if it is on this one.
+  int n = static_cast<int>(_onChannelTokens.size());
+  Token *last = _tokens[_onChannelTokens.back()].get();
+  if (last->getType() == Token::EOF && last->getChannel() != channel) {
+    --n;
+  }
+  return n;
+}
+
+ssize_t CommonTokenStream::nextTokenOnChannel(size_t i, size_t channel_) {
+  if (channel_ != channel) {
+    return BufferedTokenStream::nextTokenOnChannel(i, channel_);
+  }
+
+  sync(i);
+  if (i >= size()) {
+    return size() - 1;
+  }
+  indexTokens();
+  size_t position = _onChannelBefore[i];
+  syncOnChannel(position);
+  if (position >= _onChannelTokens.size()) {
+    return size() - 1;
+  }
+  return _onChannelTokens[position];
+}
+
+ssize_t CommonTokenStream::previousTokenOnChannel(size_t i, size_t channel_) {
+  if (channel_ != channel) {
+    return BufferedTokenStream::previousTokenOnChannel(i, channel_);
+  }
+
+  sync(i);
+  if (i >= size()) {
+    // the EOF token is on every channel
+    return size() - 1;
+  }
+  indexTokens();
+  size_t position = _onChannelBefore[i];
+  if (position < _onChannelTokens.size() && _onChannelTokens[position] == i) {
+    return i;
+  }
+  return position == 0 ? -1 : static_cast<ssize_t>(_onChannelTokens[position - 1]);
+}
+
+void CommonTokenStream::indexTokens() {
+  for (size_t i = _onChannelBefore.size(); i < _tokens.size(); ++i) {
+    _onChannelBefore.push_back(_onChannelTokens.size());
+    Token *token = _tokens[i].get();
+    if (token->getChannel() == channel || token->getType() == Token::EOF) {
+      _onChannelTokens.push_back(i);
     }
-    if (t->getType() == Token::EOF) {
+  }
+}
+
+void CommonTokenStream::syncOnChannel(size_t n) {
+  while (_onChannelTokens.size() <= n && !_fetchedEOF) {
+    size_t fetched = fetch(n + 1 - _onChannelTokens.size());
+    indexTokens();
+    if (fetched == 0) {
       break;
     }
   }
-  return n;
 }
@@ -32,6 +32,18 @@ namespace antlr4 {
    * {@link Lexer#skip} do not produce tokens at all, so input text matched by
    * such a rule will not be available as part of the token stream, regardless of
    * channel.</p>
+   *
+   * <p>
+   * The stream keeps an index of the positions of the tokens on its channel,
+   * extended as tokens are fetched, so lookahead and the search for the
+   * next or previous token on that channel do not step over off-channel tokens
+   * one by one.</p>
+   *
+   * <p>
+   * The index is built from the channel each token has when it is fetched and
+   * is not updated afterwards. Hence the channel of a token must not change once
+   * it is in the stream, e.g. through {@link WritableToken#setChannel}. Tokens
+   * replaced through {@link #replace} are indexed again.</p>
    */
   class ANTLR4CPP_PUBLIC CommonTokenStream : public BufferedTokenStream {
   public:
@@ -57,6 +69,11 @@ namespace antlr4 {
 
     virtual Token* LT(ssize_t k) override;
 
+    virtual void setTokenSource(TokenSource *tokenSource) override;
+
+    virtual std::vector<std::unique_ptr<Token>> replace(size_t start, size_t stop,
+                                                        std::vector<std::unique_ptr<Token>> tokens) override;
+
     /// Count EOF just once.
     virtual int getNumberOfOnChannelTokens();
     
@@ -74,6 +91,22 @@ namespace antlr4 {
 
     virtual Token* LB(size_t k) override;
 
+    virtual ssize_t nextTokenOnChannel(size_t i, size_t channel) override;
+    virtual ssize_t previousTokenOnChannel(size_t i, size_t channel) override;
+
+  private:
+    /// The indexes of the tokens on the channel, and of the EOF token, which is on every channel.
+    std::vector<size_t> _onChannelTokens;
+
+    /// For each token indexed so far, the number of tokens on the channel before it, i.e. the position in
+    /// _onChannelTokens of the first such token at or after it.
+    std::vector<size_t> _onChannelBefore;
+
+    /// Indexes the tokens fetched since the last call.
+    void indexTokens();
+
+    /// Fetches tokens until the index has more than n tokens on the channel, or up to EOF.
+    void syncOnChannel(size_t n);
   };
 
 } // namespace antlr4
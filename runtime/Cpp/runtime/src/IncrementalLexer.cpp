@@ -0,0 +1,161 @@
+/* Copyright (c) 2012-2017 The ANTLR Project. All rights reserved.
+ * Use of this file is governed by the BSD 3-clause license that
+ * can be found in the LICENSE.txt file in the project root.
+ */
+
+#include "ANTLRInputStream.h"
+#include "BufferedTokenStream.h"
+#include "CommonToken.h"
+#include "Exceptions.h"
+#include "Lexer.h"
+#include "atn/LexerATNSimulator.h"
+#include "support/Utf8.h"
+
+#include "IncrementalLexer.h"
+
+using namespace antlr4;
+
+IncrementalLexer::IncrementalLexer(Lexer *lexer, ANTLRInputStream *input) : _lexer(lexer), _input(input) {
+}
+
+std::unique_ptr<Token> IncrementalLexer::nextToken() {
+  TokenState state;
+  std::unique_ptr<Token> token = lexToken(state);
+  _states.push_back(std::move(state));
+  return token;
+}
+
+size_t IncrementalLexer::getLine() const {
+  return _lexer->getLine();
+}
+
+size_t IncrementalLexer::getCharPositionInLine() {
+  return _lexer->getCharPositionInLine();
+}
+
+CharStream* IncrementalLexer::getInputStream() {
+  return _input;
+}
+
+std::string IncrementalLexer::getSourceName() {
+  return _lexer->getSourceName();
+}
+
+TokenFactory<CommonToken>* IncrementalLexer::getTokenFactory() {
+  return _lexer->getTokenFactory();
+}
+
+IncrementalLexer::Change IncrementalLexer::edit(BufferedTokenStream &tokens, const Edit &edit) {
+  if (tokens.getTokenSource() != this) {
+    throw IllegalArgumentException("The token stream does not read from this incremental lexer.");
+  }
+  tokens.fill();
+  if (tokens.size() != _states.size()) {
+    throw IllegalStateException("The incremental lexer passed on other tokens than those of the token stream.");
+  }
+  if (edit.offset + edit.deletedLength > _input->size()) {
+    throw IllegalArgumentException("The edit is beyond the end of the input.");
+  }
+  auto inserted = antlrcpp::Utf8::strictDecode(edit.insertedText);
+  if (!inserted.has_value()) {
+    throw IllegalArgumentException("UTF-8 string contains an illegal byte sequence");
+  }
+
+  _input->replace(edit.offset, edit.deletedLength, *inserted);
+  size_t delta = inserted->size() - edit.deletedLength; // Modulo, added to old positions.
+  size_t editEnd = edit.offset + inserted->size();
+
+  // The tokens before the first one whose lexer looked at the edited text stay the same. The EOF token always
+  // looked at the end of the input.
+  size_t start = 0;
+  while (_states[start].lookaheadEnd <= edit.offset) {
+    ++start;
+  }
+
+  const TokenState &restart = _states[start];
+  _lexer->reset();
+  _input->seek(restart.index);
+  _lexer->setLine(restart.line);
+  _lexer->setCharPositionInLine(restart.charPositionInLine);
+  _lexer->mode = restart.mode;
+  _lexer->modeStack = restart.modeStack;
+
+  // Lex until past the edit in the state of an old token, or up to EOF.
+  std::vector<std::unique_ptr<Token>> newTokens;
+  std::vector<TokenState> newStates;
+  size_t stop = _states.size();
+  size_t old = start;
+  while (newTokens.empty() || newTokens.back()->getType() != Token::EOF) {
+    size_t index = _input->index();
+    if (index >= editEnd) {
+      size_t oldIndex = index - delta;
+      while (old < _states.size() && _states[old].index < oldIndex) {
+        ++old;
+      }
+      for (size_t i = old; i < _states.size() && _states[i].index == oldIndex; ++i) {
+        if (_states[i].mode == _lexer->mode && _states[i].modeStack == _lexer->modeStack) {
+          stop = i;
+          break;
+        }
+      }
+      if (stop < _states.size()) {
+        break;
+      }
+    }
+
+    TokenState state;
+    newTokens.push_back(lexToken(state));
+    newStates.push_back(std::move(state));
+  }
+
+  if (stop < _states.size()) {
+    // The text after the edit is the same, so are its tokens. Those on the line where lexing stopped move by the
+    // change in column as well.
+    size_t oldLine = _states[stop].line;
+    size_t lineDelta = _lexer->getLine() - oldLine;
+    size_t columnDelta = _lexer->getCharPositionInLine() - _states[stop].charPositionInLine;
+    for (size_t i = stop; i < _states.size(); ++i) {
+      TokenState &state = _states[i];
+      if (state.line == oldLine) {
+        state.charPositionInLine += columnDelta;
+      }
+      state.line += lineDelta;
+      state.index += delta;
+      state.lookaheadEnd += delta;
+
+      CommonToken *token = dynamic_cast<CommonToken *>(tokens.get(i));
+      if (token == nullptr) {
+        throw UnsupportedOperationException("Incremental lexing needs CommonToken tokens.");
+      }
+      if (token->getLine() == oldLine) {
+        token->setCharPositionInLine(token->getCharPositionInLine() + columnDelta);
+      }
+      token->setLine(token->getLine() + lineDelta);
+      token->setStartIndex(token->getStartIndex() + delta);
+      token->setStopIndex(token->getStopIndex() + delta);
+    }
+  }
+
+  Change change = { start, stop - start, newTokens.size() };
+  _states.erase(_states.begin() + static_cast<ssize_t>(start), _states.begin() + static_cast<ssize_t>(stop));
+  _states.insert(_states.begin() + static_cast<ssize_t>(start), std::make_move_iterator(newStates.begin()),
+                 std::make_move_iterator(newStates.end()));
+  tokens.replace(start, stop, std::move(newTokens));
+  return change;
+}
+
+std::unique_ptr<Token> IncrementalLexer::lexToken(TokenState &state) {
+  state.index = _input->index();
+  state.line = _lexer->getLine();
+  state.charPositionInLine = _lexer->getCharPositionInLine();
+  state.mode = _lexer->mode;
+  state.modeStack = _lexer->modeStack;
+
+  atn::LexerATNSimulator *interpreter = _lexer->getInterpreter<atn::LexerATNSimulator>();
+  interpreter->setLookaheadEnd(0);
+  std::unique_ptr<Token> token = _lexer->nextToken();
+
+  // The lexer checks for EOF before matching.
+  state.lookaheadEnd = std::max(interpreter->getLookaheadEnd(), state.index + 1);
+  return token;
+}
@@ -0,0 +1,77 @@
+/* Copyright (c) 2012-2017 The ANTLR Project. All rights reserved.
+ * Use of this file is governed by the BSD 3-clause license that
+ * can be found in the LICENSE.txt file in the project root.
+ */
+
+#pragma once
+
+#include "TokenSource.h"
+
+namespace antlr4 {
+
+  /// Keeps the tokens of a document up to date while it is edited, re-lexing only around each edit.
+  ///
+  /// The incremental lexer is the token source of a BufferedTokenStream (or CommonTokenStream) and passes on the
+  /// tokens of the lexer, recording the lexer's state (position, line, column, mode and mode stack) before each
+  /// token and how far the lexer looked ahead to match it (see LexerATNSimulator::getLookaheadEnd()). On an edit,
+  /// lexing restarts at the first token whose lookahead reached the edit, as the tokens before it cannot change,
+  /// and stops as soon as the lexer is past the edit in a state an old token started in: the tokens from there
+  /// on are the same as before, so they are kept and only their positions are shifted.
+  ///
+  /// This gives the same tokens as lexing the edited document from scratch, provided the lexer's state between
+  /// tokens is described by its mode stack, i.e. lexer actions keep no state of their own, and predicates look no
+  /// further ahead than the lexer itself. The tokens must be CommonTokens (the default).
+  class ANTLR4CPP_PUBLIC IncrementalLexer : public TokenSource {
+  public:
+    /// Replaces deletedLength code points of the input from offset on by insertedText, encoded in UTF-8.
+    struct Edit {
+      size_t offset;
+      size_t deletedLength;
+      std::string insertedText;
+    };
+
+    /// The tokens an edit replaced: removed tokens from start on, by inserted new ones.
+    struct Change {
+      size_t start;
+      size_t removed;
+      size_t inserted;
+    };
+
+    /// The lexer must read from input, from its start.
+    IncrementalLexer(Lexer *lexer, ANTLRInputStream *input);
+
+    virtual std::unique_ptr<Token> nextToken() override;
+    virtual size_t getLine() const override;
+    virtual size_t getCharPositionInLine() override;
+    virtual CharStream* getInputStream() override;
+    virtual std::string getSourceName() override;
+    virtual TokenFactory<CommonToken>* getTokenFactory() override;
+
+    /// Applies the edit to the input and updates the tokens of the given stream, whose token source must be this
+    /// object. The stream is filled first and reset to its first token afterwards. Tokens which are not replaced
+    /// stay the same objects.
+    Change edit(BufferedTokenStream &tokens, const Edit &edit);
+
+  private:
+    /// The lexer's state before a token.
+    struct TokenState {
+      size_t index;
+      size_t line;
+      size_t charPositionInLine;
+      size_t mode;
+      std::vector<size_t> modeStack;
+
+      /// The index after the last character looked at while matching the token.
+      size_t lookaheadEnd;
+    };
+
+    Lexer *_lexer;
+    ANTLRInputStream *_input;
+
+    /// The state before each token of the stream.
+    std::vector<TokenState> _states;
+
+    std::unique_ptr<Token> lexToken(TokenState &state);
+  };
+
+} // namespace antlr4
@@ -31,7 +31,9 @@ Lexer::Lexer(CharStream *input) : Recognizer(), _input(input) {
 
 void Lexer::reset() {
   // wack Lexer state variables
-  _input->seek(0); // rewind the input
+  if (_input != nullptr) {
+    _input->seek(0); // rewind the input
+  }
 
   _syntaxErrors = 0;
   token.reset();
@@ -101,6 +103,26 @@ std::unique_ptr<Token> Lexer::nextToken() {
   }
 }
 
+size_t Lexer::nextTokens(std::vector<std::unique_ptr<Token>> &tokens, size_t n) {
+  // One mark for the whole batch, it keeps the text of all its tokens available in unbuffered streams.
+  ssize_t tokenStartMarker = _input->mark();
+
+  auto onExit = finally([this, tokenStartMarker]{
+    _input->release(tokenStartMarker);
+  });
+
+  // Each token through nextToken(), so subclasses overriding it, e.g. to inject or rewrite tokens, see all of them.
+  size_t i = 0;
+  while (i < n) {
+    tokens.push_back(nextToken());
+    ++i;
+    if (tokens.back()->getType() == EOF) {
+      break;
+    }
+  }
+  return i;
+}
+
 void Lexer::skip() {
   type = SKIP;
 }
@@ -141,6 +163,7 @@ TokenFactory<CommonToken>* Lexer::getTokenFactory() {
 }
 
 void Lexer::setInputStream(IntStream *input) {
+  _input = nullptr; // The previous input may be gone already.
   reset();
   _input = dynamic_cast<CharStream*>(input);
 }
@@ -226,12 +249,12 @@ size_t Lexer::getChannel() {
 }
 
 std::vector<std::unique_ptr<Token>> Lexer::getAllTokens() {
+  const size_t blockSize = 1000;
   std::vector<std::unique_ptr<Token>> tokens;
-  std::unique_ptr<Token> t = nextToken();
-  while (t->getType() != EOF) {
-    tokens.push_back(std::move(t));
-    t = nextToken();
+  while (tokens.empty() || tokens.back()->getType() != EOF) {
+    nextTokens(tokens, blockSize);
   }
+  tokens.pop_back();
   return tokens;
 }
 
@@ -281,8 +304,17 @@ size_t Lexer::getNumberOfSyntaxErrors() {
   return _syntaxErrors;
 }
 
+void Lexer::setInlineSkipAndChannel(bool enable) {
+  _inlineSkipAndChannel = enable;
+}
+
+bool Lexer::isInlineSkipAndChannel() const {
+  return _inlineSkipAndChannel;
+}
+
 void Lexer::InitializeInstanceFields() {
   _syntaxErrors = 0;
+  _inlineSkipAndChannel = false;
   token = nullptr;
   _factory = CommonTokenFactory::DEFAULT.get();
   tokenStartCharIndex = INVALID_INDEX;
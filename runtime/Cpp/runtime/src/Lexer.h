@@ -84,11 +84,19 @@ namespace antlr4 {
     /// Return a token from this source; i.e., match a token on the char stream.
     virtual std::unique_ptr<Token> nextToken() override;
 
+    /// Matches up to {@code n} tokens in one go through nextToken(), so overrides of it apply. The whole batch
+    /// shares a single mark in the char stream, which keeps the text of its tokens in unbuffered streams.
+    virtual size_t nextTokens(std::vector<std::unique_ptr<Token>> &tokens, size_t n) override;
+
     /// Instruct the lexer to skip creating a token for current lexer rule
     /// and look for another token.  nextToken() knows to keep looking when
     /// a lexer rule finishes with token set to SKIP_TOKEN.  Recall that
     /// if token == null at end of any token rule, it creates one for you
     /// and emits it.
+    ///
+    /// With setInlineSkipAndChannel(true), rules whose only actions are {@code -> skip} or
+    /// {@code -> channel(...)} are handled by the LexerATNSimulator directly, without calling skip() or
+    /// setChannel().
     virtual void skip();
     virtual void more();
     virtual void setMode(size_t m);
@@ -102,7 +110,8 @@ namespace antlr4 {
 
     virtual TokenFactory<CommonToken>* getTokenFactory() override;
 
-    /// Set the char stream and reset the lexer
+    /// Set the char stream and reset the lexer. The previous char stream is not used any more, so it may be gone
+    /// already, which allows reusing a lexer for one input after another (see RecognizerPool).
     virtual void setInputStream(IntStream *input) override;
 
     virtual std::string getSourceName() override;
@@ -183,6 +192,14 @@ namespace antlr4 {
     /// <seealso cref= #notifyListeners </seealso>
     virtual size_t getNumberOfSyntaxErrors();
 
+    /// Lets the LexerATNSimulator handle rules whose only actions are {@code -> skip} or {@code -> channel(...)}
+    /// by itself: skipped input is passed over within the same match and channels are set directly, without
+    /// calling skip() or setChannel() and without returning to nextToken(). Off by default. Only turn it on if
+    /// this lexer does not override skip() or setChannel().
+    void setInlineSkipAndChannel(bool enable);
+
+    bool isInlineSkipAndChannel() const;
+
   protected:
     /// You can set the text for the current token to override what is in
     /// the input char buffer (via setText()).
@@ -190,6 +207,7 @@ namespace antlr4 {
 
   private:
     size_t _syntaxErrors;
+    bool _inlineSkipAndChannel;
     void InitializeInstanceFields();
   };
 
@@ -0,0 +1,152 @@
+/* Copyright (c) 2012-2017 The ANTLR Project. All rights reserved.
+ * Use of this file is governed by the BSD 3-clause license that
+ * can be found in the LICENSE.txt file in the project root.
+ */
+
+#include "CharStream.h"
+#include "CommonTokenFactory.h"
+#include "Token.h"
+#include "TokenFile.h"
+#include "misc/Interval.h"
+#include "support/StringUtils.h"
+
+#include "MappedTokenSource.h"
+
+using namespace antlr4;
+using namespace antlr4::misc;
+
+/// A token of the file, read from its record whenever it is asked for.
+class MappedTokenSource::MappedToken : public Token {
+public:
+  MappedToken(MappedTokenSource *source, size_t index) : _source(source), _index(index) {
+  }
+
+  virtual std::string getText() const override {
+    if (getType() == Token::EOF) {
+      return "<EOF>";
+    }
+    if (_source->_file.hasText()) {
+      return std::string(_source->_file.getText(_index));
+    }
+
+    CharStream *input = _source->_input;
+    size_t start = getStartIndex();
+    size_t stop = getStopIndex();
+    if (input == nullptr || start == INVALID_INDEX || stop == INVALID_INDEX) {
+      return "";
+    }
+    return input->getText(misc::Interval(start, stop));
+  }
+
+  virtual size_t getType() const override {
+    return _source->_file.getType(_index);
+  }
+
+  virtual size_t getLine() const override {
+    return _source->_file.getLine(_index);
+  }
+
+  virtual size_t getCharPositionInLine() const override {
+    return _source->_file.getCharPositionInLine(_index);
+  }
+
+  virtual size_t getChannel() const override {
+    return _source->_file.getChannel(_index);
+  }
+
+  virtual size_t getTokenIndex() const override {
+    return _index;
+  }
+
+  virtual size_t getStartIndex() const override {
+    return _source->_file.getStartIndex(_index);
+  }
+
+  virtual size_t getStopIndex() const override {
+    return _source->_file.getStopIndex(_index);
+  }
+
+  virtual TokenSource* getTokenSource() const override {
+    return _source;
+  }
+
+  virtual CharStream* getInputStream() const override {
+    return _source->_input;
+  }
+
+  virtual std::string toString() const override {
+    std::string channel;
+    if (getChannel() > 0) {
+      channel = ",channel=" + std::to_string(getChannel());
+    }
+    std::string text = getText();
+    if (!text.empty()) {
+      antlrcpp::replaceAll(text, "\n", "\\n");
+      antlrcpp::replaceAll(text, "\r", "\\r");
+      antlrcpp::replaceAll(text, "\t", "\\t");
+    } else {
+      text = "<no text>";
+    }
+
+    std::stringstream ss;
+    ss << "[@" << symbolToNumeric(_index) << "," << symbolToNumeric(getStartIndex()) << ":"
+      << symbolToNumeric(getStopIndex()) << "='" << text << "',<" << symbolToNumeric(getType()) << ">" << channel
+      << "," << getLine() << ":" << getCharPositionInLine() << "]";
+    return ss.str();
+  }
+
+private:
+  MappedTokenSource *const _source;
+  const size_t _index;
+};
+
+MappedTokenSource::MappedTokenSource(const TokenFile &file, CharStream *input) : _file(file), _input(input) {
+}
+
+std::unique_ptr<Token> MappedTokenSource::nextToken() {
+  std::unique_ptr<Token> token = std::make_unique<MappedToken>(this, _index);
+  if (_index + 1 < _file.size()) {
+    ++_index;
+  }
+  return token;
+}
+
+size_t MappedTokenSource::nextTokens(std::vector<std::unique_ptr<Token>> &tokens, size_t n) {
+  size_t count = 0;
+  while (count < n) {
+    bool eof = _file.getType(_index) == Token::EOF;
+    tokens.push_back(nextToken());
+    ++count;
+    if (eof) {
+      break;
+    }
+  }
+  return count;
+}
+
+size_t MappedTokenSource::getLine() const {
+  return _file.getLine(_index);
+}
+
+size_t MappedTokenSource::getCharPositionInLine() {
+  return _file.getCharPositionInLine(_index);
+}
+
+CharStream* MappedTokenSource::getInputStream() {
+  return _input;
+}
+
+std::string MappedTokenSource::getSourceName() {
+  std::string sourceName = _file.getSourceName();
+  if (!sourceName.empty()) {
+    return sourceName;
+  }
+  if (_input != nullptr) {
+    return _input->getSourceName();
+  }
+  return IntStream::UNKNOWN_SOURCE_NAME;
+}
+
+TokenFactory<CommonToken>* MappedTokenSource::getTokenFactory() {
+  return CommonTokenFactory::DEFAULT.get();
+}
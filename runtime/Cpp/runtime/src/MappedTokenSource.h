@@ -0,0 +1,50 @@
+/* Copyright (c) 2012-2017 The ANTLR Project. All rights reserved.
+ * Use of this file is governed by the BSD 3-clause license that
+ * can be found in the LICENSE.txt file in the project root.
+ */
+
+#pragma once
+
+#include "TokenSource.h"
+
+namespace antlr4 {
+
+  class TokenFile;
+
+  /// A token source reading the tokens of a TokenFile, e.g. to fill a CommonTokenStream with them instead of
+  /// lexing the input again. The tokens are views of their records in the mapped file: their data is not copied,
+  /// and their text only when it is asked for. They refer to the file and to this source, which must live as long
+  /// as the tokens are used.
+  class ANTLR4CPP_PUBLIC MappedTokenSource : public TokenSource {
+  public:
+    /// Reads the tokens of the given file. If the file has no text, the text of the tokens is taken from the given
+    /// input stream, which the tokens were lexed from; without it they have no text.
+    MappedTokenSource(const TokenFile &file, CharStream *input = nullptr);
+    MappedTokenSource(const MappedTokenSource &) = delete;
+
+    MappedTokenSource& operator = (const MappedTokenSource &) = delete;
+
+    /// Returns the next token of the file. After EOF, EOF is returned again.
+    virtual std::unique_ptr<Token> nextToken() override;
+    virtual size_t nextTokens(std::vector<std::unique_ptr<Token>> &tokens, size_t n) override;
+
+    virtual size_t getLine() const override;
+    virtual size_t getCharPositionInLine() override;
+    virtual CharStream* getInputStream() override;
+
+    /// The source name stored in the file, or that of the input stream if there is none.
+    virtual std::string getSourceName() override;
+
+    /// The factory for tokens conjured up by the parser while recovering from errors; the tokens of the file are
+    /// not created by a factory.
+    virtual TokenFactory<CommonToken>* getTokenFactory() override;
+
+  private:
+    class MappedToken;
+
+    const TokenFile &_file;
+    CharStream *const _input;
+    size_t _index = 0;
+  };
+
+} // namespace antlr4
@@ -0,0 +1,303 @@
+/* Copyright (c) 2012-2017 The ANTLR Project. All rights reserved.
+ * Use of this file is governed by the BSD 3-clause license that
+ * can be found in the LICENSE.txt file in the project root.
+ */
+
+#include "BaseErrorListener.h"
+#include "CharStream.h"
+#include "Exceptions.h"
+#include "Lexer.h"
+#include "ProxyErrorListener.h"
+#include "Token.h"
+#include "misc/Interval.h"
+#include "support/CPPUtils.h"
+
+#include "ParallelLexer.h"
+
+using namespace antlr4;
+
+namespace {
+
+  /// A stream of its own over the contiguous data of another stream, so several lexers can read the same input.
+  class SharedDataCharStream : public CharStream {
+  public:
+    SharedDataCharStream(CharStream *input, const char32_t *data, size_t size, size_t index)
+      : _input(input), _data(data), _size(size), _p(index) {
+    }
+
+    void consume() override {
+      if (_p >= _size) {
+        throw IllegalStateException("cannot consume EOF");
+      }
+      ++_p;
+    }
+
+    size_t LA(ssize_t i) override {
+      if (i == 0) {
+        return 0; // undefined
+      }
+
+      ssize_t position = static_cast<ssize_t>(_p) + (i < 0 ? i : i - 1);
+      if (position < 0 || position >= static_cast<ssize_t>(_size)) {
+        return EOF;
+      }
+      return _data[position];
+    }
+
+    ssize_t mark() override { return -1; }
+    void release(ssize_t /*marker*/) override {}
+    size_t index() override { return _p; }
+    void seek(size_t index) override { _p = std::min(index, _size); }
+    size_t size() override { return _size; }
+    std::string getSourceName() const override { return _input->getSourceName(); }
+    std::string getText(const misc::Interval &interval) override { return _input->getText(interval); }
+    std::string toString() const override { return _input->toString(); }
+
+    const char32_t *getContiguousData(size_t &size) override {
+      size = _size;
+      return _data;
+    }
+
+  private:
+    CharStream *_input;
+    const char32_t *_data;
+    size_t _size;
+    size_t _p;
+  };
+
+  /// The state of a lexer between two tokens.
+  struct LexerState {
+    size_t index;
+    size_t mode;
+    std::vector<size_t> modeStack;
+
+    explicit LexerState(Lexer &lexer)
+      : index(lexer.getInputStream()->index()), mode(lexer.mode), modeStack(lexer.modeStack) {
+    }
+
+    bool operator == (const LexerState &other) const {
+      return index == other.index && mode == other.mode && modeStack == other.modeStack;
+    }
+  };
+
+}
+
+/// Chunks after the first listen to the errors of their lexer, which speculates. An error is only reported to the
+/// listeners of the lexer once the token it occurred in is kept.
+struct ParallelLexer::Chunk : public BaseErrorListener {
+  struct SyntaxError {
+    size_t tokenIndex;
+    Token *offendingSymbol;
+    size_t line;
+    size_t charPositionInLine;
+    std::string msg;
+    std::exception_ptr e;
+  };
+
+  size_t start;
+  size_t end;
+  std::unique_ptr<CharStream> input;
+  std::unique_ptr<Lexer> lexer;
+
+  /// The tokens lexed from start on, and the state before each of them, followed by the state after the last.
+  std::vector<std::unique_ptr<Token>> tokens;
+  std::vector<LexerState> states;
+
+  std::exception_ptr error;
+
+  /// The listeners the lexer was created with, and the errors held back for them, by the index of their token.
+  ProxyErrorListener listeners;
+  std::vector<SyntaxError> errors;
+  bool speculating = false;
+
+  /// Holds back the errors of the lexer from now on.
+  void speculate() {
+    listeners = lexer->getErrorListenerDispatch();
+    lexer->removeErrorListeners();
+    lexer->addErrorListener(this);
+    speculating = true;
+  }
+
+  /// Reports the errors of the tokens from the given index on, and further errors right away.
+  void keep(size_t tokenIndex) {
+    if (!speculating) {
+      return;
+    }
+    speculating = false;
+    for (const SyntaxError &error : errors) {
+      if (error.tokenIndex >= tokenIndex) {
+        listeners.syntaxError(lexer.get(), error.offendingSymbol, error.line, error.charPositionInLine, error.msg,
+                              error.e);
+      }
+    }
+    errors.clear();
+  }
+
+  virtual void syntaxError(Recognizer *recognizer, Token *offendingSymbol, size_t line, size_t charPositionInLine,
+                           const std::string &msg, std::exception_ptr e) override {
+    if (speculating) {
+      errors.push_back({ tokens.size(), offendingSymbol, line, charPositionInLine, msg, e });
+    } else {
+      listeners.syntaxError(recognizer, offendingSymbol, line, charPositionInLine, msg, e);
+    }
+  }
+
+  /// Lexes up to the first token ending at or after end, or EOF.
+  void lex() {
+    try {
+      states.emplace_back(*lexer);
+      while (true) {
+        tokens.push_back(lexer->nextToken());
+        states.emplace_back(*lexer);
+        if (tokens.back()->getType() == Token::EOF || states.back().index >= end) {
+          break;
+        }
+      }
+    } catch (...) {
+      error = std::current_exception();
+    }
+  }
+};
+
+ParallelLexer::ParallelLexer(LexerFactory lexerFactory) : _lexerFactory(std::move(lexerFactory)) {
+  _splitPointPredicate = [](const char32_t *data, size_t /*size*/, size_t index) {
+    return index > 0 && data[index - 1] == U'\n';
+  };
+}
+
+ParallelLexer::~ParallelLexer() {
+}
+
+void ParallelLexer::setSplitPointPredicate(SplitPointPredicate splitPointPredicate) {
+  _splitPointPredicate = std::move(splitPointPredicate);
+}
+
+void ParallelLexer::setMinChunkSize(size_t minChunkSize) {
+  _minChunkSize = std::max<size_t>(minChunkSize, 1);
+}
+
+std::vector<std::unique_ptr<Token>> ParallelLexer::tokenize(CharStream *input, size_t threadCount) {
+  _chunks.clear();
+  _relexedChunks = 0;
+  threadCount = antlrcpp::getThreadCount(threadCount);
+
+  size_t size = 0;
+  const char32_t *data = input->getContiguousData(size);
+  if (data == nullptr) {
+    auto chunk = std::make_unique<Chunk>();
+    chunk->lexer = _lexerFactory(input);
+    std::vector<std::unique_ptr<Token>> tokens;
+    for (tokens.push_back(chunk->lexer->nextToken()); tokens.back()->getType() != Token::EOF;
+         tokens.push_back(chunk->lexer->nextToken())) {
+    }
+    _chunks.push_back(std::move(chunk));
+    return tokens;
+  }
+
+  // The first chunk starts where the input stream is. Those after it start with line and column of their start, as
+  // if lexed from there.
+  size_t position = input->index();
+  std::vector<size_t> splitPoints = findSplitPoints(data, size, position, threadCount);
+  size_t line = 1;
+  size_t charPositionInLine = 0;
+  for (size_t i = 0; i < splitPoints.size(); ++i) {
+    auto chunk = std::make_unique<Chunk>();
+    chunk->start = splitPoints[i];
+    chunk->end = i + 1 < splitPoints.size() ? splitPoints[i + 1] : size;
+    chunk->input = std::make_unique<SharedDataCharStream>(input, data, size, chunk->start);
+    chunk->lexer = _lexerFactory(chunk->input.get());
+
+    for (; position < chunk->start; ++position) {
+      if (data[position] == U'\n') {
+        ++line;
+        charPositionInLine = 0;
+      } else {
+        ++charPositionInLine;
+      }
+    }
+    if (i > 0) {
+      chunk->lexer->setLine(line);
+      chunk->lexer->setCharPositionInLine(charPositionInLine);
+      chunk->speculate();
+    }
+    _chunks.push_back(std::move(chunk));
+  }
+
+  antlrcpp::runConcurrently(_chunks.size(), _chunks.size(), [this](size_t i) {
+    _chunks[i]->lex();
+  });
+
+  // Errors of chunks which turn out to be needed are rethrown while stitching.
+  return stitch();
+}
+
+size_t ParallelLexer::getRelexedChunks() const {
+  return _relexedChunks;
+}
+
+std::vector<size_t> ParallelLexer::findSplitPoints(const char32_t *data, size_t size, size_t start,
+                                                  size_t threadCount) const {
+  std::vector<size_t> splitPoints = { start };
+  size_t chunkCount = std::min(threadCount, std::max<size_t>((size - start) / _minChunkSize, 1));
+  for (size_t i = 1; i < chunkCount; ++i) {
+    size_t index = std::max(start + (size - start) / chunkCount * i, splitPoints.back() + 1);
+    while (index < size && !_splitPointPredicate(data, size, index)) {
+      ++index;
+    }
+    if (index >= size) {
+      break;
+    }
+    splitPoints.push_back(index);
+  }
+  return splitPoints;
+}
+
+std::vector<std::unique_ptr<Token>> ParallelLexer::stitch() {
+  std::vector<std::unique_ptr<Token>> tokens;
+
+  // The chunk whose lexer is at the end of the tokens so far.
+  Chunk *current = _chunks[0].get();
+  if (current->error) {
+    std::rethrow_exception(current->error);
+  }
+  std::move(current->tokens.begin(), current->tokens.end(), std::back_inserter(tokens));
+  LexerState state = current->states.back();
+
+  for (size_t i = 1; i < _chunks.size() && tokens.back()->getType() != Token::EOF; ++i) {
+    Chunk *next = _chunks[i].get();
+    size_t nextState = 0;
+    while (true) {
+      while (nextState < next->states.size() && next->states[nextState].index < state.index) {
+        ++nextState;
+      }
+      if (nextState < next->states.size() && next->states[nextState] == state) {
+        if (next->error) {
+          std::rethrow_exception(next->error);
+        }
+        // In sync, the next chunk continues from here.
+        next->keep(nextState);
+        std::move(next->tokens.begin() + static_cast<ssize_t>(nextState), next->tokens.end(),
+                  std::back_inserter(tokens));
+        state = next->states.back();
+        current = next;
+        break;
+      }
+      if (nextState >= next->states.size()) {
+        ++_relexedChunks; // Passed the whole chunk without getting in sync. An error in it does not matter then.
+        break;
+      }
+
+      tokens.push_back(current->lexer->nextToken());
+      state = LexerState(*current->lexer);
+      if (tokens.back()->getType() == Token::EOF) {
+        break;
+      }
+    }
+  }
+
+  // Only if the last chunk was passed.
+  while (tokens.back()->getType() != Token::EOF) {
+    tokens.push_back(current->lexer->nextToken());
+  }
+  return tokens;
+}
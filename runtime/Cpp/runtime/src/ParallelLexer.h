@@ -0,0 +1,68 @@
+/* Copyright (c) 2012-2017 The ANTLR Project. All rights reserved.
+ * Use of this file is governed by the BSD 3-clause license that
+ * can be found in the LICENSE.txt file in the project root.
+ */
+
+#pragma once
+
+#include "antlr4-common.h"
+
+namespace antlr4 {
+
+  /// Tokenizes large inputs on several threads. The input is split into chunks at split points (by default the
+  /// start of a line), and each chunk is lexed by its own lexer on its own thread, speculating that a token starts
+  /// there in the default mode. Lexers of the same generated class share their DFA, so the threads also share
+  /// what they learn about the grammar.
+  ///
+  /// The chunks are then stitched together: where the lexer of a chunk ran past the end of the chunk, it is in a
+  /// state (position, mode and mode stack) which the lexer of the next chunk must have passed through as well,
+  /// if the speculation was right. From there on the tokens of the next chunk are taken. Otherwise, e.g. if the
+  /// split point was inside a string or comment, the lexer of the chunk before continues until it reaches such a
+  /// state, re-lexing as much of the next chunk as needed.
+  ///
+  /// This gives the same tokens as lexing the whole input with one lexer, provided the lexer's state between
+  /// tokens is described by its mode stack, i.e. lexer actions keep no state of their own. Inputs without
+  /// contiguous data (see CharStream::getContiguousData()) are lexed on the calling thread.
+  ///
+  /// The error listeners of the lexers after the first are only called for errors in tokens which are kept, on
+  /// the calling thread while stitching, so speculation reports no errors a single lexer would not.
+  class ANTLR4CPP_PUBLIC ParallelLexer {
+  public:
+    /// Creates a lexer reading from the given stream.
+    using LexerFactory = std::function<std::unique_ptr<Lexer>(CharStream *input)>;
+
+    /// Returns true if a token may start at the given index of the input.
+    using SplitPointPredicate = std::function<bool(const char32_t *data, size_t size, size_t index)>;
+
+    ParallelLexer(LexerFactory lexerFactory);
+    virtual ~ParallelLexer();
+
+    /// Sets the predicate to find split points with. The default accepts the start of a line.
+    void setSplitPointPredicate(SplitPointPredicate splitPointPredicate);
+
+    /// Sets the minimum number of code points per chunk, smaller inputs use fewer threads. The default is 64K.
+    void setMinChunkSize(size_t minChunkSize);
+
+    /// Returns the tokens of the input, ending with EOF. With a thread count of 0, as many threads as there are
+    /// hardware threads are used. The tokens refer to lexers and streams owned by this object, which must live
+    /// as long as the tokens are used, and until the next call.
+    std::vector<std::unique_ptr<Token>> tokenize(CharStream *input, size_t threadCount = 0);
+
+    /// The number of chunks whose speculation was wrong up to their end in the last call of tokenize(), so their
+    /// tokens were re-lexed entirely.
+    size_t getRelexedChunks() const;
+
+  private:
+    struct Chunk;
+
+    LexerFactory _lexerFactory;
+    SplitPointPredicate _splitPointPredicate;
+    size_t _minChunkSize = 64 * 1024;
+    std::vector<std::unique_ptr<Chunk>> _chunks;
+    size_t _relexedChunks = 0;
+
+    std::vector<size_t> findSplitPoints(const char32_t *data, size_t size, size_t start, size_t threadCount) const;
+    std::vector<std::unique_ptr<Token>> stitch();
+  };
+
+} // namespace antlr4
@@ -31,6 +31,80 @@ using namespace antlr4::atn;
 
 using namespace antlrcpp;
 
+/// What an incremental parse records about its contexts, and the state of reusing the tree of the previous parse.
+struct Parser::IncrementalState {
+  /// Where a context is in the token stream: its start relative to the start of its parent (for the root, the
+  /// start itself), so reused subtrees need no update, the number of tokens up to its stop token, and the number
+  /// of tokens from its start its parse looked at.
+  struct Span {
+    size_t offset;
+    size_t size;
+    size_t lookahead;
+    int precedence;
+    bool reusable;
+  };
+
+  /// A context of the reusable tree on the way to the cursor, with its start and the index of its next child.
+  struct Frame {
+    ParserRuleContext *context;
+    size_t start;
+    size_t child;
+  };
+
+  std::unordered_map<const ParserRuleContext *, Span> spans;
+
+  /// The number of syntax errors at the entry of each rule being parsed.
+  std::vector<size_t> syntaxErrors;
+
+  ParserRuleContext *reusableTree = nullptr;
+  size_t changeStart = 0;
+  size_t removed = 0;
+  size_t inserted = 0;
+  std::vector<Frame> cursor;
+  std::unordered_set<const ParserRuleContext *> reused;
+
+  /// Moves the cursor forward to the outermost context of the reusable tree starting at the given index of the
+  /// previous token stream. Returns false if there is none, the cursor is then before the next context.
+  bool seek(size_t index) {
+    while (!cursor.empty()) {
+      Frame &frame = cursor.back();
+      if (frame.start >= index) {
+        return frame.start == index;
+      }
+
+      auto span = spans.find(frame.context);
+      if (span != spans.end() && frame.start + span->second.size > index) {
+        ParserRuleContext *child = nextChild(frame);
+        if (child != nullptr) {
+          cursor.push_back({ child, frame.start + spans.at(child).offset, 0 });
+          continue;
+        }
+      }
+      cursor.pop_back();
+    }
+    return false;
+  }
+
+  /// The first child context of the given one, if it starts at the same token.
+  ParserRuleContext* firstChild(ParserRuleContext *context) {
+    Frame frame = { context, 0, 0 };
+    ParserRuleContext *child = nextChild(frame);
+    return child != nullptr && spans.at(child).offset == 0 ? child : nullptr;
+  }
+
+  /// The next child context of the frame with a span, if any.
+  ParserRuleContext* nextChild(Frame &frame) {
+    std::vector<tree::ParseTree *> &children = frame.context->children;
+    while (frame.child < children.size()) {
+      ParserRuleContext *child = dynamic_cast<ParserRuleContext *>(children[frame.child++]);
+      if (child != nullptr && spans.count(child) > 0) {
+        return child;
+      }
+    }
+    return nullptr;
+  }
+};
+
 std::map<std::vector<uint16_t>, atn::ATN> Parser::bypassAltsAtnCache;
 
 Parser::TraceListener::TraceListener(Parser *outerInstance_) : outerInstance(outerInstance_) {
@@ -98,6 +172,9 @@ void Parser::reset() {
   _precedenceStack.push_back(0);
   _ctx = nullptr;
   _tracker.reset();
+  if (_incremental != nullptr) {
+    _incremental = std::make_unique<IncrementalState>();
+  }
 
   atn::ATNSimulator *interpreter = getInterpreter<atn::ParserATNSimulator>();
   if (interpreter != nullptr) {
@@ -160,6 +237,49 @@ void Parser::setTrimParseTree(bool trimParseTrees) {
   }
 }
 
+void Parser::setIncremental(bool incremental) {
+  if (!incremental) {
+    _incremental.reset();
+  } else if (_incremental == nullptr) {
+    _incremental = std::make_unique<IncrementalState>();
+  }
+}
+
+bool Parser::isIncremental() const {
+  return _incremental != nullptr;
+}
+
+void Parser::setReusableTree(ParserRuleContext *tree, size_t changeStart, size_t removed, size_t inserted) {
+  if (_incremental == nullptr) {
+    throw IllegalStateException("Only the tree of an incremental parse can be reused.");
+  }
+  finishReuse();
+
+  if (getInputStream() != nullptr) {
+    getInputStream()->seek(0);
+  }
+  _errHandler->reset(this);
+  _matchedEOF = false;
+  _syntaxErrors = 0;
+  _precedenceStack.clear();
+  _precedenceStack.push_back(0);
+  _ctx = nullptr;
+  atn::ParserATNSimulator *interpreter = getInterpreter<atn::ParserATNSimulator>();
+  if (interpreter != nullptr) {
+    interpreter->setLookaheadEnd(0);
+  }
+
+  IncrementalState &state = *_incremental;
+  state.syntaxErrors.clear();
+  if (tree != nullptr && state.spans.count(tree) > 0) {
+    state.reusableTree = tree;
+    state.changeStart = changeStart;
+    state.removed = removed;
+    state.inserted = inserted;
+    state.cursor.push_back({ tree, state.spans.at(tree).offset, 0 });
+  }
+}
+
 bool Parser::getTrimParseTree() {
   return std::find(getParseListeners().begin(), getParseListeners().end(), &TrimToSizeListener::INSTANCE) != getParseListeners().end();
 }
@@ -332,7 +452,83 @@ void Parser::addContextToParseTree() {
   parent->addChild(_ctx);
 }
 
+ParserRuleContext* Parser::reuseContext(size_t ruleIndex, int precedence) {
+  // While recovering from an error, matching tokens ends the recovery, so they are not skipped.
+  if (_incremental == nullptr || _incremental->reusableTree == nullptr || _errHandler->inErrorRecoveryMode(this)) {
+    return nullptr;
+  }
+
+  // Map the token to the previous token stream. The new tokens have no contexts yet.
+  IncrementalState &state = *_incremental;
+  size_t index = _input->LT(1)->getTokenIndex();
+  size_t oldIndex = index;
+  if (index >= state.changeStart) {
+    if (index < state.changeStart + state.inserted) {
+      return nullptr;
+    }
+    oldIndex = index - state.inserted + state.removed;
+  }
+  if (!state.seek(oldIndex)) {
+    return nullptr;
+  }
+
+  // The candidates are the outermost context there and its first children starting at the same token.
+  ParserRuleContext *context = state.cursor.back().context;
+  while (context != nullptr) {
+    IncrementalState::Span &span = state.spans.at(context);
+    bool damaged = oldIndex < state.changeStart + state.removed && oldIndex + span.lookahead > state.changeStart;
+    if (!damaged && span.reusable && context->getRuleIndex() == ruleIndex && span.precedence == precedence &&
+        context->invokingState == getState()) {
+      // The same call stack, as full context predictions may have looked beyond the rule.
+      RuleContext *oldParent = dynamic_cast<RuleContext *>(context->parent);
+      RuleContext *parent = _ctx;
+      while (oldParent != nullptr && parent != nullptr && oldParent->invokingState == parent->invokingState &&
+             oldParent->getRuleIndex() == parent->getRuleIndex()) {
+        oldParent = dynamic_cast<RuleContext *>(oldParent->parent);
+        parent = dynamic_cast<RuleContext *>(parent->parent);
+      }
+      if (oldParent == nullptr && parent == nullptr) {
+        break;
+      }
+    }
+    context = state.firstChild(context);
+  }
+  if (context == nullptr) {
+    return nullptr;
+  }
+
+  IncrementalState::Span &span = state.spans.at(context);
+  state.reused.insert(context);
+  context->parent = _ctx;
+  span.offset = _ctx == nullptr ? index : index - _ctx->start->getTokenIndex();
+  if (_buildParseTrees && _ctx != nullptr) {
+    _ctx->addChild(context);
+  }
+
+  if (span.size > 0) {
+    if (context->stop->getType() == Token::EOF) {
+      _matchedEOF = true;
+      _input->seek(context->stop->getTokenIndex());
+    } else {
+      _input->seek(context->stop->getTokenIndex() + 1);
+    }
+  }
+  atn::ParserATNSimulator *interpreter = getInterpreter<atn::ParserATNSimulator>();
+  interpreter->setLookaheadEnd(std::max(interpreter->getLookaheadEnd(), index + span.lookahead));
+
+  if (_ctx == nullptr) {
+    finishReuse();
+  }
+  return context;
+}
+
 void Parser::enterRule(ParserRuleContext *localctx, size_t state, size_t /*ruleIndex*/) {
+  if (_incremental != nullptr) {
+    if (_ctx == nullptr) {
+      getInterpreter<atn::ParserATNSimulator>()->setLookaheadEnd(0);
+    }
+    _incremental->syntaxErrors.push_back(_syntaxErrors);
+  }
   setState(state);
   _ctx = localctx;
   _ctx->start = _input->LT(1);
@@ -356,8 +552,14 @@ void Parser::exitRule() {
   if (_parseListeners.size() > 0) {
     triggerExitRuleEvent();
   }
+  if (_incremental != nullptr) {
+    recordContext(_ctx, 0);
+  }
   setState(_ctx->invokingState);
   _ctx = dynamic_cast<ParserRuleContext *>(_ctx->parent);
+  if (_ctx == nullptr && _incremental != nullptr) {
+    finishReuse();
+  }
 }
 
 void Parser::enterOuterAlt(ParserRuleContext *localctx, size_t altNum) {
@@ -388,6 +590,12 @@ void Parser::enterRecursionRule(ParserRuleContext *localctx, size_t ruleIndex) {
 }
 
 void Parser::enterRecursionRule(ParserRuleContext *localctx, size_t state, size_t /*ruleIndex*/, int precedence) {
+  if (_incremental != nullptr) {
+    if (_ctx == nullptr) {
+      getInterpreter<atn::ParserATNSimulator>()->setLookaheadEnd(0);
+    }
+    _incremental->syntaxErrors.push_back(_syntaxErrors);
+  }
   setState(state);
   _precedenceStack.push_back(precedence);
   _ctx = localctx;
@@ -405,6 +613,13 @@ void Parser::pushNewRecursionContext(ParserRuleContext *localctx, size_t state,
 
   _ctx = localctx;
   _ctx->start = previous->start;
+  if (_incremental != nullptr) {
+    // Recorded like an exited rule, but not reusable on its own: it was not parsed from its invoking state.
+    _incremental->syntaxErrors.push_back(_syntaxErrors);
+    recordContext(previous, 0);
+    _incremental->spans.at(previous).reusable = false;
+  }
+
   if (_buildParseTrees) {
     _ctx->addChild(previous);
   }
@@ -415,6 +630,7 @@ void Parser::pushNewRecursionContext(ParserRuleContext *localctx, size_t state,
 }
 
 void Parser::unrollRecursionContexts(ParserRuleContext *parentctx) {
+  int precedence = _precedenceStack.back();
   _precedenceStack.pop_back();
   _ctx->stop = _input->LT(-1);
   ParserRuleContext *retctx = _ctx; // save current ctx (return value)
@@ -436,6 +652,13 @@ void Parser::unrollRecursionContexts(ParserRuleContext *parentctx) {
     // add return ctx into invoking rule's tree
     parentctx->addChild(retctx);
   }
+
+  if (_incremental != nullptr) {
+    recordContext(retctx, precedence);
+    if (parentctx == nullptr) {
+      finishReuse();
+    }
+  }
 }
 
 ParserRuleContext* Parser::getInvokingContext(size_t ruleIndex) {
@@ -634,6 +857,56 @@ tree::ErrorNode *Parser::createErrorNode(Token *t) {
   return _tracker.createInstance<tree::ErrorNodeImpl>(t);
 }
 
+void Parser::recordContext(ParserRuleContext *context, int precedence) {
+  // Rules entered before incremental parsing was enabled are not reusable.
+  bool reusable = false;
+  if (!_incremental->syntaxErrors.empty()) {
+    reusable = _incremental->syntaxErrors.back() == _syntaxErrors && context->exception == nullptr;
+    _incremental->syntaxErrors.pop_back();
+  }
+
+  size_t start = context->start->getTokenIndex();
+  size_t end = context->stop == nullptr ? start : std::max(start, context->stop->getTokenIndex() + 1);
+  size_t lookaheadEnd = std::max({ getInterpreter<atn::ParserATNSimulator>()->getLookaheadEnd(), _input->index() + 1,
+    end });
+  ParserRuleContext *parent = dynamic_cast<ParserRuleContext *>(context->parent);
+  size_t offset = parent == nullptr ? start : start - parent->start->getTokenIndex();
+  _incremental->spans[context] = { offset, end - start, lookaheadEnd - start, precedence, reusable };
+}
+
+void Parser::finishReuse() {
+  IncrementalState &state = *_incremental;
+  if (state.reusableTree == nullptr) {
+    return;
+  }
+
+  // Release what was not reused of the previous tree.
+  std::vector<tree::ParseTree *> unused;
+  std::vector<ParserRuleContext *> pending;
+  if (state.reused.count(state.reusableTree) == 0) {
+    pending.push_back(state.reusableTree);
+  }
+  while (!pending.empty()) {
+    ParserRuleContext *context = pending.back();
+    pending.pop_back();
+    unused.push_back(context);
+    state.spans.erase(context);
+    for (tree::ParseTree *child : context->children) {
+      ParserRuleContext *childContext = dynamic_cast<ParserRuleContext *>(child);
+      if (childContext == nullptr) {
+        unused.push_back(child);
+      } else if (state.reused.count(childContext) == 0) {
+        pending.push_back(childContext);
+      }
+    }
+  }
+  _tracker.release(unused);
+
+  state.reusableTree = nullptr;
+  state.cursor.clear();
+  state.reused.clear();
+}
+
 void Parser::InitializeInstanceFields() {
   _errHandler = std::make_shared<DefaultErrorStrategy>();
   _precedenceStack.clear();
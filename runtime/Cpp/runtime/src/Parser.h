@@ -47,7 +47,7 @@ namespace antlr4 {
     Parser(TokenStream *input);
     virtual ~Parser();
 
-    /// reset the parser's state
+    /// reset the parser's state. The parse trees are deleted; their memory is kept for the trees of the next parse.
     virtual void reset();
 
     /// <summary>
@@ -125,6 +125,25 @@ namespace antlr4 {
     /// using the default <seealso cref="Parser.TrimToSizeListener"/> during the parse process. </returns>
     virtual bool getTrimParseTree();
 
+    /// Records while parsing what is needed to reuse the contexts of the parse tree in a later incremental parse
+    /// (see setReusableTree()). This property is {@code false} by default.
+    virtual void setIncremental(bool incremental);
+    virtual bool isIncremental() const;
+
+    /// Makes the next parse reuse the unchanged subtrees of the tree of the previous parse, instead of parsing
+    /// their tokens again. The previous parse must have been an incremental one (see setIncremental()) by this
+    /// parser, of the same token stream, in which the tokens from changeStart on, removed of them, were since
+    /// replaced by inserted new ones (see IncrementalLexer::Change). The parser is reset for the next parse, but
+    /// the previous tree is kept.
+    ///
+    /// A context of the previous tree is reused where the parser is about to parse its rule from the same token,
+    /// called from the same states with the same precedence, if neither its tokens nor the tokens its parse
+    /// looked ahead at changed and it had no syntax errors. It is added to the tree as it is and its tokens are
+    /// skipped, without parse listener events or actions. Rules with arguments are always parsed, and predicates
+    /// and actions must only depend on the tokens of their context. The parts of the previous tree which were
+    /// not reused are deleted after the parse.
+    virtual void setReusableTree(ParserRuleContext *tree, size_t changeStart, size_t removed, size_t inserted);
+
     virtual std::vector<tree::ParseTreeListener *> getParseListeners();
 
     /// <summary>
@@ -272,6 +291,11 @@ namespace antlr4 {
     /// <seealso cref="#_ctx"/> get the current context.
     virtual void enterRule(ParserRuleContext *localctx, size_t state, size_t ruleIndex);
 
+    /// Called by rule functions before they create their context. Returns a context of the reusable tree (see
+    /// setReusableTree()) for the rule at the current state and token, which is added to the tree and whose tokens
+    /// are skipped. Returns null if there is none, then the rule is parsed.
+    ParserRuleContext* reuseContext(size_t ruleIndex, int precedence = 0);
+
     void exitRule();
 
     virtual void enterOuterAlt(ParserRuleContext *localctx, size_t altNum);
@@ -461,6 +485,14 @@ namespace antlr4 {
     /// other parser methods.
     TraceListener *_tracer;
 
+    struct IncrementalState;
+
+    /// Set if parsing incrementally.
+    std::unique_ptr<IncrementalState> _incremental;
+
+    void recordContext(ParserRuleContext *context, int precedence);
+    void finishReuse();
+
     void InitializeInstanceFields();
   };
 
@@ -187,9 +187,15 @@ void ParserInterpreter::visitState(atn::ATNState *p) {
     {
       atn::RuleStartState *ruleStartState = static_cast<atn::RuleStartState*>(transition->target);
       size_t ruleIndex = ruleStartState->ruleIndex;
+      int precedence = ruleStartState->isLeftRecursiveRule ? static_cast<atn::RuleTransition*>(transition)->precedence : 0;
+      if (reuseContext(ruleIndex, precedence) != nullptr) {
+        // As if the rule was parsed and returned.
+        setState(static_cast<atn::RuleTransition*>(transition)->followState->stateNumber);
+        return;
+      }
       InterpreterRuleContext *newctx = createInterpreterRuleContext(_ctx, p->stateNumber, ruleIndex);
       if (ruleStartState->isLeftRecursiveRule) {
-        enterRecursionRule(newctx, ruleStartState->stateNumber, ruleIndex, static_cast<atn::RuleTransition*>(transition)->precedence);
+        enterRecursionRule(newctx, ruleStartState->stateNumber, ruleIndex, precedence);
       } else {
         enterRule(newctx, transition->target->stateNumber, ruleIndex);
       }
@@ -0,0 +1,169 @@
+/* Copyright (c) 2012-2017 The ANTLR Project. All rights reserved.
+ * Use of this file is governed by the BSD 3-clause license that
+ * can be found in the LICENSE.txt file in the project root.
+ */
+
+#include "Token.h"
+#include "TokenSource.h"
+#include "WritableToken.h"
+
+#include "PipelinedTokenStream.h"
+
+#include <thread>
+
+using namespace antlr4;
+
+namespace {
+
+  struct Batch {
+    std::vector<std::unique_ptr<Token>> tokens;
+    std::exception_ptr error;
+  };
+
+  /// Waits for the other thread, yielding first and sleeping briefly once that took long, so a waiting producer
+  /// does not keep a core busy while the parser is behind.
+  class Backoff {
+  public:
+    void wait() {
+      if (_rounds < 64) {
+        ++_rounds;
+        std::this_thread::yield();
+      } else {
+        std::this_thread::sleep_for(std::chrono::microseconds(50));
+      }
+    }
+
+  private:
+    size_t _rounds = 0;
+  };
+
+}
+
+/// The producer thread and the ring of batches it fills. The producer only writes _tail and the slots from there
+/// on, the consumer only _head and the slots before _tail.
+class PipelinedTokenStream::Pipeline {
+public:
+  Pipeline(TokenSource *tokenSource, size_t batchSize, size_t capacity) : _tokenSource(tokenSource),
+    _batchSize(batchSize) {
+    size_t size = 1;
+    while (size < capacity) {
+      size <<= 1;
+    }
+    _slots.resize(size);
+    _thread = std::thread(&Pipeline::produce, this);
+  }
+
+  ~Pipeline() {
+    _stopped.store(true, std::memory_order_relaxed);
+    _thread.join();
+  }
+
+  /// Waits for the next batch. Once the token source failed, its exception is thrown for every call.
+  Batch take() {
+    if (_error) {
+      std::rethrow_exception(_error);
+    }
+
+    size_t head = _head.load(std::memory_order_relaxed);
+    Backoff backoff;
+    while (head == _tail.load(std::memory_order_acquire)) {
+      backoff.wait();
+    }
+    Batch batch = std::move(_slots[head & (_slots.size() - 1)]);
+    _head.store(head + 1, std::memory_order_release);
+    _error = batch.error;
+    return batch;
+  }
+
+private:
+  TokenSource *_tokenSource;
+  size_t _batchSize;
+  std::vector<Batch> _slots;
+
+  // On cache lines of their own, as each is written by one thread and read by the other.
+  alignas(64) std::atomic<size_t> _head { 0 };
+  alignas(64) std::atomic<size_t> _tail { 0 };
+
+  std::atomic<bool> _stopped { false };
+  std::exception_ptr _error;
+  std::thread _thread;
+
+  void produce() {
+    size_t tail = _tail.load(std::memory_order_relaxed);
+    bool done = false;
+    while (!done) {
+      Batch batch;
+      batch.tokens.reserve(_batchSize);
+      try {
+        _tokenSource->nextTokens(batch.tokens, _batchSize);
+        done = !batch.tokens.empty() && batch.tokens.back()->getType() == Token::EOF;
+      } catch (...) {
+        batch.error = std::current_exception();
+        done = true;
+      }
+
+      Backoff backoff;
+      while (tail - _head.load(std::memory_order_acquire) == _slots.size()) {
+        if (_stopped.load(std::memory_order_relaxed)) {
+          return;
+        }
+        backoff.wait();
+      }
+      _slots[tail & (_slots.size() - 1)] = std::move(batch);
+      _tail.store(++tail, std::memory_order_release);
+
+      if (_stopped.load(std::memory_order_relaxed)) {
+        return;
+      }
+    }
+  }
+};
+
+PipelinedTokenStream::PipelinedTokenStream(TokenSource *tokenSource) : CommonTokenStream(tokenSource) {
+}
+
+PipelinedTokenStream::PipelinedTokenStream(TokenSource *tokenSource, size_t channel)
+: CommonTokenStream(tokenSource, channel) {
+}
+
+PipelinedTokenStream::~PipelinedTokenStream() {
+}
+
+void PipelinedTokenStream::setBatchSize(size_t batchSize) {
+  _batchSize = std::max<size_t>(batchSize, 1);
+}
+
+void PipelinedTokenStream::setCapacity(size_t capacity) {
+  _capacity = std::max<size_t>(capacity, 1);
+}
+
+void PipelinedTokenStream::setTokenSource(TokenSource *tokenSource) {
+  _pipeline.reset();
+  CommonTokenStream::setTokenSource(tokenSource);
+}
+
+size_t PipelinedTokenStream::fetch(size_t n) {
+  if (_fetchedEOF) {
+    return 0;
+  }
+  if (_pipeline == nullptr) {
+    _pipeline = std::make_unique<Pipeline>(_tokenSource, _batchSize, _capacity);
+  }
+
+  // Whole batches are taken, so there may be more tokens than asked for.
+  size_t start = _tokens.size();
+  while (_tokens.size() - start < n && !_fetchedEOF) {
+    Batch batch = _pipeline->take();
+    for (auto &token : batch.tokens) {
+      if (WritableToken *writable = dynamic_cast<WritableToken *>(token.get())) {
+        writable->setTokenIndex(_tokens.size());
+      }
+      _fetchedEOF = token->getType() == Token::EOF;
+      _tokens.push_back(std::move(token));
+    }
+    if (batch.error) {
+      std::rethrow_exception(batch.error);
+    }
+  }
+  return _tokens.size() - start;
+}
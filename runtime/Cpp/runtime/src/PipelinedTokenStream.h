@@ -0,0 +1,48 @@
+/* Copyright (c) 2012-2017 The ANTLR Project. All rights reserved.
+ * Use of this file is governed by the BSD 3-clause license that
+ * can be found in the LICENSE.txt file in the project root.
+ */
+
+#pragma once
+
+#include "CommonTokenStream.h"
+
+namespace antlr4 {
+
+  /// A CommonTokenStream whose token source runs on a thread of its own, so a document is lexed while it is
+  /// parsed. The producer thread calls TokenSource::nextTokens() for batches of tokens and passes them on through a
+  /// lock-free single-producer/single-consumer ring, which the stream takes them from when it needs more tokens.
+  /// Once the ring is full the producer waits for the parser to catch up.
+  ///
+  /// All tokens taken from the ring are kept, like in any BufferedTokenStream, so lookahead, seek() and the
+  /// token accessors work as usual. The producer starts with the first token needed, and the token source must
+  /// not be used by other code from then on until the stream is destroyed or its token source is changed: the
+  /// lexer, its input stream and its error listeners are called on the producer thread. An exception thrown by
+  /// the token source is rethrown by the stream when it reaches the tokens after it.
+  class ANTLR4CPP_PUBLIC PipelinedTokenStream : public CommonTokenStream {
+  public:
+    PipelinedTokenStream(TokenSource *tokenSource);
+    PipelinedTokenStream(TokenSource *tokenSource, size_t channel);
+    virtual ~PipelinedTokenStream();
+
+    /// Sets the number of tokens passed on at a time, 256 by default. Takes effect when the producer starts.
+    void setBatchSize(size_t batchSize);
+
+    /// Sets the number of batches the ring holds, 64 by default. Takes effect when the producer starts.
+    void setCapacity(size_t capacity);
+
+    /// Stops the producer thread of the current token source before switching.
+    virtual void setTokenSource(TokenSource *tokenSource) override;
+
+  protected:
+    virtual size_t fetch(size_t n) override;
+
+  private:
+    class Pipeline;
+
+    size_t _batchSize = 256;
+    size_t _capacity = 64;
+    std::unique_ptr<Pipeline> _pipeline;
+  };
+
+} // namespace antlr4
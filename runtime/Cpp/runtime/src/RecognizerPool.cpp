@@ -0,0 +1,111 @@
+/* Copyright (c) 2012-2017 The ANTLR Project. All rights reserved.
+ * Use of this file is governed by the BSD 3-clause license that
+ * can be found in the LICENSE.txt file in the project root.
+ */
+
+#include "CommonTokenStream.h"
+#include "Lexer.h"
+#include "Parser.h"
+
+#include "RecognizerPool.h"
+
+using namespace antlr4;
+
+struct RecognizerPool::Recognizers {
+  std::unique_ptr<Lexer> lexer;
+  std::unique_ptr<CommonTokenStream> tokens;
+  std::unique_ptr<Parser> parser;
+};
+
+RecognizerPool::Lease::Lease(RecognizerPool *pool, std::unique_ptr<Recognizers> recognizers)
+  : _pool(pool), _recognizers(std::move(recognizers)) {
+}
+
+RecognizerPool::Lease::Lease(Lease &&other) noexcept
+  : _pool(other._pool), _recognizers(std::move(other._recognizers)) {
+}
+
+RecognizerPool::Lease::~Lease() {
+  if (_recognizers != nullptr) {
+    _pool->release(std::move(_recognizers));
+  }
+}
+
+RecognizerPool::Lease& RecognizerPool::Lease::operator = (Lease &&other) noexcept {
+  if (this != &other) {
+    if (_recognizers != nullptr) {
+      _pool->release(std::move(_recognizers));
+    }
+    _pool = other._pool;
+    _recognizers = std::move(other._recognizers);
+  }
+  return *this;
+}
+
+void RecognizerPool::Lease::setInputStream(CharStream *input) {
+  bind(*_recognizers, input);
+}
+
+Lexer* RecognizerPool::Lease::getLexer() const {
+  return _recognizers->lexer.get();
+}
+
+CommonTokenStream* RecognizerPool::Lease::getTokenStream() const {
+  return _recognizers->tokens.get();
+}
+
+Parser* RecognizerPool::Lease::getParser() const {
+  return _recognizers->parser.get();
+}
+
+RecognizerPool::RecognizerPool(LexerFactory lexerFactory, ParserFactory parserFactory)
+  : _lexerFactory(std::move(lexerFactory)), _parserFactory(std::move(parserFactory)) {
+}
+
+RecognizerPool::~RecognizerPool() {
+}
+
+RecognizerPool::Lease RecognizerPool::acquire(CharStream *input) {
+  std::unique_ptr<Recognizers> recognizers;
+  {
+    std::lock_guard<std::mutex> lock(_mutex);
+    if (!_idle.empty()) {
+      recognizers = std::move(_idle.back());
+      _idle.pop_back();
+    }
+  }
+
+  if (recognizers == nullptr) {
+    recognizers = std::make_unique<Recognizers>();
+    recognizers->lexer = _lexerFactory(input);
+    recognizers->tokens = std::make_unique<CommonTokenStream>(recognizers->lexer.get());
+    recognizers->parser = _parserFactory(recognizers->tokens.get());
+    recognizers->parser->getTreeTracker().setRetainMemory(true);
+    std::lock_guard<std::mutex> lock(_mutex);
+    ++_size;
+  } else {
+    bind(*recognizers, input);
+  }
+  return Lease(this, std::move(recognizers));
+}
+
+size_t RecognizerPool::size() const {
+  std::lock_guard<std::mutex> lock(_mutex);
+  return _size;
+}
+
+void RecognizerPool::release(std::unique_ptr<Recognizers> recognizers) {
+  // Let go of the input, tokens and trees now: the input may be gone before the recognizers are used again.
+  recognizers->parser->setTokenStream(nullptr);
+  recognizers->tokens->setTokenSource(recognizers->lexer.get());
+  recognizers->lexer->setInputStream(nullptr);
+
+  std::lock_guard<std::mutex> lock(_mutex);
+  _idle.push_back(std::move(recognizers));
+}
+
+void RecognizerPool::bind(Recognizers &recognizers, CharStream *input) {
+  recognizers.lexer->setInputStream(input);
+  recognizers.tokens->setTokenSource(recognizers.lexer.get());
+  recognizers.parser->setTokenStream(recognizers.tokens.get());
+}
@@ -0,0 +1,92 @@
+/* Copyright (c) 2012-2017 The ANTLR Project. All rights reserved.
+ * Use of this file is governed by the BSD 3-clause license that
+ * can be found in the LICENSE.txt file in the project root.
+ */
+
+#pragma once
+
+#include "antlr4-common.h"
+
+namespace antlr4 {
+
+  /// A pool of lexers, token streams and parsers for parsing many small inputs, e.g. one per request of a server.
+  /// Creating the recognizers (with their simulators, error strategies and listeners) may take longer than
+  /// parsing a small input. Instead, acquire() hands out an idle set of them, reset for the new input, and creates
+  /// one only if none is idle. Resetting keeps the memory of their buffers: the token vector of the token stream,
+  /// the parse tree memory of the parser (see tree::ParseTreeTracker::setRetainMemory()), its precedence stack and the merge cache of
+  /// its simulator.
+  ///
+  /// Recognizers are configured once, when they are created by the factories, e.g. with error listeners or an
+  /// error strategy. Settings made after acquire() stay with the recognizers for their next uses.
+  ///
+  /// The pool may be used by several threads at once; each set of recognizers is used by one thread at a time.
+  class ANTLR4CPP_PUBLIC RecognizerPool {
+  public:
+    /// Creates a lexer reading from the given stream.
+    using LexerFactory = std::function<std::unique_ptr<Lexer>(CharStream *input)>;
+
+    /// Creates a parser reading from the given token stream.
+    using ParserFactory = std::function<std::unique_ptr<Parser>(TokenStream *input)>;
+
+  private:
+    struct Recognizers;
+
+  public:
+    /// A set of recognizers acquired from the pool, which it returns to the pool when destroyed. The parse trees
+    /// and tokens are deleted then, so they must not be used any more.
+    class ANTLR4CPP_PUBLIC Lease {
+    public:
+      Lease(Lease &&other) noexcept;
+      ~Lease();
+
+      Lease& operator = (Lease &&other) noexcept;
+
+      /// Resets the recognizers for another input, without returning them to the pool in between.
+      void setInputStream(CharStream *input);
+
+      Lexer* getLexer() const;
+      CommonTokenStream* getTokenStream() const;
+      Parser* getParser() const;
+
+      /// The parser as the generated class the parser factory creates.
+      template<typename T>
+      T* getParser() const {
+        return static_cast<T *>(getParser());
+      }
+
+    private:
+      friend class RecognizerPool;
+
+      RecognizerPool *_pool;
+      std::unique_ptr<Recognizers> _recognizers;
+
+      Lease(RecognizerPool *pool, std::unique_ptr<Recognizers> recognizers);
+    };
+
+    RecognizerPool(LexerFactory lexerFactory, ParserFactory parserFactory);
+    RecognizerPool(const RecognizerPool &) = delete;
+    ~RecognizerPool();
+
+    RecognizerPool& operator = (const RecognizerPool &) = delete;
+
+    /// Returns recognizers reading from the given input, which must live as long as they are used. The pool must
+    /// outlive the lease.
+    Lease acquire(CharStream *input);
+
+    /// The number of sets of recognizers created so far, i.e. the most that were in use at once.
+    size_t size() const;
+
+  private:
+    LexerFactory _lexerFactory;
+    ParserFactory _parserFactory;
+
+    mutable std::mutex _mutex;
+    std::vector<std::unique_ptr<Recognizers>> _idle;
+    size_t _size = 0;
+
+    void release(std::unique_ptr<Recognizers> recognizers);
+
+    static void bind(Recognizers &recognizers, CharStream *input);
+  };
+
+} // namespace antlr4
@@ -0,0 +1,275 @@
+/* Copyright (c) 2012-2017 The ANTLR Project. All rights reserved.
+ * Use of this file is governed by the BSD 3-clause license that
+ * can be found in the LICENSE.txt file in the project root.
+ */
+
+#include "Exceptions.h"
+#include "Token.h"
+#include "support/StringUtils.h"
+
+#include "TokenFile.h"
+
+#include <cstring>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+using namespace antlr4;
+
+struct TokenFile::Record {
+  uint32_t type;
+  uint32_t channel;
+  uint32_t start;
+  uint32_t stop;
+  uint32_t line;
+  uint32_t charPositionInLine;
+  uint32_t textOffset;
+  uint32_t textLength;
+};
+
+namespace {
+
+  constexpr char MAGIC[8] = { 'A', 'N', 'T', 'L', 'R', 'T', 'O', 'K' };
+  constexpr uint32_t BYTE_ORDER_MARK = 0x01020304;
+  constexpr uint32_t VERSION = 1;
+  constexpr uint32_t HAS_TEXT = 1;
+
+  struct Header {
+    char magic[8];
+    uint32_t byteOrder;
+    uint32_t version;
+    uint32_t flags;
+    uint32_t reserved;
+    uint64_t tokenCount;
+    uint64_t sourceNameSize;
+    uint64_t textPoolSize;
+  };
+
+  /// INVALID_INDEX (and EOF) is stored as the largest 32 bit number.
+  uint32_t narrow(size_t value) {
+    if (value == INVALID_INDEX) {
+      return std::numeric_limits<uint32_t>::max();
+    }
+    if (value >= std::numeric_limits<uint32_t>::max()) {
+      throw IllegalArgumentException("value " + std::to_string(value) + " does not fit into a token file");
+    }
+    return static_cast<uint32_t>(value);
+  }
+
+  size_t widen(uint32_t value) {
+    return value == std::numeric_limits<uint32_t>::max() ? INVALID_INDEX : value;
+  }
+
+}
+
+TokenFile::TokenFile(const std::string &fileName) {
+#ifdef _WIN32
+  // Without mmap, the file is read at once.
+#ifdef _MSC_VER
+  std::ifstream stream(antlrcpp::s2ws(fileName), std::ios::binary);
+#else
+  std::ifstream stream(fileName, std::ios::binary);
+#endif
+  if (!stream) {
+    throw IOException("cannot open token file " + fileName);
+  }
+  _buffer.assign(std::istreambuf_iterator<char>(stream), std::istreambuf_iterator<char>());
+  _data = _buffer.data();
+  _size = _buffer.size();
+#else
+  int fd = ::open(fileName.c_str(), O_RDONLY);
+  if (fd < 0) {
+    throw IOException("cannot open token file " + fileName);
+  }
+  struct stat status;
+  if (::fstat(fd, &status) != 0) {
+    ::close(fd);
+    throw IOException("cannot read token file " + fileName);
+  }
+  _size = static_cast<size_t>(status.st_size);
+  if (_size > 0) {
+    void *data = ::mmap(nullptr, _size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (data == MAP_FAILED) {
+      ::close(fd);
+      throw IOException("cannot map token file " + fileName);
+    }
+    _data = static_cast<const char *>(data);
+  }
+  ::close(fd);
+#endif
+
+  Header header;
+  if (_size < sizeof(Header)) {
+    unmap();
+    throw IllegalArgumentException(fileName + " is not a token file");
+  }
+  std::memcpy(&header, _data, sizeof(Header));
+
+  std::string error;
+  if (std::memcmp(header.magic, MAGIC, sizeof(MAGIC)) != 0) {
+    error = fileName + " is not a token file";
+  } else if (header.byteOrder != BYTE_ORDER_MARK) {
+    error = "token file " + fileName + " was written with another byte order";
+  } else if (header.version != VERSION) {
+    error = "token file " + fileName + " has unsupported version " + std::to_string(header.version);
+  } else if (header.tokenCount == 0 || header.tokenCount > (_size - sizeof(Header)) / sizeof(Record) ||
+             header.sourceNameSize > _size - sizeof(Header) - header.tokenCount * sizeof(Record) ||
+             header.textPoolSize != _size - sizeof(Header) - header.tokenCount * sizeof(Record) -
+                                    header.sourceNameSize) {
+    error = "token file " + fileName + " is truncated or corrupt";
+  }
+  if (!error.empty()) {
+    unmap();
+    throw IllegalArgumentException(error);
+  }
+
+  _tokenCount = static_cast<size_t>(header.tokenCount);
+  _records = reinterpret_cast<const Record *>(_data + sizeof(Header));
+  const char *names = _data + sizeof(Header) + _tokenCount * sizeof(Record);
+  _sourceName = std::string_view(names, static_cast<size_t>(header.sourceNameSize));
+  _textPool = std::string_view(names + header.sourceNameSize, static_cast<size_t>(header.textPoolSize));
+  _hasText = (header.flags & HAS_TEXT) != 0;
+}
+
+TokenFile::~TokenFile() {
+  unmap();
+}
+
+void TokenFile::write(std::ostream &output, const std::vector<Token *> &tokens, const std::string &sourceName,
+                      bool withText) {
+  std::vector<Record> records;
+  records.reserve(tokens.size() + 1);
+  std::string textPool;
+  std::unordered_map<std::string, uint32_t> textOffsets;
+
+  for (Token *token : tokens) {
+    Record record = { narrow(token->getType()), narrow(token->getChannel()), narrow(token->getStartIndex()),
+      narrow(token->getStopIndex()), narrow(token->getLine()), narrow(token->getCharPositionInLine()), 0, 0 };
+    if (withText && token->getType() != Token::EOF) {
+      std::string text = token->getText();
+      auto offset = textOffsets.emplace(text, narrow(textPool.size()));
+      if (offset.second) {
+        textPool += text;
+      }
+      record.textOffset = offset.first->second;
+      record.textLength = narrow(text.size());
+    }
+    records.push_back(record);
+  }
+
+  if (tokens.empty() || tokens.back()->getType() != Token::EOF) {
+    // An EOF token after the last one, as ListTokenSource adds.
+    size_t start = INVALID_INDEX;
+    size_t line = 1;
+    size_t charPositionInLine = 0;
+    if (!tokens.empty()) {
+      Token *lastToken = tokens.back();
+      if (lastToken->getStopIndex() != INVALID_INDEX) {
+        start = lastToken->getStopIndex() + 1;
+      }
+      line = lastToken->getLine();
+      charPositionInLine = lastToken->getCharPositionInLine();
+    }
+    size_t stop = start == INVALID_INDEX ? INVALID_INDEX : start - 1;
+    records.push_back({ narrow(Token::EOF), narrow(Token::DEFAULT_CHANNEL), narrow(start), narrow(stop),
+      narrow(line), narrow(charPositionInLine), 0, 0 });
+  }
+
+  Header header;
+  std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+  header.byteOrder = BYTE_ORDER_MARK;
+  header.version = VERSION;
+  header.flags = withText ? HAS_TEXT : 0;
+  header.reserved = 0;
+  header.tokenCount = records.size();
+  header.sourceNameSize = sourceName.size();
+  header.textPoolSize = textPool.size();
+
+  output.write(reinterpret_cast<const char *>(&header), sizeof(Header));
+  output.write(reinterpret_cast<const char *>(records.data()),
+               static_cast<std::streamsize>(records.size() * sizeof(Record)));
+  output.write(sourceName.data(), static_cast<std::streamsize>(sourceName.size()));
+  output.write(textPool.data(), static_cast<std::streamsize>(textPool.size()));
+  if (!output) {
+    throw IOException("cannot write token file");
+  }
+}
+
+void TokenFile::write(const std::string &fileName, const std::vector<Token *> &tokens, const std::string &sourceName,
+                      bool withText) {
+#ifdef _MSC_VER
+  std::ofstream stream(antlrcpp::s2ws(fileName), std::ios::binary);
+#else
+  std::ofstream stream(fileName, std::ios::binary);
+#endif
+  if (!stream) {
+    throw IOException("cannot create token file " + fileName);
+  }
+  write(stream, tokens, sourceName, withText);
+}
+
+size_t TokenFile::size() const {
+  return _tokenCount;
+}
+
+bool TokenFile::hasText() const {
+  return _hasText;
+}
+
+std::string TokenFile::getSourceName() const {
+  return std::string(_sourceName);
+}
+
+size_t TokenFile::getType(size_t index) const {
+  return widen(at(index).type);
+}
+
+size_t TokenFile::getChannel(size_t index) const {
+  return widen(at(index).channel);
+}
+
+size_t TokenFile::getStartIndex(size_t index) const {
+  return widen(at(index).start);
+}
+
+size_t TokenFile::getStopIndex(size_t index) const {
+  return widen(at(index).stop);
+}
+
+size_t TokenFile::getLine(size_t index) const {
+  return widen(at(index).line);
+}
+
+size_t TokenFile::getCharPositionInLine(size_t index) const {
+  return widen(at(index).charPositionInLine);
+}
+
+std::string_view TokenFile::getText(size_t index) const {
+  const Record &record = at(index);
+  if (record.textOffset > _textPool.size() || record.textLength > _textPool.size() - record.textOffset) {
+    throw IllegalArgumentException("text of token " + std::to_string(index) + " is outside the text pool");
+  }
+  return _textPool.substr(record.textOffset, record.textLength);
+}
+
+void TokenFile::unmap() {
+#ifndef _WIN32
+  if (_data != nullptr) {
+    ::munmap(const_cast<char *>(_data), _size);
+  }
+#endif
+  _data = nullptr;
+  _size = 0;
+}
+
+const TokenFile::Record& TokenFile::at(size_t index) const {
+  if (index >= _tokenCount) {
+    throw IndexOutOfBoundsException("token index " + std::to_string(index) + " out of range 0.." +
+                                    std::to_string(_tokenCount - 1));
+  }
+  return _records[index];
+}
@@ -0,0 +1,77 @@
+/* Copyright (c) 2012-2017 The ANTLR Project. All rights reserved.
+ * Use of this file is governed by the BSD 3-clause license that
+ * can be found in the LICENSE.txt file in the project root.
+ */
+
+#pragma once
+
+#include "antlr4-common.h"
+
+namespace antlr4 {
+
+  /// A fully lexed token stream persisted in a compact binary file, which is memory mapped when loaded. Parsing
+  /// the same input again, e.g. with another start rule or parser configuration, can then skip lexing: a
+  /// MappedTokenSource reads the tokens from the file, without copying their data.
+  ///
+  /// The file holds a header, a record of 32 bytes per token (type, channel, start and stop index, line, column
+  /// and its text in the text pool, each as a 32 bit number), the source name and an optional text pool in which
+  /// equal texts are stored once. Without the text pool, the text of the tokens is taken from their input stream.
+  /// Numbers are stored in the byte order of the machine writing the file; a file written on a machine with
+  /// another byte order is rejected.
+  class ANTLR4CPP_PUBLIC TokenFile {
+  public:
+    /// Maps the given token file. Throws an IOException if it cannot be read and an IllegalArgumentException if
+    /// it is not a valid token file.
+    TokenFile(const std::string &fileName);
+    TokenFile(const TokenFile &) = delete;
+    ~TokenFile();
+
+    TokenFile& operator = (const TokenFile &) = delete;
+
+    /// Writes the tokens, usually all tokens of a BufferedTokenStream (see BufferedTokenStream::getTokens()),
+    /// which should end with EOF, else an EOF token is added after the last one. The text of the tokens is
+    /// stored if withText is true. Throws an IllegalArgumentException if an index or position does not fit
+    /// into 32 bits.
+    static void write(std::ostream &output, const std::vector<Token *> &tokens, const std::string &sourceName,
+                      bool withText = true);
+    static void write(const std::string &fileName, const std::vector<Token *> &tokens,
+                      const std::string &sourceName, bool withText = true);
+
+    /// The number of tokens, including EOF.
+    size_t size() const;
+
+    /// Whether the file holds the text of the tokens.
+    bool hasText() const;
+
+    std::string getSourceName() const;
+
+    size_t getType(size_t index) const;
+    size_t getChannel(size_t index) const;
+    size_t getStartIndex(size_t index) const;
+    size_t getStopIndex(size_t index) const;
+    size_t getLine(size_t index) const;
+    size_t getCharPositionInLine(size_t index) const;
+
+    /// The text of the token at the given index in the mapped file, empty if the file has no text.
+    std::string_view getText(size_t index) const;
+
+  private:
+    struct Record;
+
+    const char *_data = nullptr;
+    size_t _size = 0;
+
+    /// The file contents, where they cannot be mapped.
+    std::vector<char> _buffer;
+
+    const Record *_records = nullptr;
+    size_t _tokenCount = 0;
+    std::string_view _sourceName;
+    std::string_view _textPool;
+    bool _hasText = false;
+
+    void unmap();
+    const Record& at(size_t index) const;
+  };
+
+} // namespace antlr4
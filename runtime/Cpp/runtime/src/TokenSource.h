@@ -34,6 +34,11 @@ namespace antlr4 {
     /// to the parser.
     virtual std::unique_ptr<Token> nextToken() = 0;
 
+    /// Appends up to {@code n} tokens to {@code tokens}, stopping after the EOF token, and returns the number of
+    /// tokens added. This is what token streams use to fetch tokens in bulk. The default implementation calls
+    /// nextToken() for each token; sources which can produce a batch faster (like the Lexer) override it.
+    virtual size_t nextTokens(std::vector<std::unique_ptr<Token>> &tokens, size_t n);
+
     /// <summary>
     /// Get the line number for the current position in the input stream. The
     /// first line in the input is line 1.
@@ -7,6 +7,7 @@
 #include "misc/Interval.h"
 #include "Token.h"
 #include "TokenStream.h"
+#include "support/CPPUtils.h"
 
 #include "TokenStreamRewriter.h"
 
@@ -109,10 +110,14 @@ void TokenStreamRewriter::rollback(size_t instructionIndex) {
 }
 
 void TokenStreamRewriter::rollback(const std::string &programName, size_t instructionIndex) {
-  std::vector<RewriteOperation*> is = _programs[programName];
-  if (is.size() > 0) {
-    _programs.insert({ programName, std::vector<RewriteOperation*>(is.begin() + MIN_TOKEN_INDEX, is.begin() + instructionIndex) });
+  std::vector<RewriteOperation*> &is = getProgram(programName);
+  for (size_t i = std::max(instructionIndex, MIN_TOKEN_INDEX); i < is.size(); ++i) {
+    delete is[i];
   }
+  if (instructionIndex < is.size()) {
+    is.resize(std::max(instructionIndex, MIN_TOKEN_INDEX));
+  }
+  _reducedPrograms.erase(programName);
 }
 
 void TokenStreamRewriter::deleteProgram() {
@@ -157,6 +162,7 @@ void TokenStreamRewriter::insertBefore(const std::string &programName, size_t in
   std::vector<RewriteOperation*> &rewrites = getProgram(programName);
   op->instructionIndex = rewrites.size();
   rewrites.push_back(op);
+  _reducedPrograms.erase(programName);
 }
 
 void TokenStreamRewriter::replace(size_t index, const std::string& text) {
@@ -184,6 +190,7 @@ void TokenStreamRewriter::replace(const std::string &programName, size_t from, s
   std::vector<RewriteOperation*> &rewrites = getProgram(programName);
   op->instructionIndex = rewrites.size();
   rewrites.push_back(op);
+  _reducedPrograms.erase(programName);
 }
 
 void TokenStreamRewriter::replace(const std::string &programName, Token *from, Token *to, const std::string& text) {
@@ -257,7 +264,67 @@ std::string TokenStreamRewriter::getText(const Interval &interval) {
 }
 
 std::string TokenStreamRewriter::getText(const std::string &programName, const Interval &interval) {
-  std::vector<TokenStreamRewriter::RewriteOperation*> &rewrites = _programs[programName];
+  if (getProgram(programName).empty()) {
+    return tokens->getText(interval); // no instructions to execute
+  }
+
+  std::ostringstream buf;
+  getText(programName, interval, buf);
+  return buf.str();
+}
+
+void TokenStreamRewriter::getText(const std::string &programName, const Interval &interval, std::ostream &output) {
+  if (getProgram(programName).empty()) {
+    output << tokens->getText(interval); // no instructions to execute
+    return;
+  }
+
+  render(getReducedProgram(programName), interval, output);
+}
+
+std::map<std::string, std::string> TokenStreamRewriter::getTexts(size_t threadCount) {
+  std::vector<std::pair<std::string, Interval>> jobs;
+  for (const auto &program : _programs) {
+    jobs.emplace_back(program.first, Interval(0UL, tokens->size() - 1));
+  }
+  std::vector<std::string> texts = render(jobs, threadCount);
+
+  std::map<std::string, std::string> result;
+  for (size_t i = 0; i < jobs.size(); ++i) {
+    result.emplace(std::move(jobs[i].first), std::move(texts[i]));
+  }
+  return result;
+}
+
+std::vector<std::string> TokenStreamRewriter::getTexts(const std::vector<std::string> &programNames,
+                                                       size_t threadCount) {
+  std::vector<std::pair<std::string, Interval>> jobs;
+  for (const std::string &programName : programNames) {
+    jobs.emplace_back(programName, Interval(0UL, tokens->size() - 1));
+  }
+  return render(jobs, threadCount);
+}
+
+std::vector<std::string> TokenStreamRewriter::getTexts(const std::string &programName,
+                                                       const std::vector<Interval> &intervals, size_t threadCount) {
+  std::vector<std::pair<std::string, Interval>> jobs;
+  for (const Interval &interval : intervals) {
+    jobs.emplace_back(programName, interval);
+  }
+  return render(jobs, threadCount);
+}
+
+const std::map<size_t, TokenStreamRewriter::Piece>& TokenStreamRewriter::getReducedProgram(const std::string &name) {
+  // First, optimize instruction stream, once until the program changes
+  auto reduced = _reducedPrograms.find(name);
+  if (reduced == _reducedPrograms.end()) {
+    reduced = _reducedPrograms.emplace(name, reduceToSingleOperationPerIndex(getProgram(name))).first;
+  }
+  return reduced->second;
+}
+
+void TokenStreamRewriter::render(const std::map<size_t, Piece> &pieces, const Interval &interval,
+                                 std::ostream &output) const {
   size_t start = interval.a;
   size_t stop = interval.b;
 
@@ -269,144 +336,229 @@ std::string TokenStreamRewriter::getText(const std::string &programName, const I
     start = 0;
   }
 
-  if (rewrites.empty() || rewrites.empty()) {
-    return tokens->getText(interval); // no instructions to execute
-  }
-  std::string buf;
-
-  // First, optimize instruction stream
-  std::unordered_map<size_t, TokenStreamRewriter::RewriteOperation*> indexToOp = reduceToSingleOperationPerIndex(rewrites);
-
-  // Walk buffer, executing instructions and emitting tokens
+  // Walk buffer, executing instructions and emitting tokens. The pieces are ordered by index, so the next one
+  // to execute is always at hand.
+  size_t last = tokens->size() - 1;
+  bool lastExecuted = false;
+  auto piece = pieces.lower_bound(start);
   size_t i = start;
   while (i <= stop && i < tokens->size()) {
-    RewriteOperation *op = indexToOp[i];
-    indexToOp.erase(i); // remove so any left have index size-1
-    Token *t = tokens->get(i);
-    if (op == nullptr) {
+    while (piece != pieces.end() && piece->first < i) {
+      ++piece; // skipped by a replace
+    }
+
+    if (piece == pieces.end() || piece->first != i) {
       // no operation at that index, just dump token
+      Token *t = tokens->get(i);
       if (t->getType() != Token::EOF) {
-        buf.append(t->getText());
+        output << t->getText();
       }
       i++; // move to next token
+      continue;
     }
-    else {
-      i = op->execute(&buf); // execute operation and skip
+
+    // execute operation and skip
+    const Piece &op = piece->second;
+    lastExecuted = lastExecuted || i == last;
+    output << op.text;
+    if (op.replace) {
+      i = op.lastIndex + 1;
+    } else {
+      Token *t = tokens->get(i);
+      if (t->getType() != Token::EOF) {
+        output << t->getText();
+      }
+      i++;
     }
+    ++piece;
   }
 
   // include stuff after end if it's last index in buffer
   // So, if they did an insertAfter(lastValidIndex, "foo"), include
   // foo if end==lastValidIndex.
-  if (stop == tokens->size() - 1) {
+  if (stop == last) {
     // Scan any remaining operations after last token
     // should be included (they will be inserts).
-    for (auto op : indexToOp) {
-      if (op.second->index >= tokens->size() - 1) {
-        buf.append(op.second->text);
+    for (auto op = pieces.lower_bound(last); op != pieces.end(); ++op) {
+      if (op->first != last || !lastExecuted) {
+        output << op->second.text;
       }
     }
   }
-  return buf;
 }
 
-std::unordered_map<size_t, TokenStreamRewriter::RewriteOperation*> TokenStreamRewriter::reduceToSingleOperationPerIndex(
-  std::vector<TokenStreamRewriter::RewriteOperation*> &rewrites) {
+std::vector<std::string> TokenStreamRewriter::render(const std::vector<std::pair<std::string, Interval>> &jobs,
+                                                     size_t threadCount) {
+  // Reduce the programs which are not yet, concurrently as well. Looking them up may add them, so that is done
+  // up front, and the workers only read this object and the token stream.
+  std::vector<std::string> unreduced;
+  for (const auto &job : jobs) {
+    if (!getProgram(job.first).empty() && _reducedPrograms.count(job.first) == 0 &&
+        std::find(unreduced.begin(), unreduced.end(), job.first) == unreduced.end()) {
+      unreduced.push_back(job.first);
+    }
+  }
+  std::vector<std::map<size_t, Piece>> reductions(unreduced.size());
+  antlrcpp::runConcurrently(unreduced.size(), threadCount, [&](size_t i) {
+    reductions[i] = reduceToSingleOperationPerIndex(_programs.at(unreduced[i]));
+  });
+  for (size_t i = 0; i < unreduced.size(); ++i) {
+    _reducedPrograms.emplace(std::move(unreduced[i]), std::move(reductions[i]));
+  }
 
+  // Programs without operations render the plain tokens.
+  static const std::map<size_t, Piece> noPieces;
+  std::vector<const std::map<size_t, Piece>*> pieces;
+  for (const auto &job : jobs) {
+    auto reduced = _reducedPrograms.find(job.first);
+    pieces.push_back(reduced == _reducedPrograms.end() ? &noPieces : &reduced->second);
+  }
 
-  // WALK REPLACES
-  for (size_t i = 0; i < rewrites.size(); ++i) {
-    TokenStreamRewriter::RewriteOperation *op = rewrites[i];
+  std::vector<std::string> texts(jobs.size());
+  antlrcpp::runConcurrently(jobs.size(), threadCount, [&](size_t i) {
+    std::ostringstream output;
+    render(*pieces[i], jobs[i].second, output);
+    texts[i] = output.str();
+  });
+  return texts;
+}
+
+std::map<size_t, TokenStreamRewriter::Piece> TokenStreamRewriter::reduceToSingleOperationPerIndex(
+  const std::vector<TokenStreamRewriter::RewriteOperation*> &rewrites) {
+
+  // Work on copies, in instruction order; the ones found to be no-ops are killed.
+  std::vector<Piece> ops;
+  std::vector<bool> alive(rewrites.size(), true);
+  ops.reserve(rewrites.size());
+  for (RewriteOperation *op : rewrites) {
     ReplaceOp *rop = dynamic_cast<ReplaceOp *>(op);
-    if (rop == nullptr)
+    ops.push_back({ op->index, rop != nullptr ? rop->lastIndex : op->index, op->text, rop != nullptr });
+  }
+
+  auto toString = [this](const Piece &op) {
+    auto tokenText = [this](size_t index) {
+      return index < tokens->size() ? tokens->get(index)->getText() : "<EOF>";
+    };
+    if (!op.replace) {
+      return "<InsertBeforeOp@" + tokenText(op.index) + ":\"" + op.text + "\">";
+    }
+    if (op.text.empty()) {
+      return "<DeleteOp@" + tokenText(op.index) + ".." + tokenText(op.lastIndex) + ">";
+    }
+    return "<ReplaceOp@" + tokenText(op.index) + ".." + tokenText(op.lastIndex) + ":\"" + op.text + "\">";
+  };
+
+  // The live inserts so far by token index, in instruction order, and the live replaces by their first token
+  // index. Live replaces never overlap, so they are ordered by their last token index as well.
+  std::map<size_t, std::vector<size_t>> inserts;
+  std::map<size_t, size_t> replaces;
+
+  // WALK REPLACES
+  for (size_t i = 0; i < ops.size(); ++i) {
+    Piece &rop = ops[i];
+    if (!rop.replace) {
+      inserts[rop.index].push_back(i);
       continue;
+    }
 
     // Wipe prior inserts within range
-    std::vector<InsertBeforeOp *> inserts = getKindOfOps<InsertBeforeOp>(rewrites, i);
-    for (auto *iop : inserts) {
-      if (iop->index == rop->index) {
-        // E.g., insert before 2, delete 2..2; update replace
-        // text to include insert before, kill insert
-        delete rewrites[iop->instructionIndex];
-        rewrites[iop->instructionIndex] = nullptr;
-        rop->text = iop->text + (!rop->text.empty() ? rop->text : "");
+    for (auto iops = inserts.lower_bound(rop.index); iops != inserts.end() && iops->first <= rop.lastIndex;
+         iops = inserts.erase(iops)) {
+      for (size_t j : iops->second) {
+        if (iops->first == rop.index) {
+          // E.g., insert before 2, delete 2..2; update replace
+          // text to include insert before, kill insert
+          rop.text = ops[j].text + rop.text;
+        }
+        // otherwise delete insert as it's a no-op.
+        alive[j] = false;
       }
-      else if (iop->index > rop->index && iop->index <= rop->lastIndex) {
-        // delete insert as it's a no-op.
-        delete rewrites[iop->instructionIndex];
-        rewrites[iop->instructionIndex] = nullptr;
+    }
+
+    // Drop any prior replaces contained within. Only the ones overlapping this one matter, which are handled
+    // in instruction order.
+    std::vector<size_t> prevReplaces;
+    for (auto prev = replaces.upper_bound(rop.lastIndex); prev != replaces.begin();) {
+      --prev;
+      if (ops[prev->second].lastIndex < rop.index) {
+        break;
       }
+      prevReplaces.push_back(prev->second);
     }
-    // Drop any prior replaces contained within
-    std::vector<ReplaceOp*> prevReplaces = getKindOfOps<ReplaceOp>(rewrites, i);
-    for (auto *prevRop : prevReplaces) {
-      if (prevRop->index >= rop->index && prevRop->lastIndex <= rop->lastIndex) {
+    std::sort(prevReplaces.begin(), prevReplaces.end());
+
+    for (size_t j : prevReplaces) {
+      const Piece &prevRop = ops[j];
+      if (prevRop.index >= rop.index && prevRop.lastIndex <= rop.lastIndex) {
         // delete replace as it's a no-op.
-        delete rewrites[prevRop->instructionIndex];
-        rewrites[prevRop->instructionIndex] = nullptr;
+        replaces.erase(prevRop.index);
+        alive[j] = false;
         continue;
       }
       // throw exception unless disjoint or identical
-      bool disjoint = prevRop->lastIndex < rop->index || prevRop->index > rop->lastIndex;
+      bool disjoint = prevRop.lastIndex < rop.index || prevRop.index > rop.lastIndex;
       // Delete special case of replace (text==null):
       // D.i-j.u D.x-y.v    | boundaries overlap    combine to max(min)..max(right)
-      if (prevRop->text.empty() && rop->text.empty() && !disjoint) {
-        delete rewrites[prevRop->instructionIndex];
-        rewrites[prevRop->instructionIndex] = nullptr; // kill first delete
-        rop->index = std::min(prevRop->index, rop->index);
-        rop->lastIndex = std::max(prevRop->lastIndex, rop->lastIndex);
-        std::cout << "new rop " << rop << std::endl;
-      }
-      else if (!disjoint) {
-        throw IllegalArgumentException("replace op boundaries of " + rop->toString() +
-                                       " overlap with previous " + prevRop->toString());
+      if (prevRop.text.empty() && rop.text.empty() && !disjoint) {
+        replaces.erase(prevRop.index);
+        alive[j] = false; // kill first delete
+        rop.index = std::min(prevRop.index, rop.index);
+        rop.lastIndex = std::max(prevRop.lastIndex, rop.lastIndex);
+      } else if (!disjoint) {
+        throw IllegalArgumentException("replace op boundaries of " + toString(rop) + " overlap with previous " +
+                                       toString(prevRop));
       }
     }
+    replaces[rop.index] = i;
   }
 
   // WALK INSERTS
-  for (size_t i = 0; i < rewrites.size(); i++) {
-    InsertBeforeOp *iop = dynamic_cast<InsertBeforeOp *>(rewrites[i]);
-    if (iop == nullptr)
+  std::map<size_t, size_t> combined; // the live insert at each index
+  for (size_t i = 0; i < ops.size(); ++i) {
+    Piece &iop = ops[i];
+    if (iop.replace || !alive[i]) {
       continue;
+    }
 
     // combine current insert with prior if any at same index
-
-    std::vector<InsertBeforeOp *> prevInserts = getKindOfOps<InsertBeforeOp>(rewrites, i);
-    for (auto *prevIop : prevInserts) {
-      if (prevIop->index == iop->index) { // combine objects
-                                          // convert to strings...we're in process of toString'ing
-                                          // whole token buffer so no lazy eval issue with any templates
-        iop->text = catOpText(&iop->text, &prevIop->text);
-        // delete redundant prior insert
-        delete rewrites[prevIop->instructionIndex];
-        rewrites[prevIop->instructionIndex] = nullptr;
-      }
+    auto prevIop = combined.find(iop.index);
+    if (prevIop != combined.end()) {
+      // convert to strings...we're in process of toString'ing
+      // whole token buffer so no lazy eval issue with any templates
+      iop.text = catOpText(&iop.text, &ops[prevIop->second].text);
+      // delete redundant prior insert
+      alive[prevIop->second] = false;
     }
+    combined[iop.index] = i;
+
     // look for replaces where iop.index is in range; error
-    std::vector<ReplaceOp*> prevReplaces = getKindOfOps<ReplaceOp>(rewrites, i);
-    for (auto *rop : prevReplaces) {
-      if (iop->index == rop->index) {
-        rop->text = catOpText(&iop->text, &rop->text);
-        delete rewrites[i];
-        rewrites[i] = nullptr; // delete current insert
-        continue;
-      }
-      if (iop->index >= rop->index && iop->index <= rop->lastIndex) {
-        throw IllegalArgumentException("insert op " + iop->toString() + " within boundaries of previous " + rop->toString());
-      }
+    auto rops = replaces.upper_bound(iop.index);
+    if (rops == replaces.begin()) {
+      continue;
+    }
+    --rops;
+    Piece &rop = ops[rops->second];
+    if (rops->second > i || iop.index > rop.lastIndex) {
+      continue;
+    }
+    if (iop.index == rop.index) {
+      rop.text = catOpText(&iop.text, &rop.text);
+      alive[i] = false; // delete current insert
+      combined.erase(iop.index);
+      continue;
     }
+    throw IllegalArgumentException("insert op " + toString(iop) + " within boundaries of previous " + toString(rop));
   }
 
-  std::unordered_map<size_t, TokenStreamRewriter::RewriteOperation*> m;
-  for (TokenStreamRewriter::RewriteOperation *op : rewrites) {
-    if (op == nullptr) { // ignore deleted ops
+  std::map<size_t, Piece> m;
+  for (size_t i = 0; i < ops.size(); ++i) {
+    if (!alive[i]) { // ignore deleted ops
       continue;
     }
-    if (m.count(op->index) > 0) {
+    if (m.count(ops[i].index) > 0) {
       throw RuntimeException("should only be one op per index");
     }
-    m[op->index] = op;
+    m.emplace(ops[i].index, std::move(ops[i]));
   }
 
   return m;
@@ -154,6 +154,25 @@ namespace antlr4 {
 
     virtual std::string getText(const std::string &programName, const misc::Interval &interval);
 
+    /// Writes the same text as getText(programName, interval) to the given stream, without building it in memory.
+    virtual void getText(const std::string &programName, const misc::Interval &interval, std::ostream &output);
+
+    /// Renders all programs at once, each into its own buffer, and returns their texts by program name.
+    /// The programs are rendered on up to threadCount threads, the calling one included; with a thread count of 0,
+    /// as many threads are used as there are hardware threads. The token stream is shared by the threads and only
+    /// read through TokenStream::get(), so all its tokens must be buffered, which is the case after parsing with
+    /// a CommonTokenStream. If rendering a program throws, the exception of the first one is rethrown.
+    virtual std::map<std::string, std::string> getTexts(size_t threadCount = 0);
+
+    /// Renders the given programs concurrently, as getTexts(threadCount) does, and returns their texts in the
+    /// order of the names.
+    virtual std::vector<std::string> getTexts(const std::vector<std::string> &programNames, size_t threadCount = 0);
+
+    /// Renders the given intervals of one program concurrently, as getTexts(threadCount) does, and returns their
+    /// texts in the order of the intervals.
+    virtual std::vector<std::string> getTexts(const std::string &programName,
+                                              const std::vector<misc::Interval> &intervals, size_t threadCount = 0);
+
   protected:
     class RewriteOperation {
     public:
@@ -207,6 +226,15 @@ namespace antlr4 {
     /// Our source stream
     TokenStream *const tokens;
 
+    /// What an operation does after all operations were combined: write text before the token at index, which is
+    /// kept for an insert, or in place of the tokens index..lastIndex for a replace.
+    struct Piece {
+      size_t index;
+      size_t lastIndex;
+      std::string text;
+      bool replace;
+    };
+
     /// You may have multiple, named streams of rewrite operations.
     /// I'm calling these things "programs."
     /// Maps String (name) -> rewrite (List)
@@ -259,37 +287,37 @@ namespace antlr4 {
     ///         insert with replace and delete this replace.
     ///         3. throw exception if index in same range as previous replace
     ///
-    ///  Don't actually delete; make op null in list. Easier to walk list.
-    ///  Later we can throw as we add to index -> op map.
+    ///  The program itself is not changed: the operations are copied into pieces, which are kept in maps
+    ///  ordered by token index. Each check then looks only at the operations in the range at hand, so the
+    ///  reduction takes O(n log n) for n operations. Later we can throw as we add to index -> piece map.
     ///
     ///  Note that I.2 R.2-2 will wipe out I.2 even though, technically, the
     ///  inserted stuff would be before the replace range.  But, if you
     ///  add tokens in front of a method body '{' and then delete the method
     ///  body, I think the stuff before the '{' you added should disappear too.
     ///
-    ///  Return a map from token index to operation.
+    ///  Return a map from token index to piece.
     /// </summary>
-    virtual std::unordered_map<size_t, RewriteOperation*> reduceToSingleOperationPerIndex(std::vector<RewriteOperation*> &rewrites);
+    virtual std::map<size_t, Piece> reduceToSingleOperationPerIndex(const std::vector<RewriteOperation*> &rewrites);
 
     virtual std::string catOpText(std::string *a, std::string *b);
 
-    /// Get all operations before an index of a particular kind.
-    template <typename T>
-    std::vector<T *> getKindOfOps(std::vector<RewriteOperation *> rewrites, size_t before) {
-      std::vector<T *> ops;
-      for (size_t i = 0; i < before && i < rewrites.size(); i++) {
-        T *op = dynamic_cast<T *>(rewrites[i]);
-        if (op == nullptr) { // ignore deleted or non matching entries
-          continue;
-        }
-        ops.push_back(op);
-      }
-      return ops;
-    }
-
   private:
+    /// The reduced operations of each program, until it changes.
+    std::map<std::string, std::map<size_t, Piece>> _reducedPrograms;
+
     std::vector<RewriteOperation *>& initializeProgram(const std::string &name);
 
+    /// Returns the reduced operations of a program, reducing them if they are not cached.
+    const std::map<size_t, Piece>& getReducedProgram(const std::string &name);
+
+    /// Writes the tokens in the interval with the given pieces applied. Only reads the token stream and pieces.
+    void render(const std::map<size_t, Piece> &pieces, const misc::Interval &interval, std::ostream &output) const;
+
+    /// Renders the programs in the interval of each job, concurrently.
+    std::vector<std::string> render(const std::vector<std::pair<std::string, misc::Interval>> &jobs,
+                                    size_t threadCount);
+
   };
 
 } // namespace antlr4
@@ -17,12 +17,16 @@
 using namespace antlr4;
 
 UnbufferedTokenStream::UnbufferedTokenStream(TokenSource *tokenSource) : UnbufferedTokenStream(tokenSource, 256) {
+  _growable = true;
 }
 
-UnbufferedTokenStream::UnbufferedTokenStream(TokenSource *tokenSource, int /*bufferSize*/)
-  : _tokenSource(tokenSource), _lastToken(nullptr), _lastTokenBufferStart(nullptr)
+UnbufferedTokenStream::UnbufferedTokenStream(TokenSource *tokenSource, int bufferSize)
+  : _tokenSource(tokenSource)
 {
   InitializeInstanceFields();
+
+  // The current token and the one before it must fit.
+  _tokens.resize(static_cast<size_t>(std::max(bufferSize, 2)));
   fill(1); // prime the pump
 }
 
@@ -32,31 +36,39 @@ UnbufferedTokenStream::~UnbufferedTokenStream() {
 Token* UnbufferedTokenStream::get(size_t i) const
 { // get absolute index
   size_t bufferStartIndex = getBufferStartIndex();
-  if (i < bufferStartIndex || i >= bufferStartIndex + _tokens.size()) {
+  if (i < bufferStartIndex || i >= bufferStartIndex + _count) {
     throw IndexOutOfBoundsException(std::string("get(") + std::to_string(i) + std::string(") outside buffer: ")
-      + std::to_string(bufferStartIndex) + std::string("..") + std::to_string(bufferStartIndex + _tokens.size()));
+      + std::to_string(bufferStartIndex) + std::string("..") + std::to_string(bufferStartIndex + _count));
   }
-  return _tokens[i - bufferStartIndex].get();
+  return at(i);
 }
 
 Token* UnbufferedTokenStream::LT(ssize_t i)
 {
-  if (i == -1) {
-    return _lastToken;
+  if (i == 0) {
+    return nullptr;
   }
 
-  sync(i);
-  ssize_t index = static_cast<ssize_t>(_p) + i - 1;
-  if (index < 0) {
-    throw IndexOutOfBoundsException(std::string("LT(") + std::to_string(i) + std::string(") gives negative index"));
+  if (i < 0) {
+    size_t back = static_cast<size_t>(-i);
+    if (back > _currentTokenIndex || _currentTokenIndex - back < getBufferStartIndex()) {
+      if (i == -1 && _currentTokenIndex == 0) {
+        return nullptr;
+      }
+      throw IndexOutOfBoundsException(std::string("LT(") + std::to_string(i) + std::string(") outside buffer"));
+    }
+    return at(_currentTokenIndex - back);
   }
 
-  if (index >= static_cast<ssize_t>(_tokens.size())) {
-    assert(_tokens.size() > 0 && _tokens.back()->getType() == EOF);
-    return _tokens.back().get();
+  sync(i);
+  size_t index = _currentTokenIndex + static_cast<size_t>(i) - 1;
+  if (index >= getBufferStartIndex() + _count) {
+    Token *last = at(getBufferStartIndex() + _count - 1);
+    assert(last->getType() == EOF);
+    return last;
   }
 
-  return _tokens[static_cast<size_t>(index)].get();
+  return at(index);
 }
 
 size_t UnbufferedTokenStream::LA(ssize_t i)
@@ -90,32 +102,16 @@ void UnbufferedTokenStream::consume()
     throw IllegalStateException("cannot consume EOF");
   }
 
-  // buf always has at least tokens[p==0] in this method due to ctor
-  _lastToken = _tokens[_p].get(); // track last token for LT(-1)
-
-  // if we're at last token and no markers, opportunity to flush buffer
-  if (_p == _tokens.size() - 1 && _numMarkers == 0) {
-    _tokens.clear();
-    _p = 0;
-    _lastTokenBufferStart = _lastToken;
-  } else {
-    ++_p;
-  }
-
   ++_currentTokenIndex;
   sync(1);
 }
 
-/// <summary>
-/// Make sure we have 'need' elements from current position <seealso cref="#p p"/>. Last valid
-///  {@code p} index is {@code tokens.length-1}.  {@code p+need-1} is the tokens index 'need' elements
-///  ahead.  If we need 1 element, {@code (p+1-1)==p} must be less than {@code tokens.length}.
-/// </summary>
 void UnbufferedTokenStream::sync(ssize_t want)
 {
-  ssize_t need = (static_cast<ssize_t>(_p) + want - 1) - static_cast<ssize_t>(_tokens.size()) + 1; // how many more elements we need?
-  if (need > 0) {
-    fill(static_cast<size_t>(need));
+  size_t end = getBufferStartIndex() + _count;
+  size_t wanted = _currentTokenIndex + static_cast<size_t>(want); // the end of the wanted tokens
+  if (want > 0 && wanted > end) {
+    fill(wanted - end);
   }
 }
 
@@ -127,7 +123,7 @@ void UnbufferedTokenStream::sync(ssize_t want)
 size_t UnbufferedTokenStream::fill(size_t n)
 {
   for (size_t i = 0; i < n; i++) {
-    if (_tokens.size() > 0 && _tokens.back()->getType() == EOF) {
+    if (_count > 0 && at(getBufferStartIndex() + _count - 1)->getType() == EOF) {
       return i;
     }
 
@@ -139,12 +135,28 @@ size_t UnbufferedTokenStream::fill(size_t n)
 
 void UnbufferedTokenStream::add(std::unique_ptr<Token> t)
 {
+  if (_count == _tokens.size()) {
+    // Tokens from the lowest position still needed on are kept, and the one before it as LT(-1).
+    size_t needed = _markers.empty() ? _currentTokenIndex : std::min(_markers.back(), _currentTokenIndex);
+    if (_bufferStartIndex + 1 < needed) {
+      ++_bufferStartIndex;
+      --_count;
+    } else if (_growable) {
+      grow();
+    } else {
+      throw IllegalStateException("UnbufferedTokenStream: lookahead and marks need more than the window of " +
+        std::to_string(_tokens.size()) + " tokens; use a larger buffer size.");
+    }
+  }
+
+  size_t index = getBufferStartIndex() + _count;
   WritableToken *writable = dynamic_cast<WritableToken *>(t.get());
   if (writable != nullptr) {
-    writable->setTokenIndex(int(getBufferStartIndex() + _tokens.size()));
+    writable->setTokenIndex(index);
   }
 
-  _tokens.push_back(std::move(t));
+  _tokens[index % _tokens.size()] = std::move(t);
+  ++_count;
 }
 
 /// <summary>
@@ -156,33 +168,19 @@ void UnbufferedTokenStream::add(std::unique_ptr<Token> t)
 /// </summary>
 ssize_t UnbufferedTokenStream::mark()
 {
-  if (_numMarkers == 0) {
-    _lastTokenBufferStart = _lastToken;
-  }
-
-  int mark = -_numMarkers - 1;
-  _numMarkers++;
-  return mark;
+  size_t lowWater = _markers.empty() ? _currentTokenIndex : std::min(_markers.back(), _currentTokenIndex);
+  _markers.push_back(lowWater);
+  return -static_cast<ssize_t>(_markers.size());
 }
 
 void UnbufferedTokenStream::release(ssize_t marker)
 {
-  ssize_t expectedMark = -_numMarkers;
-  if (marker != expectedMark) {
+  ssize_t expectedMark = -static_cast<ssize_t>(_markers.size());
+  if (_markers.empty() || marker != expectedMark) {
     throw IllegalStateException("release() called with an invalid marker.");
   }
 
-  _numMarkers--;
-  if (_numMarkers == 0) { // can we release buffer?
-    if (_p > 0) {
-      // Copy tokens[p]..tokens[n-1] to tokens[0]..tokens[(n-1)-p], reset ptrs
-      // p is last valid token; move nothing if p==n as we have no valid char
-      _tokens.erase(_tokens.begin(), _tokens.begin() + static_cast<ssize_t>(_p));
-      _p = 0;
-    }
-
-    _lastTokenBufferStart = _lastToken;
-  }
+  _markers.pop_back();
 }
 
 size_t UnbufferedTokenStream::index()
@@ -197,28 +195,23 @@ void UnbufferedTokenStream::seek(size_t index)
   }
 
   if (index > _currentTokenIndex) {
-    sync(ssize_t(index - _currentTokenIndex));
-    index = std::min(index, getBufferStartIndex() + _tokens.size() - 1);
+    sync(ssize_t(index - _currentTokenIndex + 1));
+    index = std::min(index, getBufferStartIndex() + _count - 1);
   }
 
+  // The token before the target must be in the window as well, for LT(-1).
   size_t bufferStartIndex = getBufferStartIndex();
-  if (bufferStartIndex > index) {
-    throw IllegalArgumentException(std::string("cannot seek to negative index ") + std::to_string(index));
-  }
-
-  size_t i = index - bufferStartIndex;
-  if (i >= _tokens.size()) {
+  size_t first = bufferStartIndex == 0 ? 0 : bufferStartIndex + 1;
+  if (index < first) {
     throw UnsupportedOperationException(std::string("seek to index outside buffer: ") + std::to_string(index) +
-      " not in " + std::to_string(bufferStartIndex) + ".." + std::to_string(bufferStartIndex + _tokens.size()));
+      " not in " + std::to_string(first) + ".." + std::to_string(bufferStartIndex + _count));
   }
 
-  _p = i;
-  _currentTokenIndex = index;
-  if (_p == 0) {
-    _lastToken = _lastTokenBufferStart;
-  } else {
-    _lastToken = _tokens[_p - 1].get();
+  // Moving back below the low-water mark of the markers keeps the tokens from there on.
+  for (size_t &marker : _markers) {
+    marker = std::min(marker, index);
   }
+  _currentTokenIndex = index;
 }
 
 size_t UnbufferedTokenStream::size()
@@ -234,7 +227,7 @@ std::string UnbufferedTokenStream::getSourceName() const
 std::string UnbufferedTokenStream::getText(const misc::Interval &interval)
 {
   size_t bufferStartIndex = getBufferStartIndex();
-  size_t bufferStopIndex = bufferStartIndex + _tokens.size() - 1;
+  size_t bufferStopIndex = bufferStartIndex + _count - 1;
 
   size_t start = interval.a;
   size_t stop = interval.b;
@@ -243,13 +236,10 @@ std::string UnbufferedTokenStream::getText(const misc::Interval &interval)
       " not in token buffer window: " + std::to_string(bufferStartIndex) + ".." + std::to_string(bufferStopIndex));
   }
 
-  size_t a = start - bufferStartIndex;
-  size_t b = stop - bufferStartIndex;
-
   std::stringstream ss;
-  for (size_t i = a; i <= b; i++) {
-    Token *t = _tokens[i].get();
-    if (i > 0)
+  for (size_t i = start; i <= stop; i++) {
+    Token *t = at(i);
+    if (i > bufferStartIndex)
       ss << ", ";
     ss << t->getText();
   }
@@ -259,12 +249,27 @@ std::string UnbufferedTokenStream::getText(const misc::Interval &interval)
 
 size_t UnbufferedTokenStream::getBufferStartIndex() const
 {
-  return _currentTokenIndex - _p;
+  return _bufferStartIndex;
+}
+
+Token* UnbufferedTokenStream::at(size_t index) const
+{
+  return _tokens[index % _tokens.size()].get();
+}
+
+void UnbufferedTokenStream::grow()
+{
+  std::vector<std::unique_ptr<Token>> tokens(_tokens.size() * 2);
+  for (size_t i = getBufferStartIndex(); i < getBufferStartIndex() + _count; ++i) {
+    tokens[i % tokens.size()] = std::move(_tokens[i % _tokens.size()]);
+  }
+  _tokens = std::move(tokens);
 }
 
 void UnbufferedTokenStream::InitializeInstanceFields()
 {
-  _p = 0;
-  _numMarkers = 0;
+  _bufferStartIndex = 0;
+  _count = 0;
+  _growable = false;
   _currentTokenIndex = 0;
 }
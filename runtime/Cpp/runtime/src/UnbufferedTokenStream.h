@@ -9,9 +9,24 @@
 
 namespace antlr4 {
 
+  /// A token stream which keeps only a window of tokens, for inputs too large (or endless) to buffer entirely.
+  ///
+  /// The window is a ring of bufferSize slots, which tokens are put in as they are read and recycled in place once
+  /// they are no longer needed: tokens before the current one and before the position of the oldest outstanding
+  /// marker, except for the one right before them (LT(-1)).
+  ///
+  /// Without a buffer size, the window starts with 256 slots and doubles whenever lookahead or a marker needs more
+  /// tokens than it holds, so there is no limit. With a buffer size, memory use is bounded by it instead: if more
+  /// tokens are needed, an IllegalStateException is thrown rather than growing the window, so the buffer size must
+  /// cover the longest prediction of the grammar.
+  ///
+  /// Tokens that left the window are deleted, so they must not be referred to afterwards, e.g. from parse trees.
   class ANTLR4CPP_PUBLIC UnbufferedTokenStream : public TokenStream {
   public:
+    /// A stream whose window grows as needed.
     UnbufferedTokenStream(TokenSource *tokenSource);
+
+    /// A stream whose window is fixed at {@code bufferSize} tokens.
     UnbufferedTokenStream(TokenSource *tokenSource, int bufferSize);
     UnbufferedTokenStream(const UnbufferedTokenStream& other) = delete;
     virtual ~UnbufferedTokenStream();
@@ -46,45 +61,21 @@ namespace antlr4 {
     virtual std::string getSourceName() const override;
 
   protected:
-    /// Make sure we have 'need' elements from current position p. Last valid
-    /// p index is tokens.length - 1.  p + need - 1 is the tokens index 'need' elements
-    /// ahead.  If we need 1 element, (p+1-1)==p must be less than tokens.length.
     TokenSource *_tokenSource;
 
-    /// <summary>
-    /// A moving window buffer of the data being scanned. While there's a marker,
-    /// we keep adding to buffer. Otherwise, <seealso cref="#consume consume()"/> resets so
-    /// we start filling at index 0 again.
-    /// </summary>
-
+    /// The ring of slots holding the window. The token with absolute index i is in slot i % _tokens.size().
     std::vector<std::unique_ptr<Token>> _tokens;
 
-    /// <summary>
-    /// 0..n-1 index into <seealso cref="#tokens tokens"/> of next token.
-    /// <p/>
-    /// The {@code LT(1)} token is {@code tokens[p]}. If {@code p == n}, we are
-    /// out of buffered tokens.
-    /// </summary>
-    size_t _p;
+    /// The absolute index of the oldest token in the window, and the number of tokens in it.
+    size_t _bufferStartIndex;
+    size_t _count;
 
-    /// <summary>
-    /// Count up with <seealso cref="#mark mark()"/> and down with
-    /// <seealso cref="#release release()"/>. When we {@code release()} the last mark,
-    /// {@code numMarkers} reaches 0 and we reset the buffer. Copy
-    /// {@code tokens[p]..tokens[n-1]} to {@code tokens[0]..tokens[(n-1)-p]}.
-    /// </summary>
-    int _numMarkers;
+    /// Whether the ring grows when it is full of needed tokens, instead of throwing.
+    bool _growable;
 
-    /// <summary>
-    /// This is the {@code LT(-1)} token for the current position.
-    /// </summary>
-    Token *_lastToken;
-
-    /// <summary>
-    /// When {@code numMarkers > 0}, this is the {@code LT(-1)} token for the
-    /// first token in <seealso cref="#tokens"/>. Otherwise, this is {@code null}.
-    /// </summary>
-    Token *_lastTokenBufferStart;
+    /// For each outstanding marker, the lowest index the stream was at while it and the markers before it were
+    /// set (the low-water mark). Tokens from there on stay in the window.
+    std::vector<size_t> _markers;
 
     /// <summary>
     /// Absolute token index. It's the index of the token about to be read via
@@ -96,6 +87,7 @@ namespace antlr4 {
     /// </summary>
     size_t _currentTokenIndex;
 
+    /// Make sure the window holds the token 'want' elements ahead of the current one (LT(want)), or EOF.
     virtual void sync(ssize_t want);
 
     /// <summary>
@@ -104,11 +96,20 @@ namespace antlr4 {
     /// then EOF was reached before {@code n} tokens could be added.
     /// </summary>
     virtual size_t fill(size_t n);
+
+    /// Puts the token into the window, recycling the slot of the oldest token. If that token is still needed, the
+    /// window grows, or for a fixed size window an IllegalStateException is thrown.
     virtual void add(std::unique_ptr<Token> t);
 
     size_t getBufferStartIndex() const;
 
   private:
+    /// The token with the given absolute index, which must be in the window.
+    Token* at(size_t index) const;
+
+    /// Doubles the number of slots of the ring.
+    void grow();
+
     void InitializeInstanceFields();
   };
 
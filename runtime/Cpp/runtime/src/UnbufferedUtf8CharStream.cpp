@@ -0,0 +1,240 @@
+/* Copyright (c) 2012-2017 The ANTLR Project. All rights reserved.
+ * Use of this file is governed by the BSD 3-clause license that
+ * can be found in the LICENSE.txt file in the project root.
+ */
+
+#include "Exceptions.h"
+#include "misc/Interval.h"
+#include "support/Utf8.h"
+
+#include "UnbufferedUtf8CharStream.h"
+
+#include <cerrno>
+
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+using namespace antlrcpp;
+using namespace antlr4;
+
+namespace {
+
+  /// The number of bytes from the start of data up to an incomplete code point at its end, if there is one.
+  size_t completeLength(const char *data, size_t size) {
+    for (size_t i = size, back = 1; i > 0 && back <= 4; ++back) {
+      unsigned char c = static_cast<unsigned char>(data[--i]);
+      if ((c & 0xC0) != 0x80) {
+        size_t length = 1;
+        if ((c & 0xE0) == 0xC0) {
+          length = 2;
+        } else if ((c & 0xF0) == 0xE0) {
+          length = 3;
+        } else if ((c & 0xF8) == 0xF0) {
+          length = 4;
+        }
+        return back < length ? i : size;
+      }
+    }
+    return size;
+  }
+
+}
+
+UnbufferedUtf8CharStream::UnbufferedUtf8CharStream(std::istream &input, bool lenient, size_t blockSize)
+  : _stream(&input), _lenient(lenient) {
+  _bytes.resize(std::max<size_t>(blockSize, 1) + 3);
+}
+
+UnbufferedUtf8CharStream::UnbufferedUtf8CharStream(int fd, bool lenient, size_t blockSize)
+  : _fd(fd), _lenient(lenient) {
+  _bytes.resize(std::max<size_t>(blockSize, 1) + 3);
+}
+
+void UnbufferedUtf8CharStream::consume() {
+  if (LA(1) == EOF) {
+    throw IllegalStateException("cannot consume EOF");
+  }
+  ++_currentCharIndex;
+}
+
+size_t UnbufferedUtf8CharStream::LA(ssize_t i) {
+  if (i == 0) {
+    return 0; // undefined
+  }
+
+  if (i < 0) {
+    size_t back = static_cast<size_t>(-i);
+    if (back > _currentCharIndex) {
+      return 0; // Before the start of the input.
+    }
+    size_t index = _currentCharIndex - back;
+    if (index < _bufferStartIndex) {
+      throw IndexOutOfBoundsException("LA(" + std::to_string(i) + ") was discarded");
+    }
+    return _data[index - _bufferStartIndex];
+  }
+
+  size_t index = _currentCharIndex + static_cast<size_t>(i) - 1;
+  sync(index);
+  if (index >= _bufferStartIndex + _data.size()) {
+    return EOF;
+  }
+  return _data[index - _bufferStartIndex];
+}
+
+ssize_t UnbufferedUtf8CharStream::mark() {
+  size_t lowWater = _markers.empty() ? _currentCharIndex : std::min(_markers.back(), _currentCharIndex);
+  _markers.push_back(lowWater);
+  return -static_cast<ssize_t>(_markers.size());
+}
+
+void UnbufferedUtf8CharStream::release(ssize_t marker) {
+  if (_markers.empty() || marker != -static_cast<ssize_t>(_markers.size())) {
+    throw IllegalStateException("release() called with an invalid marker.");
+  }
+  _markers.pop_back();
+}
+
+size_t UnbufferedUtf8CharStream::index() {
+  return _currentCharIndex;
+}
+
+void UnbufferedUtf8CharStream::seek(size_t index) {
+  if (index > _currentCharIndex) {
+    // What is skipped is not needed any more, unless it is marked.
+    _currentCharIndex = index;
+    sync(index);
+    _currentCharIndex = std::min(index, _bufferStartIndex + _data.size());
+    return;
+  }
+
+  // The code point before the target must be in the window as well, for LA(-1).
+  size_t first = _bufferStartIndex == 0 ? 0 : _bufferStartIndex + 1;
+  if (index < first) {
+    throw UnsupportedOperationException("Seek to index outside buffer: " + std::to_string(index) + " not in " +
+                                        std::to_string(first) + ".." +
+                                        std::to_string(_bufferStartIndex + _data.size()));
+  }
+
+  for (size_t &marker : _markers) {
+    marker = std::min(marker, index);
+  }
+  _currentCharIndex = index;
+}
+
+size_t UnbufferedUtf8CharStream::size() {
+  throw UnsupportedOperationException("Unbuffered stream cannot know its size");
+}
+
+std::string UnbufferedUtf8CharStream::getSourceName() const {
+  if (name.empty()) {
+    return UNKNOWN_SOURCE_NAME;
+  }
+  return name;
+}
+
+std::string UnbufferedUtf8CharStream::getText(const misc::Interval &interval) {
+  if (interval.a < 0 || interval.b < 0) {
+    return "";
+  }
+
+  size_t start = static_cast<size_t>(interval.a);
+  size_t stop = static_cast<size_t>(interval.b);
+  sync(stop);
+  if (start < _bufferStartIndex) {
+    throw UnsupportedOperationException("interval " + interval.toString() + " outside buffer: " +
+      std::to_string(_bufferStartIndex) + ".." + std::to_string(_bufferStartIndex + _data.size()));
+  }
+
+  stop = std::min(stop, _bufferStartIndex + _data.size() - 1);
+  if (start > stop || _data.empty()) {
+    return "";
+  }
+  auto maybeUtf8 = Utf8::strictEncode(std::u32string_view(_data).substr(start - _bufferStartIndex, stop - start + 1));
+  if (!maybeUtf8.has_value()) {
+    throw IllegalArgumentException("Input stream contains invalid Unicode code points");
+  }
+  return std::move(maybeUtf8).value();
+}
+
+std::string UnbufferedUtf8CharStream::toString() const {
+  return Utf8::lenientEncode(_data);
+}
+
+size_t UnbufferedUtf8CharStream::read(char *buffer, size_t size) {
+  if (_stream != nullptr) {
+    _stream->read(buffer, static_cast<std::streamsize>(size));
+    if (_stream->bad()) {
+      throw IOException("cannot read from the input stream");
+    }
+    return static_cast<size_t>(_stream->gcount());
+  }
+
+  while (true) {
+#ifdef _WIN32
+    int count = ::_read(_fd, buffer, static_cast<unsigned int>(std::min<size_t>(size, INT_MAX)));
+#else
+    ssize_t count = ::read(_fd, buffer, size);
+#endif
+    if (count >= 0) {
+      return static_cast<size_t>(count);
+    }
+    if (errno != EINTR) {
+      throw IOException("cannot read from file descriptor " + std::to_string(_fd));
+    }
+  }
+}
+
+void UnbufferedUtf8CharStream::sync(size_t index) {
+  while (index >= _bufferStartIndex + _data.size() && readBlock()) {
+  }
+}
+
+bool UnbufferedUtf8CharStream::readBlock() {
+  if (_atEnd) {
+    return false;
+  }
+
+  // Code points from the lowest position still needed on are kept, and the one before it for LA(-1).
+  size_t needed = _markers.empty() ? _currentCharIndex : std::min(_markers.back(), _currentCharIndex);
+  if (needed > _bufferStartIndex + 1) {
+    size_t discarded = std::min(needed - 1 - _bufferStartIndex, _data.size());
+    _data.erase(0, discarded);
+    _bufferStartIndex += discarded;
+  }
+
+  size_t count = read(_bytes.data() + _pendingBytes, _bytes.size() - 3);
+  size_t size = _pendingBytes + count;
+  size_t length = size;
+  if (count == 0) {
+    _atEnd = true; // An incomplete code point at the end is decoded as an illegal sequence.
+  } else {
+    length = completeLength(_bytes.data(), size);
+  }
+
+  std::string_view bytes(_bytes.data(), length);
+  if (_atStart && bytes.size() >= 3 && bytes.substr(0, 3) == "\xef\xbb\xbf") {
+    bytes.remove_prefix(3);
+  }
+  if (_atStart && (bytes.size() > 0 || length >= 3)) {
+    _atStart = false;
+  }
+
+  if (_lenient) {
+    _data += Utf8::lenientDecode(bytes);
+  } else {
+    auto decoded = Utf8::strictDecode(bytes);
+    if (!decoded.has_value()) {
+      throw IllegalArgumentException("UTF-8 string contains an illegal byte sequence");
+    }
+    _data += *decoded;
+  }
+
+  std::copy(_bytes.begin() + static_cast<ssize_t>(length), _bytes.begin() + static_cast<ssize_t>(size),
+            _bytes.begin());
+  _pendingBytes = size - length;
+  return true;
+}
@@ -0,0 +1,87 @@
+/* Copyright (c) 2012-2017 The ANTLR Project. All rights reserved.
+ * Use of this file is governed by the BSD 3-clause license that
+ * can be found in the LICENSE.txt file in the project root.
+ */
+
+#pragma once
+
+#include "CharStream.h"
+
+namespace antlr4 {
+
+  /// A char stream reading UTF-8 from a byte stream or a POSIX file descriptor, e.g. a pipe or a socket, without
+  /// buffering all of it. Bytes are read in blocks and each block is decoded at once; a code point split between
+  /// two blocks is completed with the next one. A leading UTF-8 BOM is skipped.
+  ///
+  /// Only the code points from the lowest position still needed on are kept: the current one, and that of the
+  /// oldest outstanding marker (the lexer marks the start of each token), plus one before it for LA(-1). The rest
+  /// is discarded when the next block is read, so memory use is bounded by the block size and the longest token.
+  /// (Lexer::nextTokens() marks the start of a whole batch, so token streams fetching in batches keep the text of
+  /// a batch, e.g. UnbufferedTokenStream fetches one token at a time.) As the text of old tokens is discarded, lexers
+  /// reading from this stream should copy the text into their tokens (see CommonTokenFactory(bool)).
+  class ANTLR4CPP_PUBLIC UnbufferedUtf8CharStream : public CharStream {
+  public:
+    /// The name or source of this char stream.
+    std::string name;
+
+    /// Reads from the given stream, which must stay valid as long as this one is used. If lenient is true, illegal
+    /// byte sequences are replaced with U+FFFD, otherwise reading them throws an IllegalArgumentException.
+    UnbufferedUtf8CharStream(std::istream &input, bool lenient = false, size_t blockSize = 64 * 1024);
+
+    /// Reads from the given file descriptor, which is not closed by this stream.
+    UnbufferedUtf8CharStream(int fd, bool lenient = false, size_t blockSize = 64 * 1024);
+
+    virtual void consume() override;
+    virtual size_t LA(ssize_t i) override;
+
+    /// Return a marker that we can release later. Code points from the current position on are kept until the
+    /// marker is released. Markers must be released in the reverse order of their creation.
+    virtual ssize_t mark() override;
+    virtual void release(ssize_t marker) override;
+
+    virtual size_t index() override;
+
+    /// Seek to absolute character index, which must be in the current window, or ahead of it.
+    virtual void seek(size_t index) override;
+
+    virtual size_t size() override;
+    virtual std::string getSourceName() const override;
+    virtual std::string getText(const misc::Interval &interval) override;
+
+    /// The text of the current window.
+    virtual std::string toString() const override;
+
+  protected:
+    /// Reads up to size bytes into buffer and returns how many were read, 0 at the end of the input. Override to
+    /// read from another source of bytes.
+    virtual size_t read(char *buffer, size_t size);
+
+  private:
+    std::istream *_stream = nullptr;
+    int _fd = -1;
+    bool _lenient;
+
+    /// The bytes of the last block, of which those of an incomplete code point at its end are kept for the next.
+    std::vector<char> _bytes;
+    size_t _pendingBytes = 0;
+    bool _atStart = true;
+    bool _atEnd = false;
+
+    /// The code points of the window, the first one at absolute index _bufferStartIndex.
+    std::u32string _data;
+    size_t _bufferStartIndex = 0;
+    size_t _currentCharIndex = 0;
+
+    /// For each outstanding marker, the lowest index the stream was at while it and the markers before it were
+    /// set (the low-water mark).
+    std::vector<size_t> _markers;
+
+    /// Reads blocks until the window has the code point with the given absolute index, or the input ended.
+    void sync(size_t index);
+
+    /// Reads and decodes the next block, after discarding the code points which are no longer needed. Returns
+    /// false at the end of the input.
+    bool readBlock();
+  };
+
+} // namespace antlr4
@@ -15,6 +15,7 @@
 #include "ANTLRInputStream.h"
 #include "BailErrorStrategy.h"
 #include "BaseErrorListener.h"
+#include "BatchParser.h"
 #include "BufferedTokenStream.h"
 #include "CharStream.h"
 #include "CommonToken.h"
@@ -25,6 +26,7 @@
 #include "DiagnosticErrorListener.h"
 #include "Exceptions.h"
 #include "FailedPredicateException.h"
+#include "IncrementalLexer.h"
 #include "InputMismatchException.h"
 #include "IntStream.h"
 #include "InterpreterRuleContext.h"
@@ -32,23 +34,29 @@
 #include "LexerInterpreter.h"
 #include "LexerNoViableAltException.h"
 #include "ListTokenSource.h"
+#include "MappedTokenSource.h"
 #include "NoViableAltException.h"
+#include "ParallelLexer.h"
 #include "Parser.h"
 #include "ParserInterpreter.h"
+#include "PipelinedTokenStream.h"
 #include "ParserRuleContext.h"
 #include "ProxyErrorListener.h"
 #include "RecognitionException.h"
 #include "Recognizer.h"
+#include "RecognizerPool.h"
 #include "RuleContext.h"
 #include "RuleContextWithAltNum.h"
 #include "RuntimeMetaData.h"
 #include "Token.h"
 #include "TokenFactory.h"
+#include "TokenFile.h"
 #include "TokenSource.h"
 #include "TokenStream.h"
 #include "TokenStreamRewriter.h"
 #include "UnbufferedCharStream.h"
 #include "UnbufferedTokenStream.h"
+#include "UnbufferedUtf8CharStream.h"
 #include "Vocabulary.h"
 #include "Vocabulary.h"
 #include "WritableToken.h"
@@ -60,6 +68,7 @@
 #include "atn/ATNSerializer.h"
 #include "atn/ATNSimulator.h"
 #include "atn/ATNState.h"
+#include "atn/ATNStatistics.h"
 #include "atn/ATNType.h"
 #include "atn/AbstractPredicateTransition.h"
 #include "atn/ActionTransition.h"
@@ -82,9 +91,14 @@
 #include "atn/LexerATNSimulator.h"
 #include "atn/LexerAction.h"
 #include "atn/LexerActionExecutor.h"
+#include "atn/LexerActionExecutorTable.h"
 #include "atn/LexerActionType.h"
 #include "atn/LexerChannelAction.h"
+#include "atn/LexerCharClasses.h"
+#include "atn/LexerKeywordTable.h"
 #include "atn/LexerCustomAction.h"
+#include "atn/LexerDFACompiler.h"
+#include "atn/LexerDFATableSimulator.h"
 #include "atn/LexerIndexedCustomAction.h"
 #include "atn/LexerModeAction.h"
 #include "atn/LexerMoreAction.h"
@@ -123,6 +137,7 @@
 #include "dfa/DFASerializer.h"
 #include "dfa/DFAState.h"
 #include "dfa/LexerDFASerializer.h"
+#include "dfa/LexerDFATable.h"
 #include "misc/InterpreterDataReader.h"
 #include "misc/Interval.h"
 #include "misc/IntervalSet.h"
@@ -6,6 +6,7 @@
 #pragma once
 
 #include "RuleContext.h"
+#include "atn/LexerActionExecutorTable.h"
 
 // GCC generates a warning when forward-declaring ATN if ATN has already been
 // declared due to the attributes added by ANTLR4CPP_PUBLIC.
@@ -60,6 +61,10 @@ namespace atn {
 
     std::vector<TokensStartState *> modeToStartState;
 
+    /// The lexer action executors used while lexing with this ATN. Filled lazily, it is not copied or moved with
+    /// the ATN.
+    mutable LexerActionExecutorTable lexerActionExecutors;
+
     ATN& operator = (ATN &other) noexcept;
     ATN& operator = (ATN &&other) noexcept;
 
@@ -181,7 +181,12 @@ bool ATNConfigSet::isReadonly() {
 
 void ATNConfigSet::setReadonly(bool readonly) {
   _readonly = readonly;
-  _configLookup.clear();
+
+  // Release the lookup buckets too, not just the entries. A readonly set lives as long as its DFA state.
+  std::unordered_map<size_t, ATNConfig *>().swap(_configLookup);
+  if (readonly) {
+    configs.shrink_to_fit();
+  }
 }
 
 std::string ATNConfigSet::toString() {
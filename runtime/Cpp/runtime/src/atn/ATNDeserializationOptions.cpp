@@ -25,7 +25,9 @@ void initializeDefaultATNDeserializationOptions() {
 
 ATNDeserializationOptions::ATNDeserializationOptions(ATNDeserializationOptions *options)
     : _readOnly(false), _verifyATN(options->_verifyATN),
-      _generateRuleBypassTransitions(options->_generateRuleBypassTransitions) {}
+      _generateRuleBypassTransitions(options->_generateRuleBypassTransitions),
+      _generateLL1Tables(options->_generateLL1Tables),
+      _generateLexerCharClasses(options->_generateLexerCharClasses) {}
 
 const ATNDeserializationOptions& ATNDeserializationOptions::getDefaultOptions() {
   std::call_once(defaultATNDeserializationOptionsOnceFlag,
@@ -47,6 +49,16 @@ void ATNDeserializationOptions::setGenerateRuleBypassTransitions(bool generate)
   _generateRuleBypassTransitions = generate;
 }
 
+void ATNDeserializationOptions::setGenerateLL1Tables(bool generate) {
+  throwIfReadOnly();
+  _generateLL1Tables = generate;
+}
+
+void ATNDeserializationOptions::setGenerateLexerCharClasses(bool generate) {
+  throwIfReadOnly();
+  _generateLexerCharClasses = generate;
+}
+
 void ATNDeserializationOptions::throwIfReadOnly() const {
   if (isReadOnly()) {
     throw IllegalStateException("ATNDeserializationOptions is read only.");
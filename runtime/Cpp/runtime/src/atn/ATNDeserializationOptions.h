@@ -13,7 +13,8 @@ namespace atn {
 class ANTLR4CPP_PUBLIC ATNDeserializationOptions final {
 public:
   ATNDeserializationOptions()
-    : _readOnly(false), _verifyATN(true), _generateRuleBypassTransitions(false) {}
+    : _readOnly(false), _verifyATN(true), _generateRuleBypassTransitions(false),
+      _generateLL1Tables(true), _generateLexerCharClasses(true) {}
 
   // TODO: Is this useful? If so we should mark it as explicit, otherwise remove it.
   ATNDeserializationOptions(ATNDeserializationOptions *options);
@@ -36,12 +37,28 @@ public:
 
   void setGenerateRuleBypassTransitions(bool generate);
 
+  /// Whether the deserializer determines which parser decisions are pure LL(1) and stores a
+  /// token type to alternative table for them in DecisionState::ll1Alts. The ParserATNSimulator
+  /// answers such decisions directly from the table, without any DFA or ATN simulation.
+  bool isGenerateLL1Tables() const { return _generateLL1Tables; }
+
+  void setGenerateLL1Tables(bool generate);
+
+  /// Whether the deserializer partitions the code points into the character classes each lexer mode can tell
+  /// apart (see TokensStartState::charClasses). The LexerATNSimulator then keys DFA edges beyond ASCII on the
+  /// class, so such input is matched by the DFA as well.
+  bool isGenerateLexerCharClasses() const { return _generateLexerCharClasses; }
+
+  void setGenerateLexerCharClasses(bool generate);
+
 private:
   void throwIfReadOnly() const;
 
   bool _readOnly;
   bool _verifyATN;
   bool _generateRuleBypassTransitions;
+  bool _generateLL1Tables;
+  bool _generateLexerCharClasses;
 };
 
 } // namespace atn
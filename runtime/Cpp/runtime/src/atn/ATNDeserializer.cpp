@@ -33,6 +33,7 @@
 #include "atn/SetTransition.h"
 #include "atn/NotSetTransition.h"
 #include "atn/WildcardTransition.h"
+#include "atn/LL1Analyzer.h"
 #include "Token.h"
 
 #include "misc/IntervalSet.h"
@@ -589,6 +590,16 @@ ATN ATNDeserializer::deserialize(const std::vector<uint16_t>& input) {
     }
   }
 
+  if (_deserializationOptions.isGenerateLL1Tables() && atn.grammarType == ATNType::PARSER) {
+    generateLL1Tables(atn);
+  }
+
+  if (_deserializationOptions.isGenerateLexerCharClasses() && atn.grammarType == ATNType::LEXER) {
+    for (size_t mode = 0; mode < atn.modeToStartState.size(); ++mode) {
+      atn.modeToStartState[mode]->charClasses = LexerCharClasses::forMode(atn, mode);
+    }
+  }
+
   return atn;
 }
 
@@ -620,6 +631,59 @@ void ATNDeserializer::markPrecedenceDecisions(const ATN &atn) const {
   }
 }
 
+/**
+ * Finds the decisions in the specified parser ATN which can be predicted from
+ * LA(1) alone and fills {@link DecisionState#ll1Alts} for them. A decision
+ * qualifies if the lookahead set of every alternative is known, does not
+ * depend on predicates or on what follows the rule (EPSILON), and the sets
+ * are pairwise disjoint. Precedence decisions never qualify, their outcome
+ * depends on the current precedence level.
+ *
+ * @param atn The ATN.
+ */
+void ATNDeserializer::generateLL1Tables(const ATN &atn) const {
+  LL1Analyzer analyzer(atn);
+  for (DecisionState *state : atn.decisionToState) {
+    state->ll1Alts.clear();
+    state->ll1Offset = 0;
+
+    if (state->transitions.size() > std::numeric_limits<uint16_t>::max()) {
+      continue;
+    }
+    if (is<StarLoopEntryState *>(state) && downCast<StarLoopEntryState *>(state)->isPrecedenceDecision) {
+      continue;
+    }
+
+    std::vector<misc::IntervalSet> lookahead = analyzer.getDecisionLookahead(state);
+    bool isLL1 = true;
+    misc::IntervalSet seen;
+    for (const misc::IntervalSet &set : lookahead) {
+      // getDecisionLookahead empties sets which hit a predicate.
+      if (set.isEmpty() || set.contains(Token::EPSILON) || !seen.And(set).isEmpty()) {
+        isLL1 = false;
+        break;
+      }
+      seen.addAll(set);
+    }
+    if (!isLL1) {
+      continue;
+    }
+
+    // Entries are token type + 1, EOF (-1) is stored at 0.
+    size_t minIndex = static_cast<size_t>(seen.getMinElement() + 1);
+    size_t maxIndex = static_cast<size_t>(seen.getMaxElement() + 1);
+    state->ll1Offset = minIndex;
+    state->ll1Alts.assign(maxIndex - minIndex + 1, static_cast<uint16_t>(ATN::INVALID_ALT_NUMBER));
+    for (size_t alt = 0; alt < lookahead.size(); ++alt) {
+      for (const misc::Interval &interval : lookahead[alt].getIntervals()) {
+        for (ssize_t t = interval.a; t <= interval.b; ++t) {
+          state->ll1Alts[static_cast<size_t>(t + 1) - minIndex] = static_cast<uint16_t>(alt + 1);
+        }
+      }
+    }
+  }
+}
+
 void ATNDeserializer::verifyATN(const ATN &atn) {
   // verify assumptions
   for (ATNState *state : atn.states) {
@@ -52,6 +52,7 @@ protected:
   /// introduced; otherwise, {@code false}. </returns>
   virtual bool isFeatureSupported(const antlrcpp::Guid &feature, const antlrcpp::Guid &actualUuid);
   void markPrecedenceDecisions(const ATN &atn) const;
+  void generateLL1Tables(const ATN &atn) const;
   Ref<LexerAction> lexerActionFactory(LexerActionType type, int data1, int data2) const;
 
 private:
@@ -0,0 +1,91 @@
+/* Copyright (c) 2012-2017 The ANTLR Project. All rights reserved.
+ * Use of this file is governed by the BSD 3-clause license that
+ * can be found in the LICENSE.txt file in the project root.
+ */
+
+#include "atn/ATNStatistics.h"
+
+using namespace antlr4::atn;
+
+namespace {
+
+  // The counters of one thread. Only the owning thread writes them (with a plain load/store pair rather than a
+  // locked read-modify-write), other threads read them in snapshot().
+  struct ThreadCounters;
+
+  struct Registry {
+    std::mutex mutex;
+    std::vector<ThreadCounters *> threads;
+    ATNStatistics::Counters retired; // Counts of threads which exited.
+  };
+
+  // Never destroyed, threads may still exit after static destruction started.
+  Registry& registry() {
+    static Registry *instance = new Registry();
+    return *instance;
+  }
+
+  struct ThreadCounters {
+    std::atomic<size_t> lexerMatchCalls { 0 };
+    std::atomic<size_t> predictionContextNodes { 0 };
+
+    ThreadCounters() {
+      Registry &r = registry();
+      std::lock_guard<std::mutex> lock(r.mutex);
+      r.threads.push_back(this);
+    }
+
+    ~ThreadCounters() {
+      Registry &r = registry();
+      std::lock_guard<std::mutex> lock(r.mutex);
+      r.retired.lexerMatchCalls += lexerMatchCalls.load(std::memory_order_relaxed);
+      r.retired.predictionContextNodes += predictionContextNodes.load(std::memory_order_relaxed);
+      r.threads.erase(std::find(r.threads.begin(), r.threads.end(), this));
+    }
+  };
+
+  ThreadCounters& threadCounters() {
+    thread_local ThreadCounters counters;
+    return counters;
+  }
+
+  void increment(std::atomic<size_t> &value) {
+    value.store(value.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+  }
+
+}
+
+std::atomic<bool> ATNStatistics::_enabled(false);
+
+void ATNStatistics::setEnabled(bool enabled) {
+  _enabled.store(enabled, std::memory_order_relaxed);
+}
+
+ATNStatistics::Counters ATNStatistics::snapshot() {
+  Registry &r = registry();
+  std::lock_guard<std::mutex> lock(r.mutex);
+  Counters result = r.retired;
+  for (ThreadCounters *counters : r.threads) {
+    result.lexerMatchCalls += counters->lexerMatchCalls.load(std::memory_order_relaxed);
+    result.predictionContextNodes += counters->predictionContextNodes.load(std::memory_order_relaxed);
+  }
+  return result;
+}
+
+void ATNStatistics::reset() {
+  Registry &r = registry();
+  std::lock_guard<std::mutex> lock(r.mutex);
+  r.retired = Counters();
+  for (ThreadCounters *counters : r.threads) {
+    counters->lexerMatchCalls.store(0, std::memory_order_relaxed);
+    counters->predictionContextNodes.store(0, std::memory_order_relaxed);
+  }
+}
+
+void ATNStatistics::incrementLexerMatches() {
+  increment(threadCounters().lexerMatchCalls);
+}
+
+void ATNStatistics::incrementPredictionContexts() {
+  increment(threadCounters().predictionContextNodes);
+}
@@ -0,0 +1,59 @@
+/* Copyright (c) 2012-2017 The ANTLR Project. All rights reserved.
+ * Use of this file is governed by the BSD 3-clause license that
+ * can be found in the LICENSE.txt file in the project root.
+ */
+
+#pragma once
+
+#include "antlr4-common.h"
+
+namespace antlr4 {
+namespace atn {
+
+  /// Opt-in counters of the work done by the ATN simulators, meant for diagnostics and benchmarks.
+  ///
+  /// Counting is disabled by default and then costs a single relaxed load per event. When enabled, every thread
+  /// counts into its own block, so recognizers running on different threads never write to a shared cache line.
+  /// The blocks of all threads, including threads which already exited, are summed up on demand by snapshot().
+  class ANTLR4CPP_PUBLIC ATNStatistics final {
+  public:
+    struct Counters {
+      /// Number of LexerATNSimulator::match() calls, i.e. tokens (including skipped ones) matched.
+      size_t lexerMatchCalls = 0;
+
+      /// Number of PredictionContext nodes created.
+      size_t predictionContextNodes = 0;
+    };
+
+    ATNStatistics() = delete;
+
+    static void setEnabled(bool enabled);
+    static bool isEnabled() { return _enabled.load(std::memory_order_relaxed); }
+
+    /// Returns the counters summed up over all threads.
+    static Counters snapshot();
+
+    /// Sets all counters back to 0. Counts made concurrently to this call may be lost.
+    static void reset();
+
+    static void countLexerMatch() {
+      if (isEnabled()) {
+        incrementLexerMatches();
+      }
+    }
+
+    static void countPredictionContext() {
+      if (isEnabled()) {
+        incrementPredictionContexts();
+      }
+    }
+
+  private:
+    static std::atomic<bool> _enabled;
+
+    static void incrementLexerMatches();
+    static void incrementPredictionContexts();
+  };
+
+} // namespace atn
+} // namespace antlr4
@@ -3,6 +3,8 @@
  * can be found in the LICENSE.txt file in the project root.
  */
 
+#include "atn/ATN.h"
+
 #include "atn/DecisionState.h"
 
 using namespace antlr4::atn;
@@ -10,6 +12,16 @@ using namespace antlr4::atn;
 void DecisionState::InitializeInstanceFields() {
   decision = -1;
   nonGreedy = false;
+  ll1Offset = 0;
+}
+
+size_t DecisionState::getLL1Alt(size_t tokenType) const {
+  // Token types below the offset wrap around and fail the bounds check.
+  size_t index = tokenType + 1 - ll1Offset;
+  if (index < ll1Alts.size()) {
+    return ll1Alts[index];
+  }
+  return ATN::INVALID_ALT_NUMBER;
 }
 
 std::string DecisionState::toString() const {
@@ -15,6 +15,12 @@ namespace atn {
     int decision;
     bool nonGreedy;
 
+    /// For decisions which are pure LL(1) this maps LA(1) to the predicted alternative, offset by
+    /// {@link #ll1Offset} (token type + 1, so EOF fits). Empty for every other decision.
+    /// Filled by the ATNDeserializer, see ATNDeserializationOptions::isGenerateLL1Tables.
+    std::vector<uint16_t> ll1Alts;
+    size_t ll1Offset;
+
   private:
     void InitializeInstanceFields();
 
@@ -23,6 +29,10 @@ namespace atn {
       InitializeInstanceFields();
     }
 
+    /// Returns the alternative selected by {@code tokenType} if this decision is LL(1) and the token
+    /// type starts one of its alternatives, otherwise ATN::INVALID_ALT_NUMBER.
+    size_t getLL1Alt(size_t tokenType) const;
+
     virtual std::string toString() const override;
   };
 
@@ -17,11 +17,12 @@ using namespace antlr4::atn;
 using namespace antlrcpp;
 
 LexerATNConfig::LexerATNConfig(ATNState *state, int alt, Ref<PredictionContext> const& context)
-  : ATNConfig(state, alt, context, SemanticContext::NONE), _passedThroughNonGreedyDecision(false) {
+  : ATNConfig(state, alt, context, SemanticContext::NONE), _lexerActionExecutor(nullptr),
+    _passedThroughNonGreedyDecision(false) {
 }
 
 LexerATNConfig::LexerATNConfig(ATNState *state, int alt, Ref<PredictionContext> const& context,
-                               Ref<LexerActionExecutor> const& lexerActionExecutor)
+                               LexerActionExecutor *lexerActionExecutor)
   : ATNConfig(state, alt, context, SemanticContext::NONE), _lexerActionExecutor(lexerActionExecutor),
     _passedThroughNonGreedyDecision(false) {
 }
@@ -31,7 +32,7 @@ LexerATNConfig::LexerATNConfig(Ref<LexerATNConfig> const& c, ATNState *state)
    _passedThroughNonGreedyDecision(checkNonGreedyDecision(c, state)) {
 }
 
-LexerATNConfig::LexerATNConfig(Ref<LexerATNConfig> const& c, ATNState *state, Ref<LexerActionExecutor> const& lexerActionExecutor)
+LexerATNConfig::LexerATNConfig(Ref<LexerATNConfig> const& c, ATNState *state, LexerActionExecutor *lexerActionExecutor)
   : ATNConfig(c, state, c->context, c->semanticContext), _lexerActionExecutor(lexerActionExecutor),
     _passedThroughNonGreedyDecision(checkNonGreedyDecision(c, state)) {
 }
@@ -41,7 +42,7 @@ LexerATNConfig::LexerATNConfig(Ref<LexerATNConfig> const& c, ATNState *state, Re
     _passedThroughNonGreedyDecision(checkNonGreedyDecision(c, state)) {
 }
 
-Ref<LexerActionExecutor> LexerATNConfig::getLexerActionExecutor() const {
+LexerActionExecutor *LexerATNConfig::getLexerActionExecutor() const {
   return _lexerActionExecutor;
 }
 
@@ -69,10 +70,12 @@ bool LexerATNConfig::operator == (const LexerATNConfig& other) const
   if (_passedThroughNonGreedyDecision != other._passedThroughNonGreedyDecision)
     return false;
 
-  if (_lexerActionExecutor == nullptr)
-    return other._lexerActionExecutor == nullptr;
-  if (*_lexerActionExecutor != *(other._lexerActionExecutor)) {
-    return false;
+  // Interned executors are equal if they are the same.
+  if (_lexerActionExecutor != other._lexerActionExecutor) {
+    if (_lexerActionExecutor == nullptr || other._lexerActionExecutor == nullptr ||
+        *_lexerActionExecutor != *(other._lexerActionExecutor)) {
+      return false;
+    }
   }
 
   return ATNConfig::operator == (other);
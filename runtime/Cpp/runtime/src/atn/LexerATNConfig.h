@@ -13,17 +13,20 @@ namespace atn {
   class ANTLR4CPP_PUBLIC LexerATNConfig : public ATNConfig {
   public:
     LexerATNConfig(ATNState *state, int alt, Ref<PredictionContext> const& context);
-    LexerATNConfig(ATNState *state, int alt, Ref<PredictionContext> const& context, Ref<LexerActionExecutor> const& lexerActionExecutor);
+    LexerATNConfig(ATNState *state, int alt, Ref<PredictionContext> const& context, LexerActionExecutor *lexerActionExecutor);
 
     LexerATNConfig(Ref<LexerATNConfig> const& c, ATNState *state);
-    LexerATNConfig(Ref<LexerATNConfig> const& c, ATNState *state, Ref<LexerActionExecutor> const& lexerActionExecutor);
+    LexerATNConfig(Ref<LexerATNConfig> const& c, ATNState *state, LexerActionExecutor *lexerActionExecutor);
     LexerATNConfig(Ref<LexerATNConfig> const& c, ATNState *state, Ref<PredictionContext> const& context);
 
     /**
      * Gets the {@link LexerActionExecutor} capable of executing the embedded
      * action(s) for the current configuration.
+     *
+     * Configurations don't own their executor, the lexer ATN simulator uses
+     * the ones interned in ATN::lexerActionExecutors.
      */
-    Ref<LexerActionExecutor> getLexerActionExecutor() const;
+    LexerActionExecutor *getLexerActionExecutor() const;
     bool hasPassedThroughNonGreedyDecision();
 
     virtual size_t hashCode() const override;
@@ -34,7 +37,7 @@ namespace atn {
     /**
      * This is the backing field for {@link #getLexerActionExecutor}.
      */
-    const Ref<LexerActionExecutor> _lexerActionExecutor;
+    LexerActionExecutor *const _lexerActionExecutor;
     const bool _passedThroughNonGreedyDecision;
 
     static bool checkNonGreedyDecision(Ref<LexerATNConfig> const& source, ATNState *target);
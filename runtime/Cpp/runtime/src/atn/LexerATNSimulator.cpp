@@ -20,7 +20,10 @@
 #include "dfa/DFAState.h"
 #include "atn/LexerATNConfig.h"
 #include "atn/LexerActionExecutor.h"
+#include "atn/LexerChannelAction.h"
 #include "atn/EmptyPredictionContext.h"
+#include "atn/ATNStatistics.h"
+#include "support/Utf8.h"
 
 #include "atn/LexerATNSimulator.h"
 
@@ -31,6 +34,33 @@ using namespace antlr4;
 using namespace antlr4::atn;
 using namespace antlrcpp;
 
+namespace {
+
+  // Marks accept states whose actions all skip or all set the channel, so the simulator can handle them without
+  // executing the actions.
+  void classifyActions(dfa::DFAState *state) {
+    std::vector<Ref<LexerAction>> actions = state->lexerActionExecutor->getLexerActions();
+    size_t skips = 0;
+    size_t channel = INVALID_INDEX;
+    for (const Ref<LexerAction> &action : actions) {
+      if (action->getActionType() == LexerActionType::SKIP) {
+        ++skips;
+      } else if (action->getActionType() == LexerActionType::CHANNEL) {
+        channel = std::static_pointer_cast<LexerChannelAction>(action)->getChannel();
+      } else {
+        return;
+      }
+    }
+
+    if (skips == actions.size()) {
+      state->isLexerSkip = true;
+    } else if (skips == 0) {
+      state->lexerChannel = channel;
+    }
+  }
+
+}
+
 LexerATNSimulator::SimState::~SimState() {
 }
 
@@ -47,9 +77,6 @@ void LexerATNSimulator::SimState::InitializeInstanceFields() {
   charPos = INVALID_INDEX;
 }
 
-std::atomic<int> LexerATNSimulator::match_calls(0);
-
-
 LexerATNSimulator::LexerATNSimulator(const ATN &atn, std::vector<dfa::DFA> &decisionToDFA,
                                      PredictionContextCache &sharedContextCache)
   : LexerATNSimulator(nullptr, atn, decisionToDFA, sharedContextCache) {
@@ -64,12 +91,13 @@ LexerATNSimulator::LexerATNSimulator(Lexer *recog, const ATN &atn, std::vector<d
 void LexerATNSimulator::copyState(LexerATNSimulator *simulator) {
   _charPositionInLine = simulator->_charPositionInLine;
   _line = simulator->_line;
+  _lookaheadEnd = simulator->_lookaheadEnd;
   _mode = simulator->_mode;
   _startIndex = simulator->_startIndex;
 }
 
 size_t LexerATNSimulator::match(CharStream *input, size_t mode) {
-  match_calls.fetch_add(1, std::memory_order_relaxed);
+  ATNStatistics::countLexerMatch();
   _mode = mode;
   ssize_t mark = input->mark();
 
@@ -95,6 +123,7 @@ void LexerATNSimulator::reset() {
   _startIndex = 0;
   _line = 1;
   _charPositionInLine = 0;
+  _lookaheadEnd = 0;
   _mode = Lexer::DEFAULT_MODE;
 }
 
@@ -122,68 +151,173 @@ size_t LexerATNSimulator::matchATN(CharStream *input) {
 }
 
 size_t LexerATNSimulator::execATN(CharStream *input, dfa::DFAState *ds0) {
-  if (ds0->isAcceptState) {
-    // allow zero-length tokens
-    // ml: in Java code this method uses 3 params. The first is a member var of the class anyway (_prevAccept), so why pass it here?
-    captureSimState(input, ds0);
-  }
-
-  size_t t = input->LA(1);
-  dfa::DFAState *s = ds0; // s is current/from DFA state
-
-  while (true) { // while more work
-    // As we move src->trg, src->trg, we keep track of the previous trg to
-    // avoid looking up the DFA state again, which is expensive.
-    // If the previous target was already part of the DFA, we might
-    // be able to avoid doing a reach operation upon t. If s!=null,
-    // it means that semantic predicates didn't prevent us from
-    // creating a DFA state. Once we know s!=null, we check to see if
-    // the DFA state has an edge already for t. If so, we can just reuse
-    // it's configuration set; there's no point in re-computing it.
-    // This is kind of like doing DFA simulation within the ATN
-    // simulation because DFA simulation is really just a way to avoid
-    // computing reach/closure sets. Technically, once we know that
-    // we have a previously added DFA state, we could jump over to
-    // the DFA simulator. But, that would mean popping back and forth
-    // a lot and making things more complicated algorithmically.
-    // This optimization makes a lot of sense for loops within DFA.
-    // A character will take us back to an existing DFA state
-    // that already has lots of edges out of it. e.g., .* in comments.
-    dfa::DFAState *target = getExistingTargetState(s, t);
-    if (target == nullptr) {
-      target = computeTargetState(input, s, t);
+  size_t size = 0;
+  const char32_t *data = input->getContiguousData(size);
+  if (data != nullptr) {
+    return execContiguous(input, ds0, data, size);
+  }
+
+  while (true) {
+    if (ds0->isAcceptState) {
+      // allow zero-length tokens
+      // ml: in Java code this method uses 3 params. The first is a member var of the class anyway (_prevAccept), so why pass it here?
+      captureSimState(input, ds0);
     }
 
-    if (target == ERROR.get()) {
-      break;
+    size_t t = input->LA(1);
+    dfa::DFAState *s = ds0; // s is current/from DFA state
+
+    while (true) { // while more work
+      // As we move src->trg, src->trg, we keep track of the previous trg to
+      // avoid looking up the DFA state again, which is expensive.
+      // If the previous target was already part of the DFA, we might
+      // be able to avoid doing a reach operation upon t. If s!=null,
+      // it means that semantic predicates didn't prevent us from
+      // creating a DFA state. Once we know s!=null, we check to see if
+      // the DFA state has an edge already for t. If so, we can just reuse
+      // it's configuration set; there's no point in re-computing it.
+      // This is kind of like doing DFA simulation within the ATN
+      // simulation because DFA simulation is really just a way to avoid
+      // computing reach/closure sets. Technically, once we know that
+      // we have a previously added DFA state, we could jump over to
+      // the DFA simulator. But, that would mean popping back and forth
+      // a lot and making things more complicated algorithmically.
+      // This optimization makes a lot of sense for loops within DFA.
+      // A character will take us back to an existing DFA state
+      // that already has lots of edges out of it. e.g., .* in comments.
+      dfa::DFAState *target = getExistingTargetState(s, t);
+      if (target == nullptr) {
+        target = computeTargetState(input, s, t);
+      }
+
+      if (target == ERROR.get()) {
+        break;
+      }
+
+      // If this is a consumable input element, make sure to consume before
+      // capturing the accept state so the input index, line, and char
+      // position accurately reflect the state of the interpreter at the
+      // end of the token.
+      if (t != Token::EOF) {
+        consume(input);
+      }
+
+      if (target->isAcceptState) {
+        captureSimState(input, target);
+        if (t == Token::EOF) {
+          break;
+        }
+      }
+
+      t = input->LA(1);
+      s = target; // flip; current DFA target becomes new src/from state
     }
 
-    // If this is a consumable input element, make sure to consume before
-    // capturing the accept state so the input index, line, and char
-    // position accurately reflect the state of the interpreter at the
-    // end of the token.
-    if (t != Token::EOF) {
-      consume(input);
+    _lookaheadEnd = std::max(_lookaheadEnd, input->index() + 1);
+    ds0 = skipToken(input);
+    if (ds0 == nullptr) {
+      return failOrAccept(input, s->configs.get(), t);
     }
+  }
+}
+
+size_t LexerATNSimulator::execContiguous(CharStream *input, dfa::DFAState *ds0, const char32_t *data, size_t size) {
+  while (true) {
+    size_t index = input->index();
+    if (ds0->isAcceptState) {
+      captureSimState(input, ds0);
+    }
+
+    // Line and column are not updated per character: they are valid at linePosition and brought forward in bulk
+    // when needed, i.e. before predicates may read them and at the end. The same goes for the position of the last
+    // accept state passed.
+    size_t linePosition = index;
+    bool acceptPending = false;
+    auto syncPosition = [&]() {
+      if (acceptPending) {
+        advancePosition(data, linePosition, _prevAccept.index, _line, _charPositionInLine);
+        linePosition = _prevAccept.index;
+        _prevAccept.line = _line;
+        _prevAccept.charPos = _charPositionInLine;
+        acceptPending = false;
+      }
+      advancePosition(data, linePosition, index, _line, _charPositionInLine);
+      linePosition = index;
+    };
+
+    size_t t = index < size ? static_cast<size_t>(data[index]) : Token::EOF;
+    dfa::DFAState *s = ds0;
+
+    while (true) {
+      dfa::DFAState *target = getExistingTargetState(s, t);
+      if (target == nullptr) {
+        // Predicates evaluated while computing the target may look at the stream and the position.
+        syncPosition();
+        input->seek(index);
+        target = computeTargetState(input, s, t);
+      }
 
-    if (target->isAcceptState) {
-      captureSimState(input, target);
-      if (t == Token::EOF) {
+      if (target == ERROR.get()) {
         break;
       }
+
+      if (t != Token::EOF) {
+        ++index;
+      }
+
+      if (target->isAcceptState) {
+        _prevAccept.index = index;
+        _prevAccept.dfaState = target;
+        acceptPending = true;
+        if (t == Token::EOF) {
+          break;
+        }
+      }
+
+      t = index < size ? static_cast<size_t>(data[index]) : Token::EOF;
+      s = target;
+    }
+
+    syncPosition();
+    input->seek(index);
+    _lookaheadEnd = std::max(_lookaheadEnd, index + 1);
+    ds0 = skipToken(input);
+    if (ds0 == nullptr) {
+      return failOrAccept(input, s->configs.get(), t);
     }
+  }
+}
+
+void LexerATNSimulator::advancePosition(const char32_t *data, size_t from, size_t to, size_t &line, size_t &charPos) {
+  // Branch free, so the compiler can vectorize the scan. Long tokens like comments cost a pass over their text,
+  // instead of a branch per character.
+  size_t newlines = 0;
+  for (size_t i = from; i < to; ++i) {
+    newlines += data[i] == U'\n' ? 1 : 0;
+  }
 
-    t = input->LA(1);
-    s = target; // flip; current DFA target becomes new src/from state
+  if (newlines == 0) {
+    charPos += to - from;
+    return;
   }
 
-  return failOrAccept(input, s->configs.get(), t);
+  line += newlines;
+  size_t lastNewline = to - 1;
+  while (data[lastNewline] != U'\n') {
+    --lastNewline;
+  }
+  charPos = to - lastNewline - 1;
 }
 
 dfa::DFAState *LexerATNSimulator::getExistingTargetState(dfa::DFAState *s, size_t t) {
   dfa::DFAState* retval = nullptr;
   _edgeLock.lock_shared();
-  if (t <= MAX_DFA_EDGE) {
+  if (t > MAX_DFA_EDGE) {
+    size_t charClass = atn.modeToStartState[_mode]->charClasses.getClass(t);
+    if (charClass < s->denseEdges.size()) {
+      retval = s->denseEdges[charClass];
+    }
+  } else {
     auto iterator = s->edges.find(t - MIN_DFA_EDGE);
 #if DEBUG_ATN == 1
     if (iterator != s->edges.end()) {
@@ -223,8 +357,18 @@ dfa::DFAState *LexerATNSimulator::computeTargetState(CharStream *input, dfa::DFA
 
 size_t LexerATNSimulator::failOrAccept(CharStream *input, ATNConfigSet *reach, size_t t) {
   if (_prevAccept.dfaState != nullptr) {
-    Ref<LexerActionExecutor> lexerActionExecutor = _prevAccept.dfaState->lexerActionExecutor;
-    accept(input, lexerActionExecutor, _startIndex, _prevAccept.index, _prevAccept.line, _prevAccept.charPos);
+    if (_prevAccept.dfaState->lexerChannel != INVALID_INDEX && _recog != nullptr && _recog->isInlineSkipAndChannel()) {
+      accept(input, nullptr, _startIndex, _prevAccept.index, _prevAccept.line, _prevAccept.charPos);
+      _recog->channel = _prevAccept.dfaState->lexerChannel;
+    } else {
+      Ref<LexerActionExecutor> lexerActionExecutor = _prevAccept.dfaState->lexerActionExecutor;
+      accept(input, lexerActionExecutor, _startIndex, _prevAccept.index, _prevAccept.line, _prevAccept.charPos);
+    }
+
+    const LexerKeywordTable &keywords = atn.modeToStartState[_mode]->keywords;
+    if (_prevAccept.dfaState->prediction == keywords.getIdentifierType()) {
+      return getKeywordType(input, keywords);
+    }
     return _prevAccept.dfaState->prediction;
   } else {
     // if no accept and EOF is first char, return EOF
@@ -236,6 +380,50 @@ size_t LexerATNSimulator::failOrAccept(CharStream *input, ATNConfigSet *reach, s
   }
 }
 
+size_t LexerATNSimulator::getKeywordType(CharStream *input, const LexerKeywordTable &keywords) {
+  size_t type = Token::INVALID_TYPE;
+  size_t size = 0;
+  const char32_t *data = input->getContiguousData(size);
+  if (data != nullptr) {
+    type = keywords.getType(data + _startIndex, _prevAccept.index - _startIndex);
+  } else {
+    misc::Interval interval(_startIndex, _prevAccept.index - 1);
+    std::u32string text = antlrcpp::Utf8::lenientDecode(input->getText(interval));
+    type = keywords.getType(text.data(), text.size());
+  }
+  return type != Token::INVALID_TYPE ? type : keywords.getIdentifierType();
+}
+
+dfa::DFAState *LexerATNSimulator::skipToken(CharStream *input) {
+  if (_prevAccept.dfaState == nullptr || !_prevAccept.dfaState->isLexerSkip || _recog == nullptr ||
+      !_recog->isInlineSkipAndChannel() || _recog->tokenStartCharIndex != _startIndex ||
+      _prevAccept.index == _startIndex) {
+    return nullptr;
+  }
+
+  accept(input, nullptr, _startIndex, _prevAccept.index, _prevAccept.line, _prevAccept.charPos);
+  if (input->LA(1) == Token::EOF) {
+    return nullptr; // The lexer has to see the skip to emit EOF.
+  }
+
+  _stateLock.lock_shared();
+  dfa::DFAState *s0 = _decisionToDFA[_mode].s0;
+  _stateLock.unlock_shared();
+  if (s0 == nullptr) {
+    return nullptr;
+  }
+
+  // What Lexer::nextToken() does at the start of each token. Everything else is still in its initial state,
+  // as no action was executed.
+  ATNStatistics::countLexerMatch();
+  _startIndex = input->index();
+  _prevAccept.reset();
+  _recog->tokenStartCharIndex = _startIndex;
+  _recog->tokenStartLine = _line;
+  _recog->tokenStartCharPositionInLine = _charPositionInLine;
+  return s0;
+}
+
 void LexerATNSimulator::getReachableConfigSet(CharStream *input, ATNConfigSet *closure_, ATNConfigSet *reach, size_t t) {
   // this is used to skip processing for configs which have a lower priority
   // than a config that already reached an accept state for the same rule
@@ -243,7 +431,8 @@ void LexerATNSimulator::getReachableConfigSet(CharStream *input, ATNConfigSet *c
 
   for (const auto &c : closure_->configs) {
     bool currentAltReachedAcceptState = c->alt == skipAlt;
-    if (currentAltReachedAcceptState && (std::static_pointer_cast<LexerATNConfig>(c))->hasPassedThroughNonGreedyDecision()) {
+    LexerATNConfig *lexerConfig = static_cast<LexerATNConfig *>(c.get());
+    if (currentAltReachedAcceptState && lexerConfig->hasPassedThroughNonGreedyDecision()) {
       continue;
     }
 
@@ -256,9 +445,10 @@ void LexerATNSimulator::getReachableConfigSet(CharStream *input, ATNConfigSet *c
       Transition *trans = c->state->transitions[ti];
       ATNState *target = getReachableTarget(trans, (int)t);
       if (target != nullptr) {
-        Ref<LexerActionExecutor> lexerActionExecutor = std::static_pointer_cast<LexerATNConfig>(c)->getLexerActionExecutor();
-        if (lexerActionExecutor != nullptr) {
-          lexerActionExecutor = lexerActionExecutor->fixOffsetBeforeMatch((int)input->index() - (int)_startIndex);
+        LexerActionExecutor *lexerActionExecutor = lexerConfig->getLexerActionExecutor();
+        if (lexerActionExecutor != nullptr && lexerActionExecutor->hasUnfixedOffsets()) {
+          lexerActionExecutor = atn.lexerActionExecutors.fixOffsetBeforeMatch(lexerActionExecutor,
+            (int)input->index() - (int)_startIndex);
         }
 
         bool treatEofAsEpsilon = t == Token::EOF;
@@ -304,8 +494,12 @@ atn::ATNState *LexerATNSimulator::getReachableTarget(Transition *trans, size_t t
 std::unique_ptr<ATNConfigSet> LexerATNSimulator::computeStartState(CharStream *input, ATNState *p) {
   Ref<PredictionContext> initialContext = PredictionContext::EMPTY; // ml: the purpose of this assignment is unclear
   std::unique_ptr<ATNConfigSet> configs(new OrderedATNConfigSet());
+  const LexerKeywordTable &keywords = atn.modeToStartState[_mode]->keywords;
   for (size_t i = 0; i < p->transitions.size(); i++) {
     ATNState *target = p->transitions[i]->target;
+    if (keywords.isKeywordRule(target->ruleIndex)) {
+      continue; // Matched by the identifier rule.
+    }
     Ref<LexerATNConfig> c = std::make_shared<LexerATNConfig>(target, (int)(i + 1), initialContext);
     closure(input, c, configs.get(), false, false, false);
   }
@@ -432,7 +626,7 @@ Ref<LexerATNConfig> LexerATNSimulator::getEpsilonTarget(CharStream *input, const
         // getEpsilonTarget to return two configurations, so
         // additional modifications are needed before we can support
         // the split operation.
-        Ref<LexerActionExecutor> lexerActionExecutor = LexerActionExecutor::append(config->getLexerActionExecutor(),
+        LexerActionExecutor *lexerActionExecutor = atn.lexerActionExecutors.append(config->getLexerActionExecutor(),
           atn.lexerActions[static_cast<ActionTransition *>(t)->actionIndex]);
         c = std::make_shared<LexerATNConfig>(config, t->target, lexerActionExecutor);
         break;
@@ -525,8 +719,20 @@ dfa::DFAState *LexerATNSimulator::addDFAEdge(dfa::DFAState *from, size_t t, ATNC
 }
 
 void LexerATNSimulator::addDFAEdge(dfa::DFAState *p, size_t t, dfa::DFAState *q) {
-  if (/*t < MIN_DFA_EDGE ||*/ t > MAX_DFA_EDGE) { // MIN_DFA_EDGE is 0
-    // Only track edges within the DFA bounds
+  // ASCII edges are keyed on the code point. Beyond that, edges are keyed on the character class of t, if the
+  // mode has classes. Then there is one edge array entry per class, which covers all its code points above ASCII.
+  if (t > MAX_DFA_EDGE) {
+    size_t charClass = atn.modeToStartState[_mode]->charClasses.getClass(t);
+    if (charClass == INVALID_INDEX) { // EOF, or the mode has no classes
+      return;
+    }
+
+    _edgeLock.lock();
+    if (p->denseEdges.empty()) {
+      p->denseEdges.resize(atn.modeToStartState[_mode]->charClasses.size(), nullptr);
+    }
+    p->denseEdges[charClass] = q; // connect
+    _edgeLock.unlock();
     return;
   }
 
@@ -556,7 +762,11 @@ dfa::DFAState *LexerATNSimulator::addDFAState(ATNConfigSet *configs, bool suppre
 
   if (firstConfigWithRuleStopState != nullptr) {
     proposed->isAcceptState = true;
-    proposed->lexerActionExecutor = std::dynamic_pointer_cast<LexerATNConfig>(firstConfigWithRuleStopState)->getLexerActionExecutor();
+    LexerActionExecutor *lexerActionExecutor =
+      static_cast<LexerATNConfig *>(firstConfigWithRuleStopState.get())->getLexerActionExecutor();
+    if (lexerActionExecutor != nullptr) {
+      proposed->lexerActionExecutor = lexerActionExecutor->shared_from_this();
+    }
     proposed->prediction = atn.ruleToTokenType[firstConfigWithRuleStopState->state->ruleIndex];
   }
 
@@ -577,6 +787,9 @@ dfa::DFAState *LexerATNSimulator::addDFAState(ATNConfigSet *configs, bool suppre
 
   proposed->stateNumber = (int)dfa.states.size();
   proposed->configs->setReadonly(true);
+  if (proposed->lexerActionExecutor != nullptr) {
+    classifyActions(proposed);
+  }
 
   dfa.states.insert(proposed);
   if (!suppressEdge) {
@@ -612,6 +825,14 @@ void LexerATNSimulator::setCharPositionInLine(size_t charPositionInLine) {
   _charPositionInLine = charPositionInLine;
 }
 
+size_t LexerATNSimulator::getLookaheadEnd() const {
+  return _lookaheadEnd;
+}
+
+void LexerATNSimulator::setLookaheadEnd(size_t lookaheadEnd) {
+  _lookaheadEnd = lookaheadEnd;
+}
+
 void LexerATNSimulator::consume(CharStream *input) {
   size_t curChar = input->LA(1);
   if (curChar == '\n') {
@@ -634,5 +855,6 @@ void LexerATNSimulator::InitializeInstanceFields() {
   _startIndex = 0;
   _line = 1;
   _charPositionInLine = 0;
+  _lookaheadEnd = 0;
   _mode = antlr4::Lexer::DEFAULT_MODE;
 }
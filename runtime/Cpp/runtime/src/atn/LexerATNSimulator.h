@@ -5,8 +5,6 @@
 
 #pragma once
 
-#include <atomic>
-
 #include "atn/ATNSimulator.h"
 #include "atn/LexerATNConfig.h"
 #include "atn/ATNConfigSet.h"
@@ -41,7 +39,7 @@ namespace atn {
 
   public:
     static constexpr size_t MIN_DFA_EDGE = 0;
-    static constexpr size_t MAX_DFA_EDGE = 127; // forces unicode to stay in ATN
+    static constexpr size_t MAX_DFA_EDGE = 127; // Beyond this, edges are keyed on TokensStartState::charClasses.
 
   protected:
     /// <summary>
@@ -74,6 +72,9 @@ namespace atn {
     /// The index of the character relative to the beginning of the line 0..n-1.
     size_t _charPositionInLine;
 
+    /// The index after the last character the simulator looked at, see getLookaheadEnd().
+    size_t _lookaheadEnd;
+
   public:
     std::vector<dfa::DFA> &_decisionToDFA;
 
@@ -84,8 +85,6 @@ namespace atn {
     SimState _prevAccept;
 
   public:
-    static std::atomic<int> match_calls;
-
     LexerATNSimulator(const ATN &atn, std::vector<dfa::DFA> &decisionToDFA, PredictionContextCache &sharedContextCache);
     LexerATNSimulator(Lexer *recog, const ATN &atn, std::vector<dfa::DFA> &decisionToDFA, PredictionContextCache &sharedContextCache);
     virtual ~LexerATNSimulator () {}
@@ -100,6 +99,16 @@ namespace atn {
     virtual size_t matchATN(CharStream *input);
     virtual size_t execATN(CharStream *input, dfa::DFAState *ds0);
 
+    /// execATN() for streams with contiguous data (see CharStream::getContiguousData()): characters are read from
+    /// the buffer, without the virtual calls of LA(), consume() and index(), and line and column are computed in
+    /// bulk with advancePosition(). The stream is only positioned when the ATN must be simulated and when the
+    /// token is accepted.
+    virtual size_t execContiguous(CharStream *input, dfa::DFAState *ds0, const char32_t *data, size_t size);
+
+    /// Moves {@code line} and {@code charPos} from position {@code from} in {@code data} to position {@code to},
+    /// the same as consume() would for each character in between.
+    static void advancePosition(const char32_t *data, size_t from, size_t to, size_t &line, size_t &charPos);
+
     /// <summary>
     /// Get an existing target state for an edge in the DFA. If the target state
     /// for the edge has not yet been computed or is otherwise not available,
@@ -127,6 +136,17 @@ namespace atn {
 
     virtual size_t failOrAccept(CharStream *input, ATNConfigSet *reach, size_t t);
 
+    /// Called before failOrAccept(): if the lexer inlines skips (see Lexer::setInlineSkipAndChannel()), the last
+    /// accept state passed only skips (see DFAState::isLexerSkip), the token is the first one of the current
+    /// lexer token (it does not follow more()) and more input follows, the lexer is moved to the start of the
+    /// next token. Returns the DFA state to continue matching from then,
+    /// otherwise null and the token is accepted as usual.
+    virtual dfa::DFAState *skipToken(CharStream *input);
+
+    /// Looks up the text of the accepted identifier in the mode's keywords, returning the keyword's token type
+    /// or the identifier type if it is none.
+    size_t getKeywordType(CharStream *input, const LexerKeywordTable &keywords);
+
     /// <summary>
     /// Given a starting configuration set, figure out all ATN configurations
     ///  we can reach upon input {@code t}. Parameter {@code reach} is a return
@@ -203,6 +223,14 @@ namespace atn {
     virtual void setLine(size_t line);
     virtual size_t getCharPositionInLine();
     virtual void setCharPositionInLine(size_t charPositionInLine);
+
+    /// The index after the furthest character (or EOF, at the input size) the DFA/ATN simulation looked at to
+    /// match tokens since the value was last set, i.e. the tokens matched depend on the input before that index
+    /// only, unless predicates look further. Used to find the tokens an edit of the input affects
+    /// (see IncrementalLexer).
+    virtual size_t getLookaheadEnd() const;
+    virtual void setLookaheadEnd(size_t lookaheadEnd);
+
     virtual void consume(CharStream *input);
     virtual std::string getTokenName(size_t t);
 
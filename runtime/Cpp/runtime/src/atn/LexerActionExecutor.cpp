@@ -16,7 +16,10 @@ using namespace antlr4::misc;
 using namespace antlrcpp;
 
 LexerActionExecutor::LexerActionExecutor(const std::vector<Ref<LexerAction>> &lexerActions)
-  : _lexerActions(lexerActions), _hashCode(generateHashCode()) {
+  : _lexerActions(lexerActions), _hashCode(generateHashCode()),
+    _hasUnfixedOffsets(std::any_of(lexerActions.begin(), lexerActions.end(), [](const Ref<LexerAction> &action) {
+      return action->isPositionDependent() && !is<LexerIndexedCustomAction>(action);
+    })) {
 }
 
 LexerActionExecutor::~LexerActionExecutor() {
@@ -34,6 +37,10 @@ Ref<LexerActionExecutor> LexerActionExecutor::append(Ref<LexerActionExecutor> co
 }
 
 Ref<LexerActionExecutor> LexerActionExecutor::fixOffsetBeforeMatch(int offset) {
+  if (!_hasUnfixedOffsets) {
+    return shared_from_this();
+  }
+
   std::vector<Ref<LexerAction>> updatedLexerActions;
   for (size_t i = 0; i < _lexerActions.size(); i++) {
     if (_lexerActions[i]->isPositionDependent() && !is<LexerIndexedCustomAction>(_lexerActions[i])) {
@@ -72,6 +72,10 @@ namespace atn {
     /// for all position-dependent lexer actions. </returns>
     virtual Ref<LexerActionExecutor> fixOffsetBeforeMatch(int offset);
 
+    /// Returns true if some position-dependent actions have no offset assigned yet, i.e. fixOffsetBeforeMatch()
+    /// does not return {@code this}.
+    bool hasUnfixedOffsets() const { return _hasUnfixedOffsets; }
+
     /// <summary>
     /// Gets the lexer actions to be executed by this executor. </summary>
     /// <returns> The lexer actions to be executed by this executor. </returns>
@@ -108,6 +112,8 @@ namespace atn {
     /// of the performance-critical <seealso cref="LexerATNConfig#hashCode"/> operation.
     const size_t _hashCode;
 
+    const bool _hasUnfixedOffsets;
+
     size_t generateHashCode() const;
   };
 
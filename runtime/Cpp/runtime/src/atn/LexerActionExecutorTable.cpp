@@ -0,0 +1,64 @@
+/* Copyright (c) 2012-2017 The ANTLR Project. All rights reserved.
+ * Use of this file is governed by the BSD 3-clause license that
+ * can be found in the LICENSE.txt file in the project root.
+ */
+
+#include "atn/LexerAction.h"
+#include "atn/LexerActionExecutor.h"
+
+#include "atn/LexerActionExecutorTable.h"
+
+using namespace antlr4;
+using namespace antlr4::atn;
+
+LexerActionExecutor *LexerActionExecutorTable::append(LexerActionExecutor *lexerActionExecutor,
+                                                      const Ref<LexerAction> &lexerAction) {
+  return lookup(_appended, Key<const LexerAction *>(lexerActionExecutor, lexerAction.get()), [&] {
+    Ref<LexerActionExecutor> executor;
+    if (lexerActionExecutor != nullptr) {
+      executor = lexerActionExecutor->shared_from_this();
+    }
+    return LexerActionExecutor::append(executor, lexerAction);
+  });
+}
+
+LexerActionExecutor *LexerActionExecutorTable::fixOffsetBeforeMatch(LexerActionExecutor *lexerActionExecutor,
+                                                                    int offset) {
+  return lookup(_fixed, Key<int>(lexerActionExecutor, offset), [&] {
+    return lexerActionExecutor->fixOffsetBeforeMatch(offset);
+  });
+}
+
+size_t LexerActionExecutorTable::size() const {
+  std::shared_lock<std::shared_mutex> lock(_lock);
+  return _executors.size();
+}
+
+template<typename T, typename Create>
+LexerActionExecutor *LexerActionExecutorTable::lookup(std::unordered_map<Key<T>, LexerActionExecutor *, KeyHasher> &memo,
+                                                      const Key<T> &key, Create create) {
+  {
+    std::shared_lock<std::shared_mutex> lock(_lock);
+    auto iterator = memo.find(key);
+    if (iterator != memo.end()) {
+      return iterator->second;
+    }
+  }
+
+  // Created outside of the lock. Another thread may have interned an equal executor in the meantime, then that
+  // one is used.
+  Ref<LexerActionExecutor> executor = create();
+  std::unique_lock<std::shared_mutex> lock(_lock);
+  LexerActionExecutor *interned = _executors.insert(std::move(executor)).first->get();
+  memo.emplace(key, interned);
+  return interned;
+}
+
+size_t LexerActionExecutorTable::Hasher::operator()(const Ref<LexerActionExecutor> &executor) const {
+  return executor->hashCode();
+}
+
+bool LexerActionExecutorTable::Comparer::operator()(const Ref<LexerActionExecutor> &lhs,
+                                                    const Ref<LexerActionExecutor> &rhs) const {
+  return *lhs == *rhs;
+}
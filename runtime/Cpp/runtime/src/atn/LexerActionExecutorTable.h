@@ -0,0 +1,66 @@
+/* Copyright (c) 2012-2017 The ANTLR Project. All rights reserved.
+ * Use of this file is governed by the BSD 3-clause license that
+ * can be found in the LICENSE.txt file in the project root.
+ */
+
+#pragma once
+
+#include "antlr4-common.h"
+
+namespace antlr4 {
+namespace atn {
+
+  /// Interns the lexer action executors of an ATN (see ATN::lexerActionExecutors): there is only one executor
+  /// per sequence of actions, which lives as long as the table. Lexer ATN configurations refer to their executor
+  /// by plain pointer, so configurations are created without copying shared pointers, and the results of
+  /// LexerActionExecutor::append() and LexerActionExecutor::fixOffsetBeforeMatch() are memoized, so the lexer
+  /// inner loop allocates executors only the first time a combination comes up. The table is thread safe.
+  class ANTLR4CPP_PUBLIC LexerActionExecutorTable final {
+  public:
+    LexerActionExecutorTable() = default;
+    LexerActionExecutorTable(const LexerActionExecutorTable &) = delete;
+    LexerActionExecutorTable& operator = (const LexerActionExecutorTable &) = delete;
+
+    /// The interned LexerActionExecutor::append() of the given executor (null for none) and action, which must
+    /// be one of ATN::lexerActions.
+    LexerActionExecutor *append(LexerActionExecutor *lexerActionExecutor, const Ref<LexerAction> &lexerAction);
+
+    /// The interned LexerActionExecutor::fixOffsetBeforeMatch() of the given executor, which must be interned
+    /// in this table.
+    LexerActionExecutor *fixOffsetBeforeMatch(LexerActionExecutor *lexerActionExecutor, int offset);
+
+    /// The number of interned executors.
+    size_t size() const;
+
+  private:
+    template<typename T>
+    using Key = std::pair<const LexerActionExecutor *, T>;
+
+    struct KeyHasher {
+      template<typename T>
+      size_t operator()(const Key<T> &key) const {
+        return std::hash<const void *>()(key.first) * 31 + std::hash<T>()(key.second);
+      }
+    };
+
+    struct Hasher {
+      size_t operator()(const Ref<LexerActionExecutor> &executor) const;
+    };
+
+    struct Comparer {
+      bool operator()(const Ref<LexerActionExecutor> &lhs, const Ref<LexerActionExecutor> &rhs) const;
+    };
+
+    mutable std::shared_mutex _lock;
+    std::unordered_set<Ref<LexerActionExecutor>, Hasher, Comparer> _executors;
+    std::unordered_map<Key<const LexerAction *>, LexerActionExecutor *, KeyHasher> _appended;
+    std::unordered_map<Key<int>, LexerActionExecutor *, KeyHasher> _fixed;
+
+    /// Looks up key in the memo, interning the result of create() on a miss.
+    template<typename T, typename Create>
+    LexerActionExecutor *lookup(std::unordered_map<Key<T>, LexerActionExecutor *, KeyHasher> &memo, const Key<T> &key,
+                                Create create);
+  };
+
+} // namespace atn
+} // namespace antlr4
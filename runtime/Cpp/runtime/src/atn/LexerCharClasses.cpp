@@ -0,0 +1,184 @@
+/* Copyright (c) 2012-2017 The ANTLR Project. All rights reserved.
+ * Use of this file is governed by the BSD 3-clause license that
+ * can be found in the LICENSE.txt file in the project root.
+ */
+
+#include "Lexer.h"
+#include "atn/ATN.h"
+#include "atn/ATNState.h"
+#include "atn/RuleTransition.h"
+#include "atn/TokensStartState.h"
+#include "atn/Transition.h"
+#include "misc/IntervalSet.h"
+
+#include "atn/LexerCharClasses.h"
+
+using namespace antlr4;
+using namespace antlr4::atn;
+
+namespace {
+
+  void addLabels(const ATNState *state, std::vector<misc::IntervalSet> &labels) {
+    for (Transition *transition : state->transitions) {
+      misc::IntervalSet label = transition->label();
+      if (!label.isEmpty()) {
+        labels.push_back(std::move(label));
+      }
+    }
+  }
+
+}
+
+template<typename ClassOf>
+void LexerCharClasses::buildMap(ClassOf classOf) {
+  // classOf is called for ascending code points.
+  _pages.assign(PAGE_COUNT, 0);
+  _blocks.clear();
+  std::map<std::vector<uint16_t>, uint16_t> blockIds;
+  std::vector<uint16_t> block(BLOCK_SIZE);
+  for (size_t page = 0; page < PAGE_COUNT; ++page) {
+    for (size_t i = 0; i < BLOCK_SIZE; ++i) {
+      block[i] = static_cast<uint16_t>(classOf(page * BLOCK_SIZE + i));
+    }
+    auto result = blockIds.emplace(block, static_cast<uint16_t>(blockIds.size()));
+    if (result.second) {
+      _blocks.insert(_blocks.end(), block.begin(), block.end());
+    }
+    _pages[page] = result.first->second;
+  }
+}
+
+LexerCharClasses::LexerCharClasses(const std::vector<misc::IntervalSet> &labels) {
+  // Split the code point range at every interval boundary of any label, then give segments which are inside
+  // the very same labels the same class. EOF and other negative values are not code points.
+  std::set<size_t> starts = { 0 };
+  for (const misc::IntervalSet &label : labels) {
+    for (const misc::Interval &interval : label.getIntervals()) {
+      if (interval.b < 0) {
+        continue;
+      }
+      starts.insert(static_cast<size_t>(std::max<ssize_t>(interval.a, 0)));
+      if (static_cast<size_t>(interval.b) < Lexer::MAX_CHAR_VALUE) {
+        starts.insert(static_cast<size_t>(interval.b) + 1);
+      }
+    }
+  }
+
+  std::vector<size_t> segments(starts.begin(), starts.end());
+  std::vector<std::vector<size_t>> memberships(segments.size());
+  for (size_t i = 0; i < labels.size(); ++i) {
+    for (const misc::Interval &interval : labels[i].getIntervals()) {
+      if (interval.b < 0) {
+        continue;
+      }
+      size_t a = static_cast<size_t>(std::max<ssize_t>(interval.a, 0));
+      auto first = std::upper_bound(segments.begin(), segments.end(), a) - 1;
+      auto last = std::upper_bound(segments.begin(), segments.end(), static_cast<size_t>(interval.b));
+      for (auto segment = first; segment != last; ++segment) {
+        memberships[static_cast<size_t>(segment - segments.begin())].push_back(i);
+      }
+    }
+  }
+
+  std::map<std::vector<size_t>, size_t> classIds;
+  std::vector<size_t> segmentClasses(segments.size());
+  std::vector<size_t> representatives;
+  for (size_t i = 0; i < segments.size(); ++i) {
+    auto result = classIds.emplace(std::move(memberships[i]), classIds.size());
+    if (result.second) {
+      representatives.push_back(segments[i]);
+    }
+    segmentClasses[i] = result.first->second;
+  }
+  if (representatives.size() > std::numeric_limits<uint16_t>::max()) {
+    return;
+  }
+
+  _representatives = std::move(representatives);
+  size_t segment = 0;
+  buildMap([&](size_t codePoint) {
+    while (segment + 1 < segments.size() && segments[segment + 1] <= codePoint) {
+      ++segment;
+    }
+    return segmentClasses[segment];
+  });
+}
+
+LexerCharClasses LexerCharClasses::forATN(const ATN &atn) {
+  std::vector<misc::IntervalSet> labels;
+  for (ATNState *state : atn.states) {
+    if (state != nullptr) {
+      addLabels(state, labels);
+    }
+  }
+  return LexerCharClasses(labels);
+}
+
+LexerCharClasses LexerCharClasses::forMode(const ATN &atn, size_t mode) {
+  std::vector<misc::IntervalSet> labels;
+  std::vector<ATNState *> work = { atn.modeToStartState[mode] };
+  std::vector<bool> visited(atn.states.size(), false);
+  while (!work.empty()) {
+    ATNState *state = work.back();
+    work.pop_back();
+    if (visited[state->stateNumber]) {
+      continue;
+    }
+    visited[state->stateNumber] = true;
+
+    // Rule stop states lead to the follow states of all callers, the ones of the rules called from this mode
+    // are added below.
+    if (state->getStateType() == ATNState::RULE_STOP) {
+      continue;
+    }
+
+    addLabels(state, labels);
+    for (Transition *transition : state->transitions) {
+      if (state == atn.modeToStartState[mode] &&
+          atn.modeToStartState[mode]->keywords.isKeywordRule(transition->target->ruleIndex)) {
+        continue;
+      }
+      work.push_back(transition->target);
+      if (transition->getSerializationType() == Transition::RULE) {
+        work.push_back(static_cast<RuleTransition *>(transition)->followState);
+      }
+    }
+  }
+  return LexerCharClasses(labels);
+}
+
+misc::IntervalSet LexerCharClasses::getCodePoints(size_t charClass) const {
+  misc::IntervalSet result;
+  size_t start = INVALID_INDEX;
+  for (size_t codePoint = 0; codePoint <= PAGE_COUNT * BLOCK_SIZE; ++codePoint) {
+    bool member = codePoint < PAGE_COUNT * BLOCK_SIZE && getClass(codePoint) == charClass;
+    if (member && start == INVALID_INDEX) {
+      start = codePoint;
+    } else if (!member && start != INVALID_INDEX) {
+      result.add(static_cast<ssize_t>(start), static_cast<ssize_t>(codePoint - 1));
+      start = INVALID_INDEX;
+    }
+  }
+  return result;
+}
+
+LexerCharClasses LexerCharClasses::remap(const std::vector<size_t> &classMap) const {
+  LexerCharClasses result;
+  if (_pages.empty()) {
+    return result;
+  }
+
+  size_t count = 0;
+  for (size_t c = 0; c < size(); ++c) {
+    count = std::max(count, classMap[c] + 1);
+  }
+  result._representatives.assign(count, INVALID_INDEX);
+  for (size_t c = 0; c < size(); ++c) {
+    size_t &representative = result._representatives[classMap[c]];
+    representative = std::min(representative, _representatives[c]);
+  }
+  result.buildMap([&](size_t codePoint) {
+    return classMap[getClass(codePoint)];
+  });
+  return result;
+}
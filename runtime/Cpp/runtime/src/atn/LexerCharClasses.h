@@ -0,0 +1,75 @@
+/* Copyright (c) 2012-2017 The ANTLR Project. All rights reserved.
+ * Use of this file is governed by the BSD 3-clause license that
+ * can be found in the LICENSE.txt file in the project root.
+ */
+
+#pragma once
+
+#include "antlr4-common.h"
+
+namespace antlr4 {
+namespace atn {
+
+  /// A partition of the code points into character classes: code points which are in exactly the same
+  /// transition labels are indistinguishable for a lexer and share a class. Lexer DFA edges are keyed on the
+  /// class instead of the code point, so all of Unicode is covered by a few (usually some dozens) edges.
+  ///
+  /// The map from code point to class has two levels: a page per 256 code points selects a block of 256 class
+  /// numbers. Identical blocks are shared, so the map of a typical grammar takes a few KB.
+  class ANTLR4CPP_PUBLIC LexerCharClasses final {
+  public:
+    static constexpr size_t BLOCK_SIZE = 256;
+    static constexpr size_t PAGE_COUNT = 0x110000 / BLOCK_SIZE;
+
+    /// No classes, getClass() returns INVALID_INDEX for every code point.
+    LexerCharClasses() = default;
+
+    /// Computes the classes of the given transition labels. Stays empty if there would be more than 65535
+    /// classes.
+    explicit LexerCharClasses(const std::vector<misc::IntervalSet> &labels);
+
+    /// The classes of the labels of all transitions in the ATN.
+    static LexerCharClasses forATN(const ATN &atn);
+
+    /// The classes of the labels of the transitions reachable from the start state of the given lexer mode,
+    /// including the rules called from there.
+    static LexerCharClasses forMode(const ATN &atn, size_t mode);
+
+    /// The number of classes.
+    size_t size() const { return _representatives.size(); }
+
+    /// Returns the class of the given code point, or INVALID_INDEX if it is out of range (e.g. EOF).
+    size_t getClass(size_t codePoint) const {
+      if (codePoint >= PAGE_COUNT * BLOCK_SIZE || _pages.empty()) {
+        return INVALID_INDEX;
+      }
+      return _blocks[_pages[codePoint >> 8] * BLOCK_SIZE + (codePoint & 0xFF)];
+    }
+
+    /// The smallest code point of the given class.
+    size_t getRepresentative(size_t charClass) const { return _representatives[charClass]; }
+
+    /// All code points of the given class. This walks the whole code point range, it is meant for diagnostics.
+    misc::IntervalSet getCodePoints(size_t charClass) const;
+
+    /// Returns the classes resulting from renumbering class i to classMap[i], which may merge classes.
+    LexerCharClasses remap(const std::vector<size_t> &classMap) const;
+
+    /// Page index -> block, PAGE_COUNT entries.
+    const std::vector<uint16_t>& getPages() const { return _pages; }
+
+    /// The blocks of BLOCK_SIZE entries each, low byte of the code point -> class.
+    const std::vector<uint16_t>& getBlocks() const { return _blocks; }
+
+  private:
+    std::vector<uint16_t> _pages;
+    std::vector<uint16_t> _blocks;
+    std::vector<size_t> _representatives;
+
+    /// Builds pages and blocks from the class of each code point.
+    template<typename ClassOf>
+    void buildMap(ClassOf classOf);
+  };
+
+} // namespace atn
+} // namespace antlr4
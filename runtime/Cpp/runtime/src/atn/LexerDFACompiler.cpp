@@ -0,0 +1,363 @@
+/* Copyright (c) 2012-2017 The ANTLR Project. All rights reserved.
+ * Use of this file is governed by the BSD 3-clause license that
+ * can be found in the LICENSE.txt file in the project root.
+ */
+
+#include "ANTLRInputStream.h"
+#include "Exceptions.h"
+#include "Token.h"
+#include "atn/ATN.h"
+#include "atn/ActionTransition.h"
+#include "atn/LexerATNConfig.h"
+#include "atn/LexerATNSimulator.h"
+#include "atn/LexerAction.h"
+#include "atn/LexerActionExecutor.h"
+#include "atn/LexerCharClasses.h"
+#include "atn/OrderedATNConfigSet.h"
+#include "atn/PredictionContext.h"
+#include "atn/RuleTransition.h"
+#include "atn/TokensStartState.h"
+#include "dfa/DFA.h"
+#include "dfa/DFAState.h"
+
+#include "atn/LexerDFACompiler.h"
+
+using namespace antlr4;
+using namespace antlr4::atn;
+
+namespace {
+
+  // Exposes the DFA construction of the lexer simulator, so the compiled DFA is exactly the one the
+  // simulator would build. Compiled modes have no predicates or position dependent actions, hence the
+  // input is never looked at.
+  class DeterminizingSimulator : public LexerATNSimulator {
+  public:
+    DeterminizingSimulator(const ATN &atn, std::vector<dfa::DFA> &decisionToDFA, PredictionContextCache &cache)
+      : LexerATNSimulator(atn, decisionToDFA, cache) {
+    }
+
+    // Keeps the keyword rules, unlike the base class with a keyword table installed: the table is ignored and
+    // keywords are matched by the compiled DFA like any other token, so no lookup is needed while lexing.
+    std::unique_ptr<ATNConfigSet> computeStartState(CharStream *input, ATNState *p) override {
+      std::unique_ptr<ATNConfigSet> configs(new OrderedATNConfigSet());
+      for (size_t i = 0; i < p->transitions.size(); i++) {
+        Ref<LexerATNConfig> c = std::make_shared<LexerATNConfig>(p->transitions[i]->target, (int)(i + 1),
+                                                                 PredictionContext::EMPTY);
+        closure(input, c, configs.get(), false, false, false);
+      }
+      return configs;
+    }
+
+    dfa::DFAState* startState(size_t mode) {
+      _mode = mode;
+      std::unique_ptr<ATNConfigSet> configs = computeStartState(&_input, atn.modeToStartState[mode]);
+      configs->hasSemanticContext = false;
+      return addDFAState(configs.release(), false);
+    }
+
+    // Returns nullptr if there is no transition on t.
+    dfa::DFAState* targetState(size_t mode, dfa::DFAState *s, size_t t) {
+      _mode = mode;
+      dfa::DFAState *target = computeTargetState(&_input, s, t);
+      return target == ERROR.get() ? nullptr : target;
+    }
+
+  private:
+    ANTLRInputStream _input;
+  };
+
+  template<typename T>
+  void writeArray(std::stringstream &ss, const std::string &name, const char *type, const std::vector<T> &values) {
+    ss << "  inline constexpr " << type << " " << name << "[] = {";
+    if (values.empty()) {
+      ss << " 0 "; // Zero sized arrays are not allowed.
+    }
+    for (size_t i = 0; i < values.size(); ++i) {
+      ss << (i % 16 == 0 ? "\n    " : " ") << values[i] << ",";
+    }
+    ss << "\n  };\n\n";
+  }
+
+}
+
+LexerDFACompiler::LexerDFACompiler(const ATN &atn) : _atn(atn), _classCount(0), _eofClass(0), _actionOffsets(1, 0) {
+}
+
+void LexerDFACompiler::compile() {
+  // 1) Character classes of the whole ATN, plus one for EOF. All modes share them, so a single class map is
+  //    emitted.
+  LexerCharClasses charClasses = LexerCharClasses::forATN(_atn);
+  size_t classCount = charClasses.size() + 1;
+  if (charClasses.size() == 0 || classCount > std::numeric_limits<uint16_t>::max()) {
+    throw UnsupportedOperationException("Too many character classes for a lexer DFA table.");
+  }
+  size_t eofClass = classCount - 1;
+
+  std::vector<size_t> representatives; // A code point of each class, used to compute transitions.
+  for (size_t c = 0; c < charClasses.size(); ++c) {
+    representatives.push_back(charClasses.getRepresentative(c));
+  }
+  representatives.push_back(Token::EOF);
+
+  // 2) Determinization: breadth first over the DFA states of each mode, one transition per class.
+  std::vector<dfa::DFA> decisionToDFA;
+  for (size_t i = 0; i < _atn.getNumberOfDecisions(); ++i) {
+    decisionToDFA.emplace_back(_atn.getDecisionState(i), i);
+  }
+  PredictionContextCache contextCache;
+  DeterminizingSimulator simulator(_atn, decisionToDFA, contextCache);
+
+  std::vector<dfa::DFAState *> states;
+  std::unordered_map<dfa::DFAState *, size_t> stateIds;
+  std::vector<int32_t> transitions;
+  std::vector<int32_t> modeStartStates(_atn.modeToStartState.size(), -1);
+  for (size_t mode = 0; mode < _atn.modeToStartState.size(); ++mode) {
+    if (!isCompilable(mode)) {
+      continue;
+    }
+
+    // States of different modes never coincide, each mode has its own DFA.
+    auto addState = [&](dfa::DFAState *state) {
+      auto result = stateIds.emplace(state, states.size());
+      if (result.second) {
+        states.push_back(state);
+        transitions.resize(transitions.size() + classCount, -1);
+      }
+      return static_cast<int32_t>(result.first->second);
+    };
+
+    size_t next = states.size();
+    modeStartStates[mode] = addState(simulator.startState(mode));
+    for (; next < states.size(); ++next) {
+      for (size_t c = 0; c < classCount; ++c) {
+        dfa::DFAState *target = simulator.targetState(mode, states[next], representatives[c]);
+        if (target != nullptr) {
+          transitions[next * classCount + c] = addState(target);
+        }
+      }
+    }
+  }
+
+  // Accepting states and their actions. Action lists are interned, keyed by their indexes into the ATN.
+  std::unordered_map<const LexerAction *, uint32_t> actionIndexes;
+  for (size_t i = 0; i < _atn.lexerActions.size(); ++i) {
+    actionIndexes.emplace(_atn.lexerActions[i].get(), static_cast<uint32_t>(i));
+  }
+  std::map<std::vector<uint32_t>, uint32_t> actionLists;
+  std::vector<uint32_t> predictions(states.size(), 0);
+  std::vector<uint32_t> stateActions(states.size(), 0);
+  for (size_t i = 0; i < states.size(); ++i) {
+    if (!states[i]->isAcceptState) {
+      continue;
+    }
+    predictions[i] = static_cast<uint32_t>(states[i]->prediction);
+    if (states[i]->lexerActionExecutor == nullptr) {
+      continue;
+    }
+    std::vector<uint32_t> actions;
+    for (const Ref<LexerAction> &action : states[i]->lexerActionExecutor->getLexerActions()) {
+      auto iterator = actionIndexes.find(action.get());
+      if (iterator == actionIndexes.end()) {
+        throw IllegalStateException("Lexer action not found in the ATN.");
+      }
+      actions.push_back(iterator->second);
+    }
+    stateActions[i] = actionLists.emplace(actions, static_cast<uint32_t>(actionLists.size() + 1)).first->second;
+  }
+
+  // 3) Minimization (Moore): start with states grouped by what they accept, split groups until all states in a
+  //    group go to the same groups on every class.
+  std::vector<size_t> blocks(states.size());
+  size_t blockCount = 0;
+  {
+    std::map<std::pair<uint32_t, uint32_t>, size_t> initial;
+    for (size_t i = 0; i < states.size(); ++i) {
+      blocks[i] = initial.emplace(std::make_pair(predictions[i], stateActions[i]), initial.size()).first->second;
+    }
+    blockCount = initial.size();
+  }
+  while (true) {
+    std::map<std::vector<int64_t>, size_t> refined;
+    std::vector<size_t> newBlocks(states.size());
+    for (size_t i = 0; i < states.size(); ++i) {
+      std::vector<int64_t> signature;
+      signature.reserve(classCount + 1);
+      signature.push_back(static_cast<int64_t>(blocks[i]));
+      for (size_t c = 0; c < classCount; ++c) {
+        int32_t target = transitions[i * classCount + c];
+        signature.push_back(target < 0 ? -1 : static_cast<int64_t>(blocks[static_cast<size_t>(target)]));
+      }
+      newBlocks[i] = refined.emplace(std::move(signature), refined.size()).first->second;
+    }
+    blocks = std::move(newBlocks);
+    if (refined.size() == blockCount) {
+      break;
+    }
+    blockCount = refined.size();
+  }
+
+  // Number the minimized states in breadth first order from the mode start states, for locality.
+  std::vector<int32_t> blockStates(blockCount, -1);
+  std::vector<size_t> representativeStates; // One original state per minimized state.
+  std::vector<size_t> queue;
+  auto visit = [&](size_t state) {
+    size_t block = blocks[state];
+    if (blockStates[block] < 0) {
+      blockStates[block] = static_cast<int32_t>(representativeStates.size());
+      representativeStates.push_back(state);
+      queue.push_back(state);
+    }
+    return blockStates[block];
+  };
+  for (int32_t &start : modeStartStates) {
+    if (start >= 0) {
+      start = visit(static_cast<size_t>(start));
+    }
+  }
+  for (size_t next = 0; next < queue.size(); ++next) {
+    for (size_t c = 0; c < classCount; ++c) {
+      int32_t target = transitions[queue[next] * classCount + c];
+      if (target >= 0) {
+        visit(static_cast<size_t>(target));
+      }
+    }
+  }
+
+  // 4) Merge classes which take the same transitions in all (minimized) states.
+  size_t stateCount = representativeStates.size();
+  std::map<std::vector<int32_t>, size_t> columns;
+  std::vector<size_t> classMap(classCount);
+  for (size_t c = 0; c < classCount; ++c) {
+    std::vector<int32_t> column(stateCount);
+    for (size_t s = 0; s < stateCount; ++s) {
+      int32_t target = transitions[representativeStates[s] * classCount + c];
+      column[s] = target < 0 ? -1 : blockStates[blocks[static_cast<size_t>(target)]];
+    }
+    classMap[c] = columns.emplace(std::move(column), columns.size()).first->second;
+  }
+
+  _classCount = columns.size();
+  _eofClass = classMap[eofClass];
+  _transitions.assign(stateCount * _classCount, -1);
+  _acceptPredictions.resize(stateCount);
+  _acceptActions.resize(stateCount);
+  for (size_t s = 0; s < stateCount; ++s) {
+    size_t original = representativeStates[s];
+    for (size_t c = 0; c < classCount; ++c) {
+      int32_t target = transitions[original * classCount + c];
+      _transitions[s * _classCount + classMap[c]] = target < 0 ? -1 : blockStates[blocks[static_cast<size_t>(target)]];
+    }
+    _acceptPredictions[s] = predictions[original];
+    _acceptActions[s] = stateActions[original];
+  }
+
+  _actionOffsets.assign(actionLists.size() + 1, 0);
+  std::vector<const std::vector<uint32_t> *> orderedLists(actionLists.size());
+  for (const auto &entry : actionLists) {
+    orderedLists[entry.second - 1] = &entry.first;
+  }
+  _actions.clear();
+  for (size_t i = 0; i < orderedLists.size(); ++i) {
+    _actions.insert(_actions.end(), orderedLists[i]->begin(), orderedLists[i]->end());
+    _actionOffsets[i + 1] = static_cast<uint32_t>(_actions.size());
+  }
+
+  _modeStartStates = std::move(modeStartStates);
+
+  // The class map with the merged classes. The EOF class is not in there.
+  classMap.pop_back();
+  LexerCharClasses mergedClasses = charClasses.remap(classMap);
+  _classPages = mergedClasses.getPages();
+  _classBlocks = mergedClasses.getBlocks();
+}
+
+bool LexerDFACompiler::isModeCompiled(size_t mode) const {
+  return mode < _modeStartStates.size() && _modeStartStates[mode] >= 0;
+}
+
+dfa::LexerDFATable LexerDFACompiler::table() const {
+  return dfa::LexerDFATable {
+    _atn.states.size(),
+    _classPages.data(), _classBlocks.data(), _classCount, _eofClass,
+    _acceptPredictions.size(), _transitions.data(), _acceptPredictions.data(), _acceptActions.data(),
+    _actionOffsets.size() - 1, _actionOffsets.data(), _actions.data(),
+    _modeStartStates.size(), _modeStartStates.data()
+  };
+}
+
+std::string LexerDFACompiler::toCppSource(const std::string &name, const std::string &ns) const {
+  std::stringstream ss;
+  ss << "// Lexer DFA table generated by antlr4::atn::LexerDFACompiler. Do not edit.\n\n";
+  ss << "#pragma once\n\n";
+  ss << "#include \"dfa/LexerDFATable.h\"\n\n";
+  if (!ns.empty()) {
+    ss << "namespace " << ns << " {\n\n";
+  }
+
+  ss << "namespace " << name << "_data {\n\n";
+  writeArray(ss, "classPages", "uint16_t", _classPages);
+  writeArray(ss, "classBlocks", "uint16_t", _classBlocks);
+  writeArray(ss, "transitions", "int32_t", _transitions);
+  writeArray(ss, "acceptPredictions", "uint32_t", _acceptPredictions);
+  writeArray(ss, "acceptActions", "uint32_t", _acceptActions);
+  writeArray(ss, "actionOffsets", "uint32_t", _actionOffsets);
+  writeArray(ss, "actions", "uint32_t", _actions);
+  writeArray(ss, "modeStartStates", "int32_t", _modeStartStates);
+  ss << "} // namespace " << name << "_data\n\n";
+
+  ss << "inline constexpr antlr4::dfa::LexerDFATable " << name << " = {\n";
+  ss << "  " << _atn.states.size() << ",\n";
+  ss << "  " << name << "_data::classPages, " << name << "_data::classBlocks, " << _classCount << ", " << _eofClass << ",\n";
+  ss << "  " << _acceptPredictions.size() << ", " << name << "_data::transitions, " << name << "_data::acceptPredictions, "
+     << name << "_data::acceptActions,\n";
+  ss << "  " << _actionOffsets.size() - 1 << ", " << name << "_data::actionOffsets, " << name << "_data::actions,\n";
+  ss << "  " << _modeStartStates.size() << ", " << name << "_data::modeStartStates\n";
+  ss << "};\n";
+
+  if (!ns.empty()) {
+    ss << "\n} // namespace " << ns << "\n";
+  }
+  return ss.str();
+}
+
+bool LexerDFACompiler::isCompilable(size_t mode) const {
+  // Walk all states the rules of the mode can reach, including the rules they call.
+  std::vector<ATNState *> work = { _atn.modeToStartState[mode] };
+  std::vector<bool> visited(_atn.states.size(), false);
+  while (!work.empty()) {
+    ATNState *state = work.back();
+    work.pop_back();
+    if (visited[state->stateNumber]) {
+      continue;
+    }
+    visited[state->stateNumber] = true;
+    if (state->getStateType() == ATNState::RULE_STOP) {
+      continue;
+    }
+
+    for (Transition *transition : state->transitions) {
+      switch (transition->getSerializationType()) {
+        case Transition::PREDICATE:
+        case Transition::PRECEDENCE:
+          return false;
+
+        case Transition::ACTION: {
+          size_t actionIndex = static_cast<ActionTransition *>(transition)->actionIndex;
+          if (actionIndex >= _atn.lexerActions.size() || _atn.lexerActions[actionIndex]->isPositionDependent()) {
+            return false;
+          }
+          break;
+        }
+
+        case Transition::RULE:
+          work.push_back(static_cast<RuleTransition *>(transition)->followState);
+          break;
+
+        default:
+          break;
+      }
+      work.push_back(transition->target);
+    }
+  }
+  return true;
+}
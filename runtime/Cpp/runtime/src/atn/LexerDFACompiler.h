@@ -0,0 +1,64 @@
+/* Copyright (c) 2012-2017 The ANTLR Project. All rights reserved.
+ * Use of this file is governed by the BSD 3-clause license that
+ * can be found in the LICENSE.txt file in the project root.
+ */
+
+#pragma once
+
+#include "dfa/LexerDFATable.h"
+
+namespace antlr4 {
+namespace atn {
+
+  class ATN;
+
+  /// Compiles the modes of a lexer ATN ahead of time into a complete, minimized DFA over character classes
+  /// (see dfa::LexerDFATable), instead of letting the LexerATNSimulator discover it edge by edge at runtime.
+  ///
+  /// The DFA states are computed by the LexerATNSimulator itself, so the compiled table matches exactly
+  /// what the simulator would do. Modes whose rules can reach a semantic predicate or a position dependent
+  /// action (custom actions) are left out, as their outcome is not a function of the input alone. Such modes
+  /// keep running on the ATN.
+  ///
+  /// Keyword tables installed on the ATN (see LexerKeywordTable::install()) are ignored: the keyword rules are
+  /// compiled into the DFA like all other rules, so the table yields the keyword token types without a lookup.
+  ///
+  /// The result can be used directly (table()) or written out as C++ source (toCppSource()) to be compiled
+  /// into the application, which is what the antlr4_lexer_dfa tool does.
+  class ANTLR4CPP_PUBLIC LexerDFACompiler {
+  public:
+    explicit LexerDFACompiler(const ATN &atn);
+
+    /// Determinizes and minimizes all modes. Throws an UnsupportedOperationException if the result needs more
+    /// than 65535 character classes.
+    void compile();
+
+    bool isModeCompiled(size_t mode) const;
+
+    /// A table referring to the arrays of this compiler, valid while this compiler lives.
+    dfa::LexerDFATable table() const;
+
+    /// Returns a C++ header defining the compiled table as {@code inline constexpr antlr4::dfa::LexerDFATable}
+    /// named {@code name}, in namespace {@code ns} (if given).
+    std::string toCppSource(const std::string &name, const std::string &ns = "") const;
+
+  private:
+    const ATN &_atn;
+
+    std::vector<uint16_t> _classPages;
+    std::vector<uint16_t> _classBlocks;
+    size_t _classCount;
+    size_t _eofClass;
+
+    std::vector<int32_t> _transitions;
+    std::vector<uint32_t> _acceptPredictions;
+    std::vector<uint32_t> _acceptActions;
+    std::vector<uint32_t> _actionOffsets;
+    std::vector<uint32_t> _actions;
+    std::vector<int32_t> _modeStartStates;
+
+    bool isCompilable(size_t mode) const;
+  };
+
+} // namespace atn
+} // namespace antlr4
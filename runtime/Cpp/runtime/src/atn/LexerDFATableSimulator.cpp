@@ -0,0 +1,130 @@
+/* Copyright (c) 2012-2017 The ANTLR Project. All rights reserved.
+ * Use of this file is governed by the BSD 3-clause license that
+ * can be found in the LICENSE.txt file in the project root.
+ */
+
+#include "CharStream.h"
+#include "Exceptions.h"
+#include "Token.h"
+#include "atn/ATN.h"
+#include "atn/ATNStatistics.h"
+#include "atn/LexerAction.h"
+#include "atn/LexerActionExecutor.h"
+#include "support/CPPUtils.h"
+
+#include "atn/LexerDFATableSimulator.h"
+
+using namespace antlr4;
+using namespace antlr4::atn;
+using namespace antlrcpp;
+
+LexerDFATableSimulator::LexerDFATableSimulator(Lexer *recog, const ATN &atn, std::vector<dfa::DFA> &decisionToDFA,
+                                               PredictionContextCache &sharedContextCache, const dfa::LexerDFATable &table)
+  : LexerATNSimulator(recog, atn, decisionToDFA, sharedContextCache), _table(table) {
+  if (table.atnStateCount != atn.states.size()) {
+    throw IllegalArgumentException("The lexer DFA table was compiled from a different ATN.");
+  }
+
+  // Accept states refer to action list i as i + 1.
+  _executors.push_back(nullptr);
+  for (size_t i = 0; i < table.actionListCount; ++i) {
+    std::vector<Ref<LexerAction>> actions;
+    for (size_t j = table.actionOffsets[i]; j < table.actionOffsets[i + 1]; ++j) {
+      actions.push_back(atn.lexerActions.at(table.actions[j]));
+    }
+    _executors.push_back(std::make_shared<LexerActionExecutor>(actions));
+  }
+}
+
+size_t LexerDFATableSimulator::match(CharStream *input, size_t mode) {
+  if (mode >= _table.modeCount || _table.modeStartStates[mode] < 0) {
+    return LexerATNSimulator::match(input, mode);
+  }
+
+  ATNStatistics::countLexerMatch();
+  _mode = mode;
+  ssize_t mark = input->mark();
+  auto onExit = finally([input, mark] {
+    input->release(mark);
+  });
+
+  _startIndex = input->index();
+  size_t startLine = _line;
+  size_t startCharPos = _charPositionInLine;
+
+  // Same loop as LexerATNSimulator::execATN(), over the table: take the longest match and remember the
+  // last accept state passed.
+  size_t classCount = _table.classCount;
+  size_t s = static_cast<size_t>(_table.modeStartStates[mode]);
+  size_t acceptState = _table.acceptPredictions[s] != 0 ? s : INVALID_INDEX;
+  size_t acceptIndex = _startIndex;
+  size_t acceptLine = _line;
+  size_t acceptCharPos = _charPositionInLine;
+
+  // Contiguous input is read directly, the stream is positioned once the token is matched.
+  size_t size = 0;
+  const char32_t *data = input->getContiguousData(size);
+  size_t index = _startIndex;
+  auto lookahead = [&]() -> size_t {
+    if (data == nullptr) {
+      return input->LA(1);
+    }
+    return index < size ? static_cast<size_t>(data[index]) : Token::EOF;
+  };
+
+  size_t t = lookahead();
+  while (true) {
+    size_t c = t == Token::EOF ? _table.eofClass : _table.getClass(t);
+    if (c >= classCount) {
+      break;
+    }
+    int32_t target = _table.transitions[s * classCount + c];
+    if (target < 0) {
+      break;
+    }
+
+    if (t != Token::EOF) {
+      if (data == nullptr) {
+        consume(input);
+      }
+      ++index;
+    }
+
+    s = static_cast<size_t>(target);
+    if (_table.acceptPredictions[s] != 0) {
+      acceptState = s;
+      acceptIndex = index;
+      acceptLine = _line;
+      acceptCharPos = _charPositionInLine;
+      if (t == Token::EOF) {
+        break;
+      }
+    }
+
+    t = lookahead();
+  }
+  _lookaheadEnd = std::max(_lookaheadEnd, (data == nullptr ? input->index() : index) + 1);
+
+  if (data != nullptr) {
+    // Line and column were not tracked, compute them for the accepted text in one go.
+    input->seek(index);
+    acceptLine = startLine;
+    acceptCharPos = startCharPos;
+    advancePosition(data, _startIndex, acceptIndex, acceptLine, acceptCharPos);
+  }
+
+  if (acceptState != INVALID_INDEX) {
+    accept(input, _executors[_table.acceptActions[acceptState]], _startIndex, acceptIndex, acceptLine, acceptCharPos);
+    return _table.acceptPredictions[acceptState];
+  }
+
+  if (t == Token::EOF && input->index() == _startIndex) {
+    return Token::EOF;
+  }
+
+  // No token here. Let the ATN simulator fail on the same input, so the error is reported as usual.
+  input->seek(_startIndex);
+  _line = startLine;
+  _charPositionInLine = startCharPos;
+  return LexerATNSimulator::match(input, mode);
+}
@@ -0,0 +1,39 @@
+/* Copyright (c) 2012-2017 The ANTLR Project. All rights reserved.
+ * Use of this file is governed by the BSD 3-clause license that
+ * can be found in the LICENSE.txt file in the project root.
+ */
+
+#pragma once
+
+#include "atn/LexerATNSimulator.h"
+#include "dfa/LexerDFATable.h"
+
+namespace antlr4 {
+namespace atn {
+
+  /// A lexer simulator which matches tokens by running a precompiled DFA table (see LexerDFACompiler) instead
+  /// of building the DFA from the ATN while lexing. The scanner loop needs no locks and no allocations. Modes
+  /// missing from the table, and input the table rejects, are handed to the LexerATNSimulator, so errors are
+  /// reported exactly as before.
+  ///
+  /// To use it, replace the interpreter of a lexer:
+  ///
+  ///   delete lexer.getInterpreter<atn::LexerATNSimulator>();
+  ///   lexer.setInterpreter(new atn::LexerDFATableSimulator(&lexer, lexer.getATN(), decisionToDFA, cache, MyTable));
+  class ANTLR4CPP_PUBLIC LexerDFATableSimulator : public LexerATNSimulator {
+  public:
+    /// The table must have been compiled from {@code atn} and has to outlive the simulator.
+    LexerDFATableSimulator(Lexer *recog, const ATN &atn, std::vector<dfa::DFA> &decisionToDFA,
+                           PredictionContextCache &sharedContextCache, const dfa::LexerDFATable &table);
+
+    virtual size_t match(CharStream *input, size_t mode) override;
+
+  protected:
+    const dfa::LexerDFATable &_table;
+
+    /// The action lists of the table, built once.
+    std::vector<Ref<LexerActionExecutor>> _executors;
+  };
+
+} // namespace atn
+} // namespace antlr4
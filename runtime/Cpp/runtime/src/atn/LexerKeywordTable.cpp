@@ -0,0 +1,243 @@
+/* Copyright (c) 2012-2017 The ANTLR Project. All rights reserved.
+ * Use of this file is governed by the BSD 3-clause license that
+ * can be found in the LICENSE.txt file in the project root.
+ */
+
+#include "Exceptions.h"
+#include "Lexer.h"
+#include "Token.h"
+#include "Vocabulary.h"
+#include "atn/ATN.h"
+#include "atn/ATNState.h"
+#include "atn/RuleStartState.h"
+#include "atn/RuleStopState.h"
+#include "atn/RuleTransition.h"
+#include "atn/TokensStartState.h"
+#include "atn/Transition.h"
+#include "support/Utf8.h"
+
+#include "atn/LexerKeywordTable.h"
+
+using namespace antlr4;
+using namespace antlr4::atn;
+
+namespace {
+
+  using Configs = std::set<std::pair<ATNState *, std::vector<ATNState *>>>;
+
+  char32_t fold(char32_t c, bool caseInsensitive) {
+    return caseInsensitive && c >= U'A' && c <= U'Z' ? c + (U'a' - U'A') : c;
+  }
+
+  // Adds the configurations reachable from state without consuming input. The stack holds the follow states of the
+  // rules called so far.
+  void closure(ATNState *state, std::vector<ATNState *> stack, Configs &configs) {
+    if (!configs.emplace(state, stack).second) {
+      return;
+    }
+
+    if (state->getStateType() == ATNState::RULE_STOP) {
+      if (!stack.empty()) {
+        ATNState *follow = stack.back();
+        stack.pop_back();
+        closure(follow, std::move(stack), configs);
+      }
+      return;
+    }
+
+    for (Transition *transition : state->transitions) {
+      if (transition->getSerializationType() == Transition::RULE) {
+        std::vector<ATNState *> callStack = stack;
+        callStack.push_back(static_cast<RuleTransition *>(transition)->followState);
+        closure(transition->target, std::move(callStack), configs);
+      } else if (transition->isEpsilon()) {
+        closure(transition->target, stack, configs);
+      }
+    }
+  }
+
+  // Returns true if the given rule matches exactly the text.
+  bool matchesRule(const ATN &atn, size_t ruleIndex, const std::u32string &text) {
+    Configs configs;
+    closure(atn.ruleToStartState[ruleIndex], {}, configs);
+    for (char32_t c : text) {
+      Configs next;
+      for (const auto &config : configs) {
+        for (Transition *transition : config.first->transitions) {
+          if (!transition->isEpsilon() && transition->matches(c, Lexer::MIN_CHAR_VALUE, Lexer::MAX_CHAR_VALUE)) {
+            closure(transition->target, config.second, next);
+          }
+        }
+      }
+      configs = std::move(next);
+    }
+    return configs.count({ atn.ruleToStopState[ruleIndex], {} }) > 0;
+  }
+
+}
+
+LexerKeywordTable::LexerKeywordTable(const ATN &atn, size_t mode, const dfa::Vocabulary &vocabulary,
+                                     size_t identifierType, bool caseInsensitive) {
+  if (mode >= atn.modeToStartState.size()) {
+    throw IllegalArgumentException("Invalid lexer mode " + std::to_string(mode) + ".");
+  }
+
+  std::vector<bool> hasActions(atn.ruleToStartState.size(), false);
+  for (ATNState *state : atn.states) {
+    if (state == nullptr) {
+      continue;
+    }
+    for (Transition *transition : state->transitions) {
+      switch (transition->getSerializationType()) {
+        case Transition::ACTION:
+        case Transition::PREDICATE:
+        case Transition::PRECEDENCE:
+          hasActions[state->ruleIndex] = true;
+          break;
+
+        default:
+          break;
+      }
+    }
+  }
+
+  // The rules of the mode in order of priority.
+  std::vector<size_t> rules;
+  for (Transition *transition : atn.modeToStartState[mode]->transitions) {
+    rules.push_back(transition->target->ruleIndex);
+  }
+  auto identifierRule = std::find_if(rules.begin(), rules.end(), [&](size_t rule) {
+    return atn.ruleToTokenType[rule] == identifierType;
+  });
+  if (identifierRule == rules.end()) {
+    throw IllegalArgumentException("Lexer mode " + std::to_string(mode) + " has no rule for token type " +
+                                   std::to_string(identifierType) + ".");
+  }
+  if (hasActions[*identifierRule]) {
+    throw IllegalArgumentException("The identifier rule of a keyword table must not have actions.");
+  }
+
+  std::map<std::u32string, size_t> keywords;
+  std::vector<bool> keywordRules(atn.ruleToStartState.size(), false);
+  for (auto rule = rules.begin(); rule != identifierRule; ++rule) {
+    size_t type = atn.ruleToTokenType[*rule];
+    std::string_view literal = vocabulary.getLiteralName(type);
+    if (hasActions[*rule] || literal.size() < 3 || literal.front() != '\'' || literal.back() != '\'' ||
+        literal.find('\\') != std::string_view::npos) {
+      continue;
+    }
+
+    std::u32string text = antlrcpp::Utf8::lenientDecode(literal.substr(1, literal.size() - 2));
+    if (!matchesRule(atn, *identifierRule, text)) {
+      continue;
+    }
+
+    // Of keywords which only differ in case, the first one wins. All of their rules are left out of the DFA.
+    keywordRules[*rule] = true;
+    for (char32_t &c : text) {
+      c = fold(c, caseInsensitive);
+    }
+    keywords.emplace(std::move(text), type);
+  }
+  if (keywords.empty()) {
+    return;
+  }
+
+  _identifierType = identifierType;
+  _caseInsensitive = caseInsensitive;
+  _keywordRules = std::move(keywordRules);
+
+  // Place the keywords of the largest buckets first, while most slots are free.
+  size_t count = keywords.size();
+  std::vector<std::vector<const std::u32string *>> buckets(count);
+  for (const auto &keyword : keywords) {
+    buckets[hash(keyword.first.data(), keyword.first.size(), 0, false) % count].push_back(&keyword.first);
+  }
+  std::vector<size_t> order;
+  for (size_t bucket = 0; bucket < count; ++bucket) {
+    order.push_back(bucket);
+  }
+  std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+    return buckets[a].size() > buckets[b].size();
+  });
+
+  _displacements.assign(count, 0);
+  _keywords.resize(count);
+  _types.assign(count, Token::INVALID_TYPE);
+  std::vector<bool> used(count, false);
+  size_t freeSlot = 0;
+  for (size_t bucket : order) {
+    if (buckets[bucket].empty()) {
+      break;
+    }
+
+    std::vector<size_t> slots;
+    if (buckets[bucket].size() == 1) {
+      while (used[freeSlot]) {
+        ++freeSlot;
+      }
+      slots.push_back(freeSlot);
+      _displacements[bucket] = -static_cast<int32_t>(freeSlot) - 1;
+    } else {
+      for (uint32_t seed = 1; slots.size() < buckets[bucket].size(); ++seed) {
+        slots.clear();
+        for (const std::u32string *keyword : buckets[bucket]) {
+          size_t slot = hash(keyword->data(), keyword->size(), seed, false) % count;
+          if (used[slot] || std::find(slots.begin(), slots.end(), slot) != slots.end()) {
+            break;
+          }
+          slots.push_back(slot);
+        }
+        _displacements[bucket] = static_cast<int32_t>(seed);
+      }
+    }
+
+    for (size_t i = 0; i < slots.size(); ++i) {
+      used[slots[i]] = true;
+      _keywords[slots[i]] = *buckets[bucket][i];
+      _types[slots[i]] = keywords[*buckets[bucket][i]];
+    }
+  }
+}
+
+void LexerKeywordTable::install(ATN &atn, size_t mode, const dfa::Vocabulary &vocabulary, size_t identifierType,
+                                bool caseInsensitive) {
+  TokensStartState *startState = atn.modeToStartState.at(mode);
+  startState->keywords = LexerKeywordTable(atn, mode, vocabulary, identifierType, caseInsensitive);
+  if (startState->charClasses.size() > 0) {
+    startState->charClasses = LexerCharClasses::forMode(atn, mode);
+  }
+}
+
+size_t LexerKeywordTable::getType(const char32_t *text, size_t length) const {
+  if (_keywords.empty()) {
+    return Token::INVALID_TYPE;
+  }
+
+  int32_t displacement = _displacements[hash(text, length, 0, _caseInsensitive) % _keywords.size()];
+  size_t slot = displacement < 0
+    ? static_cast<size_t>(-displacement - 1)
+    : hash(text, length, static_cast<uint32_t>(displacement), _caseInsensitive) % _keywords.size();
+  const std::u32string &keyword = _keywords[slot];
+  if (keyword.size() != length) {
+    return Token::INVALID_TYPE;
+  }
+  for (size_t i = 0; i < length; ++i) {
+    if (fold(text[i], _caseInsensitive) != keyword[i]) {
+      return Token::INVALID_TYPE;
+    }
+  }
+  return _types[slot];
+}
+
+uint32_t LexerKeywordTable::hash(const char32_t *text, size_t length, uint32_t seed, bool caseInsensitive) {
+  // FNV-1a over the code points, with a final mix so the seeds give independent slots.
+  uint32_t hash = 2166136261u ^ (seed * 0x9E3779B9u);
+  for (size_t i = 0; i < length; ++i) {
+    hash = (hash ^ static_cast<uint32_t>(fold(text[i], caseInsensitive))) * 16777619u;
+  }
+  hash ^= hash >> 16;
+  hash *= 0x85EBCA6Bu;
+  hash ^= hash >> 13;
+  return hash;
+}
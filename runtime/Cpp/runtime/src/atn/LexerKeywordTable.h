@@ -0,0 +1,67 @@
+/* Copyright (c) 2012-2017 The ANTLR Project. All rights reserved.
+ * Use of this file is governed by the BSD 3-clause license that
+ * can be found in the LICENSE.txt file in the project root.
+ */
+
+#pragma once
+
+#include "antlr4-common.h"
+
+namespace antlr4 {
+namespace atn {
+
+  /// The keywords of a lexer mode, recognized through a perfect hash instead of the mode's DFA. Every keyword
+  /// prefix otherwise becomes DFA states competing with the identifier rule, which for grammars with hundreds of
+  /// keywords (SQL, COBOL) makes the DFA huge. With a keyword table, the keyword rules are left out of the mode's
+  /// start state, the identifier rule matches the keyword and its token type is then looked up in the table.
+  ///
+  /// Keywords are the literal names of the vocabulary (e.g. {@code 'select'}) whose rules precede the identifier
+  /// rule, match nothing but the literal, have no actions or predicates, and whose literal is matched by the
+  /// identifier rule. Other literal rules are left alone.
+  class ANTLR4CPP_PUBLIC LexerKeywordTable final {
+  public:
+    /// No keywords, getType() returns Token::INVALID_TYPE for every text.
+    LexerKeywordTable() = default;
+
+    /// Collects the keywords of the given mode. With {@code caseInsensitive}, texts are looked up with the ASCII
+    /// letters folded to lower case, the identifier rule must then match all case variants. Throws an
+    /// IllegalArgumentException if the mode has no rule for {@code identifierType}, or that rule has actions.
+    LexerKeywordTable(const ATN &atn, size_t mode, const dfa::Vocabulary &vocabulary, size_t identifierType,
+                      bool caseInsensitive = false);
+
+    /// Gives the mode a keyword table and updates its character classes. This must happen before the ATN is used
+    /// for lexing, i.e. right after deserializing it, as the DFAs built for the mode depend on the table.
+    static void install(ATN &atn, size_t mode, const dfa::Vocabulary &vocabulary, size_t identifierType,
+                        bool caseInsensitive = false);
+
+    /// The number of keywords.
+    size_t size() const { return _keywords.size(); }
+
+    /// The token type of the identifier rule, Token::INVALID_TYPE if there are no keywords.
+    size_t getIdentifierType() const { return _identifierType; }
+
+    /// Returns true if the given lexer rule is a keyword rule, which the mode's start state leaves out.
+    bool isKeywordRule(size_t ruleIndex) const {
+      return ruleIndex < _keywordRules.size() && _keywordRules[ruleIndex];
+    }
+
+    /// Returns the token type of the keyword with the given text, or Token::INVALID_TYPE if it is none.
+    size_t getType(const char32_t *text, size_t length) const;
+
+  private:
+    size_t _identifierType = 0;
+    bool _caseInsensitive = false;
+    std::vector<bool> _keywordRules;
+
+    /// Hash and displace: the first hash of a keyword selects an entry in _displacements. A negative entry -s - 1
+    /// is the slot of the only keyword with that first hash, otherwise it is the seed of the second hash which
+    /// gives the slot. The seeds are chosen so that no two keywords share a slot.
+    std::vector<int32_t> _displacements;
+    std::vector<std::u32string> _keywords;
+    std::vector<size_t> _types;
+
+    static uint32_t hash(const char32_t *text, size_t length, uint32_t seed, bool caseInsensitive);
+  };
+
+} // namespace atn
+} // namespace antlr4
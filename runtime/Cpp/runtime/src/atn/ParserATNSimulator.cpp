@@ -21,6 +21,7 @@
 #include "atn/RuleStopState.h"
 #include "atn/ATNConfigSet.h"
 #include "atn/ATNConfig.h"
+#include "atn/LL1Analyzer.h"
 
 #include "atn/StarLoopEntryState.h"
 #include "atn/BlockStartState.h"
@@ -31,6 +32,7 @@
 
 #include "Vocabulary.h"
 #include "support/Arrays.h"
+#include "support/CPPUtils.h"
 
 #include "atn/ParserATNSimulator.h"
 
@@ -44,6 +46,14 @@ using namespace antlr4::atn;
 
 using namespace antlrcpp;
 
+namespace {
+
+  // Merge cache of the parallel closure worker running on this thread, if any. See
+  // ParserATNSimulator::parallelClosure.
+  thread_local PredictionContextMergeCache *workerMergeCache = nullptr;
+
+}
+
 const bool ParserATNSimulator::TURN_OFF_LR_LOOP_ENTRY_BRANCH_OPT = ParserATNSimulator::getLrLoopSetting();
 
 ParserATNSimulator::ParserATNSimulator(const ATN &atn, std::vector<dfa::DFA> &decisionToDFA,
@@ -58,6 +68,7 @@ ParserATNSimulator::ParserATNSimulator(Parser *parser, const ATN &atn, std::vect
 }
 
 void ParserATNSimulator::reset() {
+  _lookaheadEnd = 0;
 }
 
 void ParserATNSimulator::clearDFA() {
@@ -79,6 +90,13 @@ size_t ParserATNSimulator::adaptivePredict(TokenStream *input, size_t decision,
   _startIndex = input->index();
   _outerContext = outerContext;
   dfa::DFA &dfa = decisionToDFA[decision];
+
+  // Decisions found to be LL(1) at deserialization are answered from LA(1) alone.
+  size_t ll1Alt = dfa.atnStartState->getLL1Alt(input->LA(1));
+  if (ll1Alt != ATN::INVALID_ALT_NUMBER) {
+    return ll1Alt;
+  }
+
   _dfa = &dfa;
 
   ssize_t m = input->mark();
@@ -108,6 +126,8 @@ size_t ParserATNSimulator::adaptivePredict(TokenStream *input, size_t decision,
   _stateLock.unlock_shared();
 
   if (s0 == nullptr) {
+    initializeEdgeSlots(dfa);
+
     bool fullCtx = false;
     std::unique_ptr<ATNConfigSet> s0_closure = computeStartState(dynamic_cast<ATNState *>(dfa.atnStartState),
                                                                  &ParserRuleContext::EMPTY, fullCtx);
@@ -260,6 +280,7 @@ size_t ParserATNSimulator::execATN(dfa::DFA &dfa, dfa::DFAState *s0, TokenStream
     if (t != Token::EOF) {
       input->consume();
       t = input->LA(1);
+      _lookaheadEnd = std::max(_lookaheadEnd, input->index() + 1);
     }
   }
 }
@@ -267,8 +288,13 @@ size_t ParserATNSimulator::execATN(dfa::DFA &dfa, dfa::DFAState *s0, TokenStream
 dfa::DFAState *ParserATNSimulator::getExistingTargetState(dfa::DFAState *previousD, size_t t) {
   dfa::DFAState* retval;
   _edgeLock.lock_shared();
-  auto iterator = previousD->edges.find(t);
-  retval = (iterator == previousD->edges.end()) ? nullptr : iterator->second;
+  size_t slot = _dfa != nullptr ? _dfa->getEdgeSlot(t) : INVALID_INDEX;
+  if (slot < previousD->denseEdges.size()) {
+    retval = previousD->denseEdges[slot];
+  } else {
+    auto iterator = previousD->edges.find(t);
+    retval = (iterator == previousD->edges.end()) ? nullptr : iterator->second;
+  }
   _edgeLock.unlock_shared();
   return retval;
 }
@@ -398,6 +424,7 @@ size_t ParserATNSimulator::execATNWithFullContext(dfa::DFA &dfa, dfa::DFAState *
     if (t != Token::EOF) {
       input->consume();
       t = input->LA(1);
+      _lookaheadEnd = std::max(_lookaheadEnd, input->index() + 1);
     }
   }
 
@@ -513,8 +540,12 @@ std::unique_ptr<ATNConfigSet> ParserATNSimulator::computeReachSet(ATNConfigSet *
     ATNConfig::Set closureBusy;
 
     bool treatEofAsEpsilon = t == Token::EOF;
-    for (const auto &c : intermediate->configs) {
-      closure(c, reach.get(), closureBusy, false, fullCtx, treatEofAsEpsilon);
+    if (!fullCtx && isParallelClosure(intermediate->configs.size())) {
+      parallelClosure(intermediate->configs, reach.get(), false, treatEofAsEpsilon);
+    } else {
+      for (const auto &c : intermediate->configs) {
+        closure(c, reach.get(), closureBusy, false, fullCtx, treatEofAsEpsilon);
+      }
     }
   }
 
@@ -594,6 +625,15 @@ std::unique_ptr<ATNConfigSet> ParserATNSimulator::computeStartState(ATNState *p,
   Ref<PredictionContext> initialContext = PredictionContext::fromRuleContext(atn, ctx);
   std::unique_ptr<ATNConfigSet> configs(new ATNConfigSet(fullCtx));
 
+  if (!fullCtx && isParallelClosure(p->transitions.size())) {
+    std::vector<Ref<ATNConfig>> roots;
+    for (size_t i = 0; i < p->transitions.size(); i++) {
+      roots.push_back(std::make_shared<ATNConfig>(p->transitions[i]->target, (int)i + 1, initialContext));
+    }
+    parallelClosure(roots, configs.get(), true, false);
+    return configs;
+  }
+
   for (size_t i = 0; i < p->transitions.size(); i++) {
     ATNState *target = p->transitions[i]->target;
     Ref<ATNConfig> c = std::make_shared<ATNConfig>(target, (int)i + 1, initialContext);
@@ -823,6 +863,49 @@ void ParserATNSimulator::closure(Ref<ATNConfig> const& config, ATNConfigSet *con
   assert(!fullCtx || !configs->dipsIntoOuterContext);
 }
 
+bool ParserATNSimulator::isParallelClosure(size_t rootCount) const {
+  return _parallelClosureThreads > 1 && rootCount >= _parallelClosureThreshold;
+}
+
+void ParserATNSimulator::parallelClosure(const std::vector<Ref<ATNConfig>> &roots, ATNConfigSet *configs,
+                                         bool collectPredicates, bool treatEofAsEpsilon) {
+  // Each root gets its own result set, so merging them in root order below adds configurations in the same
+  // order as the serial loop does, which keeps the resulting DFA independent of thread scheduling.
+  // One task per worker, which takes the roots one by one, so each worker keeps its merge cache for all of them.
+  std::vector<std::unique_ptr<ATNConfigSet>> results(roots.size());
+  std::atomic<size_t> nextRoot(0);
+  size_t workers = std::min(_parallelClosureThreads, roots.size());
+  runConcurrently(workers, workers, [&](size_t) {
+    PredictionContextMergeCache localMergeCache;
+    workerMergeCache = &localMergeCache;
+    auto onExit = finally([] {
+      workerMergeCache = nullptr;
+    });
+
+    try {
+      for (size_t i = nextRoot++; i < roots.size(); i = nextRoot++) {
+        results[i].reset(new ATNConfigSet(false));
+        ATNConfig::Set closureBusy;
+        closure(roots[i], results[i].get(), closureBusy, collectPredicates, false, treatEofAsEpsilon);
+      }
+    } catch (...) {
+      nextRoot = roots.size();
+      throw;
+    }
+  });
+
+  for (const auto &result : results) {
+    for (const auto &c : result->configs) {
+      configs->add(c, &mergeCache);
+    }
+    configs->dipsIntoOuterContext |= result->dipsIntoOuterContext;
+  }
+}
+
+PredictionContextMergeCache* ParserATNSimulator::getClosureMergeCache() {
+  return workerMergeCache != nullptr ? workerMergeCache : &mergeCache;
+}
+
 void ParserATNSimulator::closureCheckingStopState(Ref<ATNConfig> const& config, ATNConfigSet *configs,
   ATNConfig::Set &closureBusy, bool collectPredicates, bool fullCtx, int depth, bool treatEofAsEpsilon) {
 
@@ -837,7 +920,7 @@ void ParserATNSimulator::closureCheckingStopState(Ref<ATNConfig> const& config,
       for (size_t i = 0; i < config->context->size(); i++) {
         if (config->context->getReturnState(i) == PredictionContext::EMPTY_RETURN_STATE) {
           if (fullCtx) {
-            configs->add(std::make_shared<ATNConfig>(config, config->state, PredictionContext::EMPTY), &mergeCache);
+            configs->add(std::make_shared<ATNConfig>(config, config->state, PredictionContext::EMPTY), getClosureMergeCache());
             continue;
           } else {
             // we have no context info, just chase follow links (if greedy)
@@ -866,7 +949,7 @@ void ParserATNSimulator::closureCheckingStopState(Ref<ATNConfig> const& config,
       return;
     } else if (fullCtx) {
       // reached end of start rule
-      configs->add(config, &mergeCache);
+      configs->add(config, getClosureMergeCache());
       return;
     } else {
       // else if we have no context info, just chase follow links (if greedy)
@@ -883,7 +966,7 @@ void ParserATNSimulator::closure_(Ref<ATNConfig> const& config, ATNConfigSet *co
   if (!p->epsilonOnlyTransitions) {
     // make sure to not return here, because EOF transitions can act as
     // both epsilon transitions and non-epsilon transitions.
-    configs->add(config, &mergeCache);
+    configs->add(config, getClosureMergeCache());
   }
 
   for (size_t i = 0; i < p->transitions.size(); i++) {
@@ -1264,7 +1347,15 @@ dfa::DFAState *ParserATNSimulator::addDFAEdge(dfa::DFA &dfa, dfa::DFAState *from
 
   {
     _edgeLock.lock();
-    from->edges[t] = to; // connect
+    size_t slot = dfa.addEdgeSlot(static_cast<size_t>(t));
+    if (slot != INVALID_INDEX) {
+      if (slot >= from->denseEdges.size()) {
+        from->denseEdges.resize(dfa.getEdgeSlotCount(), nullptr);
+      }
+      from->denseEdges[slot] = to; // connect
+    } else {
+      from->edges[t] = to; // connect
+    }
     _edgeLock.unlock();
   }
 
@@ -1297,6 +1388,10 @@ dfa::DFAState *ParserATNSimulator::addDFAState(dfa::DFA &dfa, dfa::DFAState *D)
     D->configs->setReadonly(true);
   }
 
+  if (_compactDFAStates) {
+    D->compact();
+  }
+
   dfa.states.insert(D);
 
 #if DEBUG_DFA == 1
@@ -1306,6 +1401,34 @@ dfa::DFAState *ParserATNSimulator::addDFAState(dfa::DFA &dfa, dfa::DFAState *D)
   return D;
 }
 
+void ParserATNSimulator::initializeEdgeSlots(dfa::DFA &dfa) {
+  _edgeLock.lock_shared();
+  bool initialized = dfa.getEdgeSlotCount() > 0;
+  _edgeLock.unlock_shared();
+  if (initialized) {
+    return;
+  }
+
+  // Give the LL(1) lookahead of the decision the first edge slots. Token types only seen deeper into
+  // the lookahead get their slots assigned when the first edge for them is added.
+  misc::IntervalSet lookahead;
+  LL1Analyzer analyzer(atn);
+  for (const auto &set : analyzer.getDecisionLookahead(dfa.atnStartState)) {
+    lookahead.addAll(set);
+  }
+
+  _edgeLock.lock();
+  if (dfa.getEdgeSlotCount() == 0) {
+    for (ssize_t element : lookahead.toList()) {
+      size_t t = static_cast<size_t>(element);
+      if (t == Token::EOF || (element > 0 && t <= atn.maxTokenType)) {
+        dfa.addEdgeSlot(t);
+      }
+    }
+  }
+  _edgeLock.unlock();
+}
+
 void ParserATNSimulator::reportAttemptingFullContext(dfa::DFA &dfa, const antlrcpp::BitSet &conflictingAlts,
   ATNConfigSet *configs, size_t startIndex, size_t stopIndex) {
 #if DEBUG_DFA == 1 || RETRY_DEBUG == 1
@@ -1350,6 +1473,31 @@ atn::PredictionMode ParserATNSimulator::getPredictionMode() {
   return _mode;
 }
 
+void ParserATNSimulator::setCompactDFAStates(bool compact) {
+  _compactDFAStates = compact;
+}
+
+bool ParserATNSimulator::isCompactDFAStates() const {
+  return _compactDFAStates;
+}
+
+void ParserATNSimulator::setParallelClosure(size_t threadCount, size_t threshold) {
+  _parallelClosureThreads = threadCount;
+  _parallelClosureThreshold = threshold;
+}
+
+size_t ParserATNSimulator::getParallelClosureThreads() const {
+  return _parallelClosureThreads;
+}
+
+size_t ParserATNSimulator::getLookaheadEnd() const {
+  return _lookaheadEnd;
+}
+
+void ParserATNSimulator::setLookaheadEnd(size_t lookaheadEnd) {
+  _lookaheadEnd = lookaheadEnd;
+}
+
 Parser* ParserATNSimulator::getParser() {
   return parser;
 }
@@ -1373,4 +1521,8 @@ bool ParserATNSimulator::getLrLoopSetting() {
 void ParserATNSimulator::InitializeInstanceFields() {
   _mode = PredictionMode::LL;
   _startIndex = 0;
+  _compactDFAStates = false;
+  _parallelClosureThreads = 0;
+  _parallelClosureThreshold = 0;
+  _lookaheadEnd = 0;
 }
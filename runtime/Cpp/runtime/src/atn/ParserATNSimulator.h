@@ -354,6 +354,27 @@ namespace atn {
     void setPredictionMode(PredictionMode newMode);
     PredictionMode getPredictionMode();
 
+    /// Enables compaction of the DFA states this simulator adds to the DFA. A compacted accept state drops its
+    /// ATN configuration set right after it was published (see DFAState::compact()), which removes most of the
+    /// steady-state DFA memory. States which may still need their configurations (full context fallback,
+    /// predicates, reach computation for missing edges) are left untouched. Disabled by default.
+    void setCompactDFAStates(bool compact);
+    bool isCompactDFAStates() const;
+
+    /// Runs the closure operations of computeStartState() and computeReachSet() on up to {@code threadCount}
+    /// threads (including the calling one) once there are at least {@code threshold} configurations to close
+    /// over, e.g. the start state of a decision with hundreds of alternatives. This cuts the latency of the
+    /// first predictions in wide decisions while their DFA is still cold. Full context closures evaluate
+    /// predicates against the parser and always run serially. A thread count below 2 disables this (default).
+    /// Subclasses overriding the closure methods must keep them thread safe when enabling it.
+    void setParallelClosure(size_t threadCount, size_t threshold);
+    size_t getParallelClosureThreads() const;
+
+    /// The index after the furthest token predictions looked at since the value was last set (or reset()). The
+    /// parser uses it to find the contexts an edit of the input affects (see Parser::setReusableTree()).
+    size_t getLookaheadEnd() const;
+    void setLookaheadEnd(size_t lookaheadEnd);
+
     Parser* getParser();
     
     virtual std::string getTokenName(size_t t);
@@ -760,6 +781,16 @@ namespace atn {
     virtual bool evalSemanticContext(Ref<SemanticContext> const& pred, ParserRuleContext *parserCallStack,
                                      size_t alt, bool fullCtx);
 
+    bool isParallelClosure(size_t rootCount) const;
+
+    /// Computes the closure of each of the {@code roots} (SLL only) on the parallel closure threads, each into
+    /// its own set, and merges the results into {@code configs} in root order.
+    void parallelClosure(const std::vector<Ref<ATNConfig>> &roots, ATNConfigSet *configs, bool collectPredicates,
+                         bool treatEofAsEpsilon);
+
+    /// The merge cache to use for closure operations on the current thread.
+    PredictionContextMergeCache* getClosureMergeCache();
+
     /* TODO: If we are doing predicates, there is no point in pursuing
      closure operations if we reach a DFA state that uniquely predicts
      alternative. We will not be caching that DFA state and it is a
@@ -877,6 +908,10 @@ namespace atn {
     /// state was not already present. </returns>
     virtual dfa::DFAState *addDFAState(dfa::DFA &dfa, dfa::DFAState *D);
 
+    /// Seeds the token type remapping used for the dense edges of the DFA states of the given decision
+    /// (see DFA::getEdgeSlot()) with its LL(1) lookahead. Called before the first start state is added.
+    void initializeEdgeSlots(dfa::DFA &dfa);
+
     virtual void reportAttemptingFullContext(dfa::DFA &dfa, const antlrcpp::BitSet &conflictingAlts,
       ATNConfigSet *configs, size_t startIndex, size_t stopIndex);
 
@@ -895,6 +930,11 @@ namespace atn {
     // SLL, LL, or LL + exact ambig detection?
     PredictionMode _mode;
 
+    bool _compactDFAStates;
+    size_t _parallelClosureThreads;
+    size_t _parallelClosureThreshold;
+    size_t _lookaheadEnd;
+
     static bool getLrLoopSetting();
     void InitializeInstanceFields();
   };
@@ -11,6 +11,7 @@
 #include "atn/RuleTransition.h"
 #include "support/Arrays.h"
 #include "support/CPPUtils.h"
+#include "atn/ATNStatistics.h"
 
 #include "atn/PredictionContext.h"
 
@@ -20,12 +21,12 @@ using namespace antlr4::atn;
 
 using namespace antlrcpp;
 
-std::atomic<size_t> PredictionContext::globalNodeCount(0);
 const Ref<PredictionContext> PredictionContext::EMPTY = std::make_shared<EmptyPredictionContext>();
 
 //----------------- PredictionContext ----------------------------------------------------------------------------------
 
-PredictionContext::PredictionContext(size_t cachedHashCode) : id(globalNodeCount.fetch_add(1, std::memory_order_relaxed)), cachedHashCode(cachedHashCode)  {
+PredictionContext::PredictionContext(size_t cachedHashCode) : cachedHashCode(cachedHashCode)  {
+  ATNStatistics::countPredictionContext();
 }
 
 PredictionContext::~PredictionContext() {
@@ -386,14 +387,16 @@ std::string PredictionContext::toDOTString(const Ref<PredictionContext> &context
   std::stringstream ss;
   ss << "digraph G {\n" << "rankdir=LR;\n";
 
+  // Nodes are named by their position in the traversal order.
   std::vector<Ref<PredictionContext>> nodes = getAllContextNodes(context);
-  std::sort(nodes.begin(), nodes.end(), [](const Ref<PredictionContext> &o1, const Ref<PredictionContext> &o2) {
-    return o1->id - o2->id;
-  });
+  std::unordered_map<const PredictionContext *, size_t> ids;
+  for (const auto &current : nodes) {
+    ids.emplace(current.get(), ids.size());
+  }
 
   for (const auto &current : nodes) {
     if (is<SingletonPredictionContext>(current)) {
-      std::string s = std::to_string(current->id);
+      std::string s = std::to_string(ids[current.get()]);
       ss << "  s" << s;
       std::string returnState = std::to_string(current->getReturnState(0));
       if (is<EmptyPredictionContext>(current)) {
@@ -403,7 +406,7 @@ std::string PredictionContext::toDOTString(const Ref<PredictionContext> &context
       continue;
     }
     Ref<ArrayPredictionContext> arr = std::static_pointer_cast<ArrayPredictionContext>(current);
-    ss << "  s" << arr->id << " [shape=box, label=\"" << "[";
+    ss << "  s" << ids[arr.get()] << " [shape=box, label=\"" << "[";
     bool first = true;
     for (auto inv : arr->returnStates) {
       if (!first) {
@@ -428,7 +431,7 @@ std::string PredictionContext::toDOTString(const Ref<PredictionContext> &context
       if (!current->getParent(i)) {
         continue;
       }
-      ss << "  s" << current->id << "->" << "s" << current->getParent(i)->id;
+      ss << "  s" << ids[current.get()] << "->" << "s" << ids[current->getParent(i).get()];
       if (current->size() > 1) {
         ss << " [label=\"parent[" << i << "]\"];\n";
       } else {
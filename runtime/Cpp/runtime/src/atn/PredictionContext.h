@@ -5,8 +5,6 @@
 
 #pragma once
 
-#include <atomic>
-
 #include "Recognizer.h"
 #include "atn/ATN.h"
 #include "atn/ATNState.h"
@@ -38,9 +36,6 @@ namespace atn {
     static constexpr size_t INITIAL_HASH = 1;
 
   public:
-    static std::atomic<size_t> globalNodeCount;
-    const size_t id;
-
     /// <summary>
     /// Stores the computed hash code of this <seealso cref="PredictionContext"/>. The hash
     /// code is computed in parts to match the following reference algorithm.
@@ -41,6 +41,11 @@ size_t ProfilingATNSimulator::adaptivePredict(TokenStream *input, size_t decisio
   _decisions[decision].timeInPrediction += duration_cast<nanoseconds>(stop - start).count();
   _decisions[decision].invocations++;
 
+  if (_sllStopIndex < 0) {
+    // Answered from the decision's LL(1) table, which looks at exactly one token.
+    _sllStopIndex = static_cast<int>(_startIndex);
+  }
+
   long long SLL_k = _sllStopIndex - _startIndex + 1;
   _decisions[decision].SLL_TotalLook += SLL_k;
   _decisions[decision].SLL_MinLook = _decisions[decision].SLL_MinLook == 0 ? SLL_k : std::min(_decisions[decision].SLL_MinLook, SLL_k);
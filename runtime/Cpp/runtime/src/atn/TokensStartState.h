@@ -6,6 +6,8 @@
 #pragma once
 
 #include "atn/DecisionState.h"
+#include "atn/LexerCharClasses.h"
+#include "atn/LexerKeywordTable.h"
 
 namespace antlr4 {
 namespace atn {
@@ -14,6 +16,14 @@ namespace atn {
   class ANTLR4CPP_PUBLIC TokensStartState final : public DecisionState {
 
   public:
+    /// The character classes of the mode started by this state, which key the edges of the mode's DFA for code
+    /// points beyond LexerATNSimulator::MAX_DFA_EDGE. Empty if they were not generated (see
+    /// ATNDeserializationOptions::isGenerateLexerCharClasses()), in which case only ASCII gets DFA edges.
+    LexerCharClasses charClasses;
+
+    /// The keywords of the mode, see LexerKeywordTable::install(). Empty by default.
+    LexerKeywordTable keywords;
+
     virtual size_t getStateType() override;
   };
 
@@ -35,6 +35,8 @@ DFA::DFA(atn::DecisionState *atnStartState, size_t decision)
 DFA::DFA(DFA &&other) : atnStartState(other.atnStartState), s0(other.s0), decision(other.decision) {
   // Source states are implicitly cleared by the move.
   states = std::move(other.states);
+  _tokenTypeToSlot = std::move(other._tokenTypeToSlot);
+  _slotToTokenType = std::move(other._slotToTokenType);
 
   other.atnStartState = nullptr;
   other.decision = 0;
@@ -98,6 +100,34 @@ std::vector<DFAState *> DFA::getStates() const {
   return result;
 }
 
+size_t DFA::addEdgeSlot(size_t tokenType) {
+  size_t slot = getEdgeSlot(tokenType);
+  if (slot != INVALID_INDEX) {
+    return slot;
+  }
+
+  size_t index = tokenType + 1;
+  if (index > std::numeric_limits<uint16_t>::max() || _slotToTokenType.size() >= std::numeric_limits<uint16_t>::max()) {
+    return INVALID_INDEX;
+  }
+
+  if (index >= _tokenTypeToSlot.size()) {
+    _tokenTypeToSlot.resize(index + 1, 0);
+  }
+  _slotToTokenType.push_back(tokenType);
+  _tokenTypeToSlot[index] = static_cast<uint16_t>(_slotToTokenType.size());
+
+  return _slotToTokenType.size() - 1;
+}
+
+size_t DFA::getEdgeSlotCount() const {
+  return _slotToTokenType.size();
+}
+
+size_t DFA::getEdgeSlotTokenType(size_t slot) const {
+  return _slotToTokenType[slot];
+}
+
 std::string DFA::toString(const Vocabulary &vocabulary) const {
   if (s0 == nullptr) {
     return "";
@@ -71,7 +71,36 @@ namespace dfa {
 
     virtual std::string toLexerString();
 
+    /// Parser DFAs address the outgoing edges of their states through a compact remapping of the token types
+    /// seen by this decision: each token type is assigned a slot in DFAState::denseEdges, so the edge arrays
+    /// only cover the (usually few) token types which can follow the decision instead of the whole vocabulary.
+    /// The remapping is seeded with the LL(1) lookahead of the decision and grows as new token types show up.
+    ///
+    /// All slot functions must be called with the edge lock of the ATN simulator held.
+
+    /// Returns the edge slot of the given token type (EOF included) or INVALID_INDEX if it has none yet.
+    size_t getEdgeSlot(size_t tokenType) const {
+      size_t index = tokenType + 1; // Shift up by 1 so EOF (-1) maps to index 0.
+      if (index >= _tokenTypeToSlot.size()) {
+        return INVALID_INDEX;
+      }
+      return static_cast<size_t>(_tokenTypeToSlot[index]) - 1; // Unmapped entries are 0 and wrap to INVALID_INDEX.
+    }
+
+    /// Returns the edge slot of the given token type, assigning the next free slot if it has none yet.
+    /// Returns INVALID_INDEX if the token type cannot be remapped, in which case DFAState::edges must be used.
+    size_t addEdgeSlot(size_t tokenType);
+
+    size_t getEdgeSlotCount() const;
+
+    /// Returns the token type the given edge slot was assigned to.
+    size_t getEdgeSlotTokenType(size_t slot) const;
+
   private:
+    /// Token type + 1 -> edge slot + 1. 0 marks a token type without slot.
+    std::vector<uint16_t> _tokenTypeToSlot;
+    std::vector<size_t> _slotToTokenType;
+
     /**
      * {@code true} if this DFA is for a precedence decision; otherwise,
      * {@code false}. This is the backing field for {@link #isPrecedenceDfa}.
@@ -24,11 +24,22 @@ std::string DFASerializer::toString() const {
   std::stringstream ss;
   std::vector<DFAState *> states = _dfa->getStates();
   for (auto *s : states) {
-    for (size_t i = 0; i < s->edges.size(); i++) {
-      DFAState *t = s->edges[i];
+    // Collect the edges from both the sparse map and the dense slots, ordered by symbol with EOF first.
+    std::map<size_t, DFAState *> edges;
+    for (const auto &edge : s->edges) {
+      edges[edge.first + 1] = edge.second;
+    }
+    for (size_t slot = 0; slot < s->denseEdges.size(); ++slot) {
+      if (s->denseEdges[slot] != nullptr) {
+        edges[getDenseEdgeSymbol(slot) + 1] = s->denseEdges[slot];
+      }
+    }
+
+    for (const auto &edge : edges) {
+      DFAState *t = edge.second;
       if (t != nullptr && t->stateNumber != INT32_MAX) {
         ss << getStateString(s);
-        std::string label = getEdgeLabel(i);
+        std::string label = getEdgeLabel(edge.first - 1);
         ss << "-" << label << "->" << getStateString(t) << "\n";
       }
     }
@@ -41,6 +52,10 @@ std::string DFASerializer::getEdgeLabel(size_t i) const {
   return _vocabulary.getDisplayName(i); // ml: no longer needed -1 as we use a map for edges, without offset.
 }
 
+size_t DFASerializer::getDenseEdgeSymbol(size_t slot) const {
+  return _dfa->getEdgeSlotTokenType(slot);
+}
+
 std::string DFASerializer::getStateString(DFAState *s) const {
   size_t n = s->stateNumber;
 
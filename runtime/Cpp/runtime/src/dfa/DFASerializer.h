@@ -20,6 +20,9 @@ namespace dfa {
 
   protected:
     virtual std::string getEdgeLabel(size_t i) const;
+
+    /// Returns the symbol the edges in slot {@code slot} of DFAState::denseEdges are taken on.
+    virtual size_t getDenseEdgeSymbol(size_t slot) const;
     virtual std::string getStateString(DFAState *s) const;
 
   private:
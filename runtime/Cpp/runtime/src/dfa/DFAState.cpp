@@ -6,6 +6,7 @@
 #include "atn/ATNConfigSet.h"
 #include "atn/SemanticContext.h"
 #include "atn/ATNConfig.h"
+#include "atn/ATNState.h"
 #include "misc/MurmurHash.h"
 
 #include "dfa/DFAState.h"
@@ -13,6 +14,33 @@
 using namespace antlr4::dfa;
 using namespace antlr4::atn;
 
+namespace {
+
+  /// A hash of the (ATN state, alt) pairs of a configuration set in sorted order, together with the flags
+  /// ATNConfigSet::operator== compares. With the list hash of the set it fingerprints the set after its
+  /// configurations were released.
+  size_t digest(const ATNConfigSet &configs) {
+    std::vector<std::pair<size_t, size_t>> pairs;
+    pairs.reserve(configs.configs.size());
+    for (const auto &config : configs.configs) {
+      pairs.emplace_back(config->state->stateNumber, config->alt);
+    }
+    std::sort(pairs.begin(), pairs.end());
+
+    size_t hash = antlr4::misc::MurmurHash::initialize(11);
+    for (const auto &pair : pairs) {
+      hash = antlr4::misc::MurmurHash::update(hash, pair.first);
+      hash = antlr4::misc::MurmurHash::update(hash, pair.second);
+    }
+    hash = antlr4::misc::MurmurHash::update(hash, configs.uniqueAlt);
+    hash = antlr4::misc::MurmurHash::update(hash, configs.fullCtx ? 1 : 0);
+    hash = antlr4::misc::MurmurHash::update(hash, configs.hasSemanticContext ? 1 : 0);
+    hash = antlr4::misc::MurmurHash::update(hash, configs.dipsIntoOuterContext ? 1 : 0);
+    return antlr4::misc::MurmurHash::finish(hash, 2 * pairs.size() + 4);
+  }
+
+}
+
 DFAState::PredPrediction::PredPrediction(const Ref<SemanticContext> &pred, int alt) : pred(pred) {
   InitializeInstanceFields();
   this->alt = alt;
@@ -57,7 +85,26 @@ std::set<size_t> DFAState::getAltSet() {
   return alts;
 }
 
+bool DFAState::compact() {
+  if (configs == nullptr || !isAcceptState || requiresFullContext || !predicates.empty()) {
+    return false;
+  }
+
+  _compactedHashCode = hashCode();
+  _compactedDigest = digest(*configs);
+  configs.reset();
+  return true;
+}
+
+bool DFAState::isCompacted() const {
+  return configs == nullptr && isAcceptState;
+}
+
 size_t DFAState::hashCode() const {
+  if (configs == nullptr) {
+    return _compactedHashCode;
+  }
+
   size_t hash = misc::MurmurHash::initialize(7);
   hash = misc::MurmurHash::update(hash, configs->hashCode());
   hash = misc::MurmurHash::finish(hash, 1);
@@ -70,7 +117,22 @@ bool DFAState::operator == (const DFAState &o) const {
     return true;
   }
 
-  return *configs == *o.configs;
+  if (configs != nullptr && o.configs != nullptr) {
+    return *configs == *o.configs;
+  }
+  if ((configs == nullptr && !isCompacted()) || (o.configs == nullptr && !o.isCompacted())) {
+    return false;
+  }
+
+  // At least one side is compacted: compare the fingerprints of the configuration sets. Both are accept
+  // states then, so equal fingerprints with the same prediction behave the same even on a hash collision.
+  if (hashCode() != o.hashCode() || isAcceptState != o.isAcceptState || prediction != o.prediction ||
+      requiresFullContext != o.requiresFullContext || !predicates.empty() || !o.predicates.empty()) {
+    return false;
+  }
+  size_t digestA = configs == nullptr ? _compactedDigest : digest(*configs);
+  size_t digestB = o.configs == nullptr ? o._compactedDigest : digest(*o.configs);
+  return digestA == digestB;
 }
 
 std::string DFAState::toString() {
@@ -96,5 +158,9 @@ void DFAState::InitializeInstanceFields() {
   stateNumber = -1;
   isAcceptState = false;
   prediction = 0;
+  isLexerSkip = false;
+  lexerChannel = INVALID_INDEX;
   requiresFullContext = false;
+  _compactedHashCode = 0;
+  _compactedDigest = 0;
 }
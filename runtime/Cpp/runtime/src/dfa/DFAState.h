@@ -61,6 +61,13 @@ namespace dfa {
     //     Watch out: we no longer have the -1 offset, as it isn't needed anymore.
     std::unordered_map<size_t, DFAState *> edges;
 
+    /// Parser DFA states keep their edges in this array instead, indexed by the slot the owning DFA assigned to
+    /// the token type (see DFA::getEdgeSlot()). Entries are null if there is no edge yet for that token type.
+    /// The array is only allocated once the first edge is added, so accept states don't pay for it.
+    /// Lexer DFA states index it by character class for code points beyond ASCII, if their mode has classes (see
+    /// TokensStartState::charClasses). ASCII code points keep their own entries in edges.
+    std::vector<DFAState *> denseEdges;
+
     bool isAcceptState;
 
     /// if accept state, what ttype do we match or alt do we predict?
@@ -70,6 +77,16 @@ namespace dfa {
 
     Ref<atn::LexerActionExecutor> lexerActionExecutor;
 
+    /// Set for lexer accept states whose actions all are skip: if the lexer allows it (see
+    /// Lexer::setInlineSkipAndChannel()), the lexer ATN simulator continues with the next token right away,
+    /// without executing the actions and returning to the lexer.
+    bool isLexerSkip;
+
+    /// For lexer accept states whose actions all set the channel, the channel of the last one, otherwise
+    /// INVALID_INDEX. If the lexer allows it, the simulator sets it directly on the lexer, instead of executing
+    /// the actions.
+    size_t lexerChannel;
+
     /// <summary>
     /// Indicates that this state was created during SLL prediction that
     /// discovered a conflict between the configurations in the state. Future
@@ -105,6 +122,18 @@ namespace dfa {
     /// </summary>
     virtual std::set<size_t> getAltSet();
 
+    /// Releases the configuration set of a state which no longer needs it for prediction. This is the case for
+    /// parser accept states which neither require full context nor carry predicates: prediction stops there and
+    /// only the predicted alt is read. A fingerprint of the configurations (their hash code and a digest of
+    /// their sorted state/alt pairs) is retained, so recomputed states still find the compacted one in
+    /// DFA::states instead of being added again.
+    ///
+    /// Returns true if the configurations were released.
+    bool compact();
+
+    /// Returns true if this state has been compacted, i.e. {@link #configs} is null.
+    bool isCompacted() const;
+
     virtual size_t hashCode() const;
 
     /// Two DFAState instances are equal if their ATN configuration sets
@@ -137,6 +166,12 @@ namespace dfa {
     };
 
   private:
+    /// Only valid when compacted; the hash of the configuration set at the time it was released.
+    size_t _compactedHashCode;
+
+    /// Only valid when compacted; the digest of the sorted state/alt pairs of the released configuration set.
+    size_t _compactedDigest;
+
     void InitializeInstanceFields();
   };
 
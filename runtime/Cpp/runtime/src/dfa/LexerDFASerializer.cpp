@@ -4,17 +4,44 @@
  */
 
 #include "Vocabulary.h"
+#include "atn/LexerATNSimulator.h"
+#include "atn/TokensStartState.h"
+#include "dfa/DFA.h"
+#include "misc/IntervalSet.h"
+#include "support/CPPUtils.h"
 
 #include "dfa/LexerDFASerializer.h"
 
 using namespace antlr4::dfa;
+using namespace antlrcpp;
 
-LexerDFASerializer::LexerDFASerializer(DFA *dfa) : DFASerializer(dfa, Vocabulary()) {
+LexerDFASerializer::LexerDFASerializer(DFA *dfa) : DFASerializer(dfa, Vocabulary()), _charClasses(nullptr) {
+  if (is<atn::TokensStartState *>(dfa->atnStartState)) {
+    _charClasses = &static_cast<atn::TokensStartState *>(dfa->atnStartState)->charClasses;
+  }
 }
 
 LexerDFASerializer::~LexerDFASerializer() {
 }
 
 std::string LexerDFASerializer::getEdgeLabel(size_t i) const {
+  if (i > atn::LexerATNSimulator::MAX_DFA_EDGE && _charClasses != nullptr && _charClasses->size() > 0) {
+    misc::IntervalSet codePoints = getClassCodePoints(_charClasses->getClass(i));
+    if (codePoints.size() > 1) {
+      return codePoints.toString(true);
+    }
+  }
   return std::string("'") + static_cast<char>(i) + "'";
 }
+
+size_t LexerDFASerializer::getDenseEdgeSymbol(size_t slot) const {
+  if (_charClasses == nullptr) {
+    return slot;
+  }
+  return static_cast<size_t>(getClassCodePoints(slot).getMinElement());
+}
+
+antlr4::misc::IntervalSet LexerDFASerializer::getClassCodePoints(size_t charClass) const {
+  return _charClasses->getCodePoints(charClass).subtract(
+    misc::IntervalSet::of(0, static_cast<ssize_t>(atn::LexerATNSimulator::MAX_DFA_EDGE)));
+}
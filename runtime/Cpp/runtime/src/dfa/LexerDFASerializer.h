@@ -6,6 +6,7 @@
 #pragma once
 
 #include "dfa/DFASerializer.h"
+#include "misc/IntervalSet.h"
 
 namespace antlr4 {
 namespace dfa {
@@ -17,6 +18,16 @@ namespace dfa {
 
   protected:
     virtual std::string getEdgeLabel(size_t i) const override;
+
+    /// Lexer DFA states with dense edges have one per character class, which is labeled with all its code points
+    /// beyond ASCII. ASCII code points have edges of their own, so these are listed one by one as before.
+    virtual size_t getDenseEdgeSymbol(size_t slot) const override;
+
+  private:
+    /// The code points of the given class which are keyed on the class, i.e. those beyond ASCII.
+    misc::IntervalSet getClassCodePoints(size_t charClass) const;
+
+    const atn::LexerCharClasses *_charClasses;
   };
 
 } // namespace atn
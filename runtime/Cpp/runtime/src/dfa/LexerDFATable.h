@@ -0,0 +1,63 @@
+/* Copyright (c) 2012-2017 The ANTLR Project. All rights reserved.
+ * Use of this file is governed by the BSD 3-clause license that
+ * can be found in the LICENSE.txt file in the project root.
+ */
+
+#pragma once
+
+#include "antlr4-common.h"
+
+namespace antlr4 {
+namespace dfa {
+
+  /// A fully determinized and minimized lexer DFA, as produced by atn::LexerDFACompiler and run by
+  /// atn::LexerDFATableSimulator. All members are plain pointers to arrays, so a table can be emitted as
+  /// {@code constexpr} C++ source (see LexerDFACompiler::toCppSource()) and used without any setup.
+  ///
+  /// Code points are first mapped to character classes, code points in the same class take the same
+  /// transitions in every state. The map has two levels: {@code classPages[c >> 8]} selects a block of 256
+  /// entries in {@code classBlocks}, indexed by the low byte of the code point.
+  struct LexerDFATable {
+    static constexpr size_t PAGE_COUNT = 0x110000 >> 8;
+    static constexpr size_t BLOCK_SIZE = 256;
+
+    /// Number of ATN states of the lexer the table was compiled from, to catch mismatches.
+    size_t atnStateCount;
+
+    const uint16_t *classPages; // PAGE_COUNT entries.
+    const uint16_t *classBlocks;
+    size_t classCount;
+    size_t eofClass; // The class of Token::EOF.
+
+    size_t stateCount;
+    const int32_t *transitions; // stateCount * classCount entries, -1 for no transition.
+
+    /// Per state: the predicted token type if the state accepts, otherwise 0.
+    const uint32_t *acceptPredictions;
+
+    /// Per state: 1 + index of the action list to execute on accept, 0 if there are none.
+    const uint32_t *acceptActions;
+
+    /// Action list i consists of {@code actions[actionOffsets[i]]} up to {@code actions[actionOffsets[i + 1]]},
+    /// which are indexes into ATN::lexerActions.
+    size_t actionListCount;
+    const uint32_t *actionOffsets; // actionListCount + 1 entries.
+    const uint32_t *actions;
+
+    /// Per mode: the start state, or -1 if the mode could not be compiled (it uses predicates or position
+    /// dependent actions) and has to be simulated on the ATN.
+    size_t modeCount;
+    const int32_t *modeStartStates;
+
+    /// Returns the class of the given code point, or classCount (which has no transitions) if it is not
+    /// a valid code point.
+    size_t getClass(size_t codePoint) const {
+      if (codePoint >= PAGE_COUNT * BLOCK_SIZE) {
+        return classCount;
+      }
+      return classBlocks[classPages[codePoint >> 8] * BLOCK_SIZE + (codePoint & 0xFF)];
+    }
+  };
+
+} // namespace dfa
+} // namespace antlr4
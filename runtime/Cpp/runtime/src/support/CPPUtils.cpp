@@ -5,6 +5,8 @@
 
 #include "support/CPPUtils.h"
 
+#include <thread>
+
 namespace antlrcpp {
 
   std::string join(const std::vector<std::string> &strings, const std::string &separator) {
@@ -204,4 +206,40 @@ namespace antlrcpp {
     return result;
   }
 
+  size_t getThreadCount(size_t threadCount) {
+    if (threadCount == 0) {
+      threadCount = std::max<size_t>(std::thread::hardware_concurrency(), 1);
+    }
+    return threadCount;
+  }
+
+  void runConcurrently(size_t count, size_t threadCount, const std::function<void(size_t)> &task) {
+    std::vector<std::exception_ptr> errors(count);
+    std::atomic<size_t> next(0);
+    auto worker = [&]() {
+      for (size_t i = next++; i < count; i = next++) {
+        try {
+          task(i);
+        } catch (...) {
+          errors[i] = std::current_exception();
+        }
+      }
+    };
+
+    std::vector<std::thread> threads;
+    for (size_t i = 1; i < std::min(getThreadCount(threadCount), count); ++i) {
+      threads.emplace_back(worker);
+    }
+    worker();
+    for (std::thread &thread : threads) {
+      thread.join();
+    }
+
+    for (const std::exception_ptr &error : errors) {
+      if (error) {
+        std::rethrow_exception(error);
+      }
+    }
+  }
+
 } // namespace antlrcpp
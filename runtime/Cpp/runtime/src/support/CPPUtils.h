@@ -64,4 +64,11 @@ namespace antlrcpp {
   // Get the error text from an exception pointer or the current exception.
   std::string what(std::exception_ptr eptr = std::current_exception());
 
+  // Returns threadCount, or the number of hardware threads (at least 1) if it is 0.
+  size_t getThreadCount(size_t threadCount);
+
+  // Runs task(i) for each i < count on up to getThreadCount(threadCount) threads, the calling one included. The
+  // tasks are handed out in order of i. Once all are done, rethrows the exception of the lowest i whose task threw.
+  void runConcurrently(size_t count, size_t threadCount, const std::function<void(size_t)> &task);
+
 } // namespace antlrcpp
@@ -12,6 +12,7 @@ namespace antlr4 {
   class ANTLRInputStream;
   class BailErrorStrategy;
   class BaseErrorListener;
+  class BatchParser;
   class BufferedTokenStream;
   class CharStream;
   class CommonToken;
@@ -24,6 +25,7 @@ namespace antlr4 {
   class FailedPredicateException;
   class IllegalArgumentException;
   class IllegalStateException;
+  class IncrementalLexer;
   class InputMismatchException;
   class IntStream;
   class InterpreterRuleContext;
@@ -31,24 +33,29 @@ namespace antlr4 {
   class LexerInterpreter;
   class LexerNoViableAltException;
   class ListTokenSource;
+  class MappedTokenSource;
   class NoSuchElementException;
   class NoViableAltException;
   class NullPointerException;
   class ParseCancellationException;
   class Parser;
   class ParserInterpreter;
+  class PipelinedTokenStream;
   class ParserRuleContext;
   class ProxyErrorListener;
   class RecognitionException;
   class Recognizer;
+  class RecognizerPool;
   class RuleContext;
   class Token;
   template<typename Symbol> class TokenFactory;
+  class TokenFile;
   class TokenSource;
   class TokenStream;
   class TokenStreamRewriter;
   class UnbufferedCharStream;
   class UnbufferedTokenStream;
+  class UnbufferedUtf8CharStream;
   class WritableToken;
 
   namespace misc {
@@ -83,8 +90,11 @@ namespace antlr4 {
     class LL1Analyzer;
     class LexerAction;
     class LexerActionExecutor;
+    class LexerActionExecutorTable;
     class LexerATNConfig;
     class LexerATNSimulator;
+    class LexerCharClasses;
+    class LexerKeywordTable;
     class LexerMoreAction;
     class LexerPopModeAction;
     class LexerSkipAction;
@@ -13,3 +13,66 @@ ParseTree::ParseTree() : parent(nullptr) {
 bool ParseTree::operator == (const ParseTree &other) const {
   return &other == this;
 }
+
+ParseTreeTracker::~ParseTreeTracker() {
+  reset();
+  setRetainMemory(false);
+}
+
+void ParseTreeTracker::reset() {
+  for (const Instance &instance : _allocated) {
+    destroy(instance);
+  }
+  _allocated.clear();
+  _released.clear();
+}
+
+void ParseTreeTracker::release(const std::vector<ParseTree *> &trees) {
+  _released.insert(trees.begin(), trees.end());
+  if (_released.size() * 2 < _allocated.size())
+    return;
+
+  auto end = std::remove_if(_allocated.begin(), _allocated.end(), [this](const Instance &instance) {
+    if (_released.count(instance.tree) == 0)
+      return false;
+    destroy(instance);
+    return true;
+  });
+  _allocated.erase(end, _allocated.end());
+  _released.clear();
+}
+
+void ParseTreeTracker::setRetainMemory(bool retain) {
+  _retainMemory = retain;
+  if (!retain) {
+    for (auto &entry : _free) {
+      for (void *memory : entry.second) {
+        ::operator delete(memory);
+      }
+    }
+    _free.clear();
+  }
+}
+
+void* ParseTreeTracker::allocate(size_t size) {
+  auto iterator = _free.find(size);
+  if (iterator == _free.end() || iterator->second.empty()) {
+    return ::operator new(size);
+  }
+  void *memory = iterator->second.back();
+  iterator->second.pop_back();
+  return memory;
+}
+
+void ParseTreeTracker::deallocate(void *memory, size_t size) {
+  if (_retainMemory) {
+    _free[size].push_back(memory);
+  } else {
+    ::operator delete(memory);
+  }
+}
+
+void ParseTreeTracker::destroy(const Instance &instance) {
+  instance.tree->~ParseTree();
+  deallocate(instance.memory, instance.size);
+}
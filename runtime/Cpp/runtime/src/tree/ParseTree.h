@@ -79,22 +79,59 @@ namespace tree {
   // A class to help managing ParseTree instances without the need of a shared_ptr.
   class ANTLR4CPP_PUBLIC ParseTreeTracker {
   public:
+    ParseTreeTracker() = default;
+    ParseTreeTracker(const ParseTreeTracker &) = delete;
+    ~ParseTreeTracker();
+
+    ParseTreeTracker& operator = (const ParseTreeTracker &) = delete;
+
     template<typename T, typename ... Args>
     T* createInstance(Args&& ... args) {
       static_assert(std::is_base_of<ParseTree, T>::value, "Argument must be a parse tree type");
-      T* result = new T(args...);
-      _allocated.push_back(result);
+      void *memory = allocate(sizeof(T));
+      T* result;
+      try {
+        result = new (memory) T(args...);
+      } catch (...) {
+        deallocate(memory, sizeof(T));
+        throw;
+      }
+      _allocated.push_back({ result, memory, sizeof(T) });
       return result;
     }
 
-    void reset() {
-      for (auto * entry : _allocated)
-        delete entry;
-      _allocated.clear();
-    }
+    // Deletes all instances, keeping their memory.
+    void reset();
+
+    // Deletes instances which are no longer used, e.g. the parts of a tree an incremental parse did not reuse.
+    // They are deleted in bulk once they make up half of the instances, so this is amortized constant time each.
+    void release(const std::vector<ParseTree *> &trees);
+
+    // Whether the memory of deleted instances is kept and reused for new instances of the same size, so a parser
+    // parsing one input after another (see Parser::reset()) allocates memory only for trees larger than those
+    // before. The kept memory is only freed when the tracker is destroyed or retention is turned off again.
+    // Off by default, RecognizerPool turns it on for its parsers.
+    void setRetainMemory(bool retain);
+
+    bool isRetainingMemory() const { return _retainMemory; }
 
   private:
-    std::vector<ParseTree *> _allocated;
+    struct Instance {
+      ParseTree *tree;
+      void *memory; // Where the instance starts, which differs from tree with virtual bases.
+      size_t size;
+    };
+
+    std::vector<Instance> _allocated;
+    std::unordered_set<ParseTree *> _released;
+
+    // The memory of deleted instances, by size. Only used if _retainMemory is set.
+    std::unordered_map<size_t, std::vector<void *>> _free;
+    bool _retainMemory = false;
+
+    void* allocate(size_t size);
+    void deallocate(void *memory, size_t size);
+    void destroy(const Instance &instance);
   };
 
 
@@ -0,0 +1,47 @@
+#include <thread>
+
+#include "gtest/gtest.h"
+#include "ANTLRInputStream.h"
+#include "Token.h"
+#include "atn/ATNStatistics.h"
+
+#include "ExprGrammar.h"
+
+namespace antlr4 {
+namespace {
+
+  using test::ExprGrammar;
+
+  // Returns the number of tokens before EOF. EOF itself is emitted without a match() call.
+  size_t lex(const std::string &text) {
+    ANTLRInputStream input(text);
+    auto lexer = ExprGrammar::createLexer(&input);
+    size_t count = 0;
+    while (lexer->nextToken()->getType() != Token::EOF) {
+      ++count;
+    }
+    return count;
+  }
+
+  TEST(ATNStatisticsTest, AggregatesThreads) {
+    atn::ATNStatistics::reset();
+    lex("def f(x) { }");
+    EXPECT_EQ(atn::ATNStatistics::snapshot().lexerMatchCalls, 0u);
+
+    atn::ATNStatistics::setEnabled(true);
+    // Each input also has 3 white space runs, which are matched and skipped.
+    size_t expected = lex("def f(x) { }") + 3;
+    std::thread([&expected] {
+      // Counts of exited threads are kept.
+      expected += lex("def g(y) { }") + 3;
+    }).join();
+    atn::ATNStatistics::setEnabled(false);
+
+    EXPECT_EQ(atn::ATNStatistics::snapshot().lexerMatchCalls, expected);
+
+    atn::ATNStatistics::reset();
+    EXPECT_EQ(atn::ATNStatistics::snapshot().lexerMatchCalls, 0u);
+  }
+
+}
+}
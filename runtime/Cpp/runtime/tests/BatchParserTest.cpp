@@ -0,0 +1,79 @@
+#include <string>
+
+#include "gtest/gtest.h"
+#include "BatchParser.h"
+#include "Exceptions.h"
+#include "ParserInterpreter.h"
+#include "ParserRuleContext.h"
+
+#include "ExprGrammar.h"
+
+namespace antlr4 {
+namespace {
+
+  using test::ExprGrammar;
+
+  BatchParser createBatchParser() {
+    return BatchParser(
+      [](CharStream *input) {
+        auto lexer = ExprGrammar::createLexer(input);
+        lexer->removeErrorListeners();
+        return lexer;
+      },
+      [](TokenStream *input) {
+        auto parser = ExprGrammar::createParser(input);
+        parser->removeErrorListeners();
+        return parser;
+      });
+  }
+
+  TEST(BatchParserTest, ReturnsOutcomesInOrder) {
+    std::vector<std::string> documents;
+    for (size_t i = 0; i < 200; ++i) {
+      std::string name = std::string(1, static_cast<char>('a' + i % 26));
+      if (i % 17 == 5) {
+        documents.push_back("def " + name + "(x) { " + name + " = ; }");
+      } else {
+        documents.push_back("def " + name + "(x) { return " + name + " * " + std::to_string(i) + "; }");
+      }
+    }
+
+    BatchParser parser(createBatchParser());
+    parser.setThreadCount(4);
+    BatchParser::ParseFunction<std::string> parseFunction = [](Parser &parser) {
+      ParserRuleContext *tree = static_cast<ParserInterpreter &>(parser).parse(ExprGrammar::RULE_prog);
+      if (parser.getTokenStream()->LT(1)->getText() == "999") {
+        throw IllegalStateException("cannot parse 999");
+      }
+      return tree->getText();
+    };
+    documents[42] = "def x(y) { return x; } 999";
+
+    for (size_t batch = 0; batch < 3; ++batch) {
+      auto outcomes = parser.parse(documents, parseFunction);
+      ASSERT_EQ(outcomes.size(), documents.size());
+      for (size_t i = 0; i < documents.size(); ++i) {
+        if (i == 42) {
+          EXPECT_NE(outcomes[i].error, nullptr);
+          continue;
+        }
+        EXPECT_EQ(outcomes[i].error, nullptr);
+        if (i % 17 == 5) {
+          ASSERT_EQ(outcomes[i].syntaxErrors.size(), 1u) << i;
+          EXPECT_EQ(outcomes[i].syntaxErrors[0], "line 1:15 mismatched input ';' expecting {'(', ID, INT}");
+        } else {
+          EXPECT_TRUE(outcomes[i].syntaxErrors.empty()) << i;
+          std::string expected = documents[i];
+          expected.erase(std::remove(expected.begin(), expected.end(), ' '), expected.end());
+          EXPECT_EQ(outcomes[i].result, expected);
+        }
+      }
+    }
+
+    // The recognizers are kept for the next batches.
+    EXPECT_LE(parser.getRecognizerPool().size(), 4u);
+    EXPECT_TRUE(parser.parse(std::vector<std::string>(), parseFunction).empty());
+  }
+
+}
+}
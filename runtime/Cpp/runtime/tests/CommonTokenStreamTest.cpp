@@ -0,0 +1,100 @@
+#include "gtest/gtest.h"
+#include "CommonToken.h"
+#include "CommonTokenStream.h"
+#include "Exceptions.h"
+#include "ListTokenSource.h"
+#include "Token.h"
+
+namespace antlr4 {
+namespace {
+
+  // "a" and "b" on the default channel, the others hidden.
+  std::vector<std::unique_ptr<Token>> createTokens(const std::vector<std::string> &texts) {
+    std::vector<std::unique_ptr<Token>> tokens;
+    for (const std::string &text : texts) {
+      auto token = std::make_unique<CommonToken>(1, text);
+      if (text != "a" && text != "b") {
+        token->setChannel(Token::HIDDEN_CHANNEL);
+      }
+      tokens.push_back(std::move(token));
+    }
+    return tokens;
+  }
+
+  std::string join(const std::vector<Token *> &tokens) {
+    std::string result;
+    for (Token *token : tokens) {
+      result += token->getText();
+    }
+    return result;
+  }
+
+  TEST(CommonTokenStreamTest, SkipsOffChannelTokens) {
+    ListTokenSource source(createTokens({ " ", "a", " ", "/**/", "b", "a", " ", "b", " " }));
+    CommonTokenStream tokens(&source);
+
+    EXPECT_EQ(tokens.index(), 1u);
+    EXPECT_EQ(tokens.LT(1)->getTokenIndex(), 1u);
+    EXPECT_EQ(tokens.LT(2)->getTokenIndex(), 4u);
+    EXPECT_EQ(tokens.LT(4)->getTokenIndex(), 7u);
+    EXPECT_EQ(tokens.LA(5), Token::EOF);
+    EXPECT_EQ(tokens.LA(9), Token::EOF);
+    EXPECT_EQ(tokens.LT(-1), nullptr);
+
+    tokens.consume();
+    EXPECT_EQ(tokens.index(), 4u);
+    tokens.consume();
+    EXPECT_EQ(tokens.LT(-1)->getTokenIndex(), 4u);
+    EXPECT_EQ(tokens.LT(-2)->getTokenIndex(), 1u);
+    EXPECT_EQ(tokens.LT(-3), nullptr);
+
+    tokens.seek(6);
+    EXPECT_EQ(tokens.index(), 7u);
+    EXPECT_EQ(join(tokens.getHiddenTokensToLeft(4)), " /**/");
+    EXPECT_EQ(join(tokens.getHiddenTokensToRight(1)), " /**/");
+    EXPECT_EQ(join(tokens.getHiddenTokensToRight(7)), " ");
+    EXPECT_TRUE(tokens.getHiddenTokensToLeft(5).empty());
+    EXPECT_EQ(tokens.getNumberOfOnChannelTokens(), 5);
+
+    // Replacing tokens updates the index from there on.
+    tokens.replace(2, 5, createTokens({ "b", " " }));
+    EXPECT_EQ(tokens.LT(1)->getTokenIndex(), 1u);
+    EXPECT_EQ(tokens.LT(2)->getTokenIndex(), 2u);
+    EXPECT_EQ(tokens.LT(3)->getTokenIndex(), 4u);
+    EXPECT_EQ(tokens.LT(4)->getTokenIndex(), 6u);
+    EXPECT_EQ(tokens.getNumberOfOnChannelTokens(), 5);
+  }
+
+  // Throws after returning the given number of tokens.
+  class FailingTokenSource : public ListTokenSource {
+  public:
+    FailingTokenSource(std::vector<std::unique_ptr<Token>> tokens, size_t failAfter)
+      : ListTokenSource(std::move(tokens)), _remaining(failAfter) {
+    }
+
+    std::unique_ptr<Token> nextToken() override {
+      if (_remaining == 0) {
+        throw IllegalStateException("token source failed");
+      }
+      --_remaining;
+      return ListTokenSource::nextToken();
+    }
+
+  private:
+    size_t _remaining;
+  };
+
+  TEST(CommonTokenStreamTest, IndexesTokensBeforeError) {
+    FailingTokenSource source(createTokens({ "a", " ", "b", "a" }), 3);
+    CommonTokenStream tokens(&source);
+    EXPECT_THROW(tokens.fill(), IllegalStateException);
+
+    // The tokens fetched before the error keep their place in the stream.
+    ASSERT_EQ(tokens.size(), 3u);
+    for (size_t i = 0; i < tokens.size(); ++i) {
+      EXPECT_EQ(tokens.get(i)->getTokenIndex(), i);
+    }
+  }
+
+}
+}
@@ -0,0 +1,199 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "LexerInterpreter.h"
+#include "ParserInterpreter.h"
+#include "Vocabulary.h"
+#include "atn/ATN.h"
+#include "atn/ATNDeserializer.h"
+
+namespace antlr4 {
+namespace test {
+
+  // ATNs of the grammar below, taken from runtime/Python3/tests/expr. Used to drive the lexer and parser
+  // interpreters in tests, so no generated code is needed.
+  //
+  // grammar Expr;
+  // prog:   func+ ;
+  // func:  'def' ID '(' arg (',' arg)* ')' body ;
+  // body:  '{' stat+ '}' ;
+  // arg :  ID ;
+  // stat:   expr ';' | ID '=' expr ';' | 'return' expr ';' | ';' ;
+  // expr:   expr ('*'|'/') expr | expr ('+'|'-') expr | primary ;
+  // primary :   INT | ID | '(' expr ')' ;
+  // MUL : '*' ; DIV : '/' ; ADD : '+' ; SUB : '-' ; RETURN : 'return' ;
+  // ID  : [a-zA-Z]+ ; INT : [0-9]+ ; NEWLINE : '\r'? '\n' -> skip ; WS : [ \t]+ -> skip ;
+  struct ExprGrammar final {
+    enum {
+      T__0 = 1, T__1 = 2, T__2 = 3, T__3 = 4, T__4 = 5, T__5 = 6, T__6 = 7, T__7 = 8, MUL = 9, DIV = 10,
+      ADD = 11, SUB = 12, RETURN = 13, ID = 14, INT = 15, NEWLINE = 16, WS = 17
+    };
+
+    enum {
+      RULE_prog = 0, RULE_func = 1, RULE_body = 2, RULE_arg = 3, RULE_stat = 4, RULE_expr = 5, RULE_primary = 6
+    };
+
+    static const atn::ATN& lexerATN() {
+      static const atn::ATN atn = atn::ATNDeserializer().deserialize(serializedLexerATN());
+      return atn;
+    }
+
+    static const std::vector<uint16_t>& serializedLexerATN() {
+      static const std::vector<uint16_t> serialized = {
+        0x3, 0x608b, 0xa72a, 0x8133, 0xb9ed, 0x417c, 0x3be7, 0x7786, 0x5964, 0x2, 0x13, 0x5e, 0x8, 0x1,
+        0x4, 0x2, 0x9, 0x2, 0x4, 0x3, 0x9, 0x3, 0x4, 0x4, 0x9, 0x4, 0x4, 0x5, 0x9, 0x5, 0x4, 0x6, 0x9,
+        0x6, 0x4, 0x7, 0x9, 0x7, 0x4, 0x8, 0x9, 0x8, 0x4, 0x9, 0x9, 0x9, 0x4, 0xa, 0x9, 0xa, 0x4, 0xb,
+        0x9, 0xb, 0x4, 0xc, 0x9, 0xc, 0x4, 0xd, 0x9, 0xd, 0x4, 0xe, 0x9, 0xe, 0x4, 0xf, 0x9, 0xf, 0x4,
+        0x10, 0x9, 0x10, 0x4, 0x11, 0x9, 0x11, 0x4, 0x12, 0x9, 0x12, 0x3, 0x2, 0x3, 0x2, 0x3, 0x2, 0x3,
+        0x2, 0x3, 0x3, 0x3, 0x3, 0x3, 0x4, 0x3, 0x4, 0x3, 0x5, 0x3, 0x5, 0x3, 0x6, 0x3, 0x6, 0x3, 0x7,
+        0x3, 0x7, 0x3, 0x8, 0x3, 0x8, 0x3, 0x9, 0x3, 0x9, 0x3, 0xa, 0x3, 0xa, 0x3, 0xb, 0x3, 0xb, 0x3,
+        0xc, 0x3, 0xc, 0x3, 0xd, 0x3, 0xd, 0x3, 0xe, 0x3, 0xe, 0x3, 0xe, 0x3, 0xe, 0x3, 0xe, 0x3, 0xe,
+        0x3, 0xe, 0x3, 0xf, 0x6, 0xf, 0x48, 0xa, 0xf, 0xd, 0xf, 0xe, 0xf, 0x49, 0x3, 0x10, 0x6, 0x10,
+        0x4d, 0xa, 0x10, 0xd, 0x10, 0xe, 0x10, 0x4e, 0x3, 0x11, 0x5, 0x11, 0x52, 0xa, 0x11, 0x3, 0x11,
+        0x3, 0x11, 0x3, 0x11, 0x3, 0x11, 0x3, 0x12, 0x6, 0x12, 0x59, 0xa, 0x12, 0xd, 0x12, 0xe, 0x12,
+        0x5a, 0x3, 0x12, 0x3, 0x12, 0x2, 0x2, 0x13, 0x3, 0x3, 0x5, 0x4, 0x7, 0x5, 0x9, 0x6, 0xb, 0x7,
+        0xd, 0x8, 0xf, 0x9, 0x11, 0xa, 0x13, 0xb, 0x15, 0xc, 0x17, 0xd, 0x19, 0xe, 0x1b, 0xf, 0x1d,
+        0x10, 0x1f, 0x11, 0x21, 0x12, 0x23, 0x13, 0x3, 0x2, 0x5, 0x4, 0x2, 0x43, 0x5c, 0x63, 0x7c, 0x3,
+        0x2, 0x32, 0x3b, 0x4, 0x2, 0xb, 0xb, 0x22, 0x22, 0x2, 0x61, 0x2, 0x3, 0x3, 0x2, 0x2, 0x2, 0x2,
+        0x5, 0x3, 0x2, 0x2, 0x2, 0x2, 0x7, 0x3, 0x2, 0x2, 0x2, 0x2, 0x9, 0x3, 0x2, 0x2, 0x2, 0x2, 0xb,
+        0x3, 0x2, 0x2, 0x2, 0x2, 0xd, 0x3, 0x2, 0x2, 0x2, 0x2, 0xf, 0x3, 0x2, 0x2, 0x2, 0x2, 0x11, 0x3,
+        0x2, 0x2, 0x2, 0x2, 0x13, 0x3, 0x2, 0x2, 0x2, 0x2, 0x15, 0x3, 0x2, 0x2, 0x2, 0x2, 0x17, 0x3,
+        0x2, 0x2, 0x2, 0x2, 0x19, 0x3, 0x2, 0x2, 0x2, 0x2, 0x1b, 0x3, 0x2, 0x2, 0x2, 0x2, 0x1d, 0x3,
+        0x2, 0x2, 0x2, 0x2, 0x1f, 0x3, 0x2, 0x2, 0x2, 0x2, 0x21, 0x3, 0x2, 0x2, 0x2, 0x2, 0x23, 0x3,
+        0x2, 0x2, 0x2, 0x3, 0x25, 0x3, 0x2, 0x2, 0x2, 0x5, 0x29, 0x3, 0x2, 0x2, 0x2, 0x7, 0x2b, 0x3,
+        0x2, 0x2, 0x2, 0x9, 0x2d, 0x3, 0x2, 0x2, 0x2, 0xb, 0x2f, 0x3, 0x2, 0x2, 0x2, 0xd, 0x31, 0x3,
+        0x2, 0x2, 0x2, 0xf, 0x33, 0x3, 0x2, 0x2, 0x2, 0x11, 0x35, 0x3, 0x2, 0x2, 0x2, 0x13, 0x37, 0x3,
+        0x2, 0x2, 0x2, 0x15, 0x39, 0x3, 0x2, 0x2, 0x2, 0x17, 0x3b, 0x3, 0x2, 0x2, 0x2, 0x19, 0x3d, 0x3,
+        0x2, 0x2, 0x2, 0x1b, 0x3f, 0x3, 0x2, 0x2, 0x2, 0x1d, 0x47, 0x3, 0x2, 0x2, 0x2, 0x1f, 0x4c, 0x3,
+        0x2, 0x2, 0x2, 0x21, 0x51, 0x3, 0x2, 0x2, 0x2, 0x23, 0x58, 0x3, 0x2, 0x2, 0x2, 0x25, 0x26, 0x7,
+        0x66, 0x2, 0x2, 0x26, 0x27, 0x7, 0x67, 0x2, 0x2, 0x27, 0x28, 0x7, 0x68, 0x2, 0x2, 0x28, 0x4,
+        0x3, 0x2, 0x2, 0x2, 0x29, 0x2a, 0x7, 0x2a, 0x2, 0x2, 0x2a, 0x6, 0x3, 0x2, 0x2, 0x2, 0x2b, 0x2c,
+        0x7, 0x2e, 0x2, 0x2, 0x2c, 0x8, 0x3, 0x2, 0x2, 0x2, 0x2d, 0x2e, 0x7, 0x2b, 0x2, 0x2, 0x2e, 0xa,
+        0x3, 0x2, 0x2, 0x2, 0x2f, 0x30, 0x7, 0x7d, 0x2, 0x2, 0x30, 0xc, 0x3, 0x2, 0x2, 0x2, 0x31, 0x32,
+        0x7, 0x7f, 0x2, 0x2, 0x32, 0xe, 0x3, 0x2, 0x2, 0x2, 0x33, 0x34, 0x7, 0x3d, 0x2, 0x2, 0x34, 0x10,
+        0x3, 0x2, 0x2, 0x2, 0x35, 0x36, 0x7, 0x3f, 0x2, 0x2, 0x36, 0x12, 0x3, 0x2, 0x2, 0x2, 0x37, 0x38,
+        0x7, 0x2c, 0x2, 0x2, 0x38, 0x14, 0x3, 0x2, 0x2, 0x2, 0x39, 0x3a, 0x7, 0x31, 0x2, 0x2, 0x3a,
+        0x16, 0x3, 0x2, 0x2, 0x2, 0x3b, 0x3c, 0x7, 0x2d, 0x2, 0x2, 0x3c, 0x18, 0x3, 0x2, 0x2, 0x2, 0x3d,
+        0x3e, 0x7, 0x2f, 0x2, 0x2, 0x3e, 0x1a, 0x3, 0x2, 0x2, 0x2, 0x3f, 0x40, 0x7, 0x74, 0x2, 0x2,
+        0x40, 0x41, 0x7, 0x67, 0x2, 0x2, 0x41, 0x42, 0x7, 0x76, 0x2, 0x2, 0x42, 0x43, 0x7, 0x77, 0x2,
+        0x2, 0x43, 0x44, 0x7, 0x74, 0x2, 0x2, 0x44, 0x45, 0x7, 0x70, 0x2, 0x2, 0x45, 0x1c, 0x3, 0x2,
+        0x2, 0x2, 0x46, 0x48, 0x9, 0x2, 0x2, 0x2, 0x47, 0x46, 0x3, 0x2, 0x2, 0x2, 0x48, 0x49, 0x3, 0x2,
+        0x2, 0x2, 0x49, 0x47, 0x3, 0x2, 0x2, 0x2, 0x49, 0x4a, 0x3, 0x2, 0x2, 0x2, 0x4a, 0x1e, 0x3, 0x2,
+        0x2, 0x2, 0x4b, 0x4d, 0x9, 0x3, 0x2, 0x2, 0x4c, 0x4b, 0x3, 0x2, 0x2, 0x2, 0x4d, 0x4e, 0x3, 0x2,
+        0x2, 0x2, 0x4e, 0x4c, 0x3, 0x2, 0x2, 0x2, 0x4e, 0x4f, 0x3, 0x2, 0x2, 0x2, 0x4f, 0x20, 0x3, 0x2,
+        0x2, 0x2, 0x50, 0x52, 0x7, 0xf, 0x2, 0x2, 0x51, 0x50, 0x3, 0x2, 0x2, 0x2, 0x51, 0x52, 0x3, 0x2,
+        0x2, 0x2, 0x52, 0x53, 0x3, 0x2, 0x2, 0x2, 0x53, 0x54, 0x7, 0xc, 0x2, 0x2, 0x54, 0x55, 0x3, 0x2,
+        0x2, 0x2, 0x55, 0x56, 0x8, 0x11, 0x2, 0x2, 0x56, 0x22, 0x3, 0x2, 0x2, 0x2, 0x57, 0x59, 0x9, 0x4,
+        0x2, 0x2, 0x58, 0x57, 0x3, 0x2, 0x2, 0x2, 0x59, 0x5a, 0x3, 0x2, 0x2, 0x2, 0x5a, 0x58, 0x3, 0x2,
+        0x2, 0x2, 0x5a, 0x5b, 0x3, 0x2, 0x2, 0x2, 0x5b, 0x5c, 0x3, 0x2, 0x2, 0x2, 0x5c, 0x5d, 0x8, 0x12,
+        0x2, 0x2, 0x5d, 0x24, 0x3, 0x2, 0x2, 0x2, 0x7, 0x2, 0x49, 0x4e, 0x51, 0x5a, 0x3, 0x8, 0x2, 0x2,
+      };
+      return serialized;
+    }
+
+    static const atn::ATN& parserATN() {
+      static const atn::ATN atn = atn::ATNDeserializer().deserialize(serializedParserATN());
+      return atn;
+    }
+
+    static const std::vector<uint16_t>& serializedParserATN() {
+      static const std::vector<uint16_t> serialized = {
+        0x3, 0x608b, 0xa72a, 0x8133, 0xb9ed, 0x417c, 0x3be7, 0x7786, 0x5964, 0x3, 0x13, 0x53, 0x4, 0x2,
+        0x9, 0x2, 0x4, 0x3, 0x9, 0x3, 0x4, 0x4, 0x9, 0x4, 0x4, 0x5, 0x9, 0x5, 0x4, 0x6, 0x9, 0x6, 0x4,
+        0x7, 0x9, 0x7, 0x4, 0x8, 0x9, 0x8, 0x3, 0x2, 0x6, 0x2, 0x12, 0xa, 0x2, 0xd, 0x2, 0xe, 0x2, 0x13,
+        0x3, 0x3, 0x3, 0x3, 0x3, 0x3, 0x3, 0x3, 0x3, 0x3, 0x3, 0x3, 0x7, 0x3, 0x1c, 0xa, 0x3, 0xc, 0x3,
+        0xe, 0x3, 0x1f, 0xb, 0x3, 0x3, 0x3, 0x3, 0x3, 0x3, 0x3, 0x3, 0x4, 0x3, 0x4, 0x6, 0x4, 0x26, 0xa,
+        0x4, 0xd, 0x4, 0xe, 0x4, 0x27, 0x3, 0x4, 0x3, 0x4, 0x3, 0x5, 0x3, 0x5, 0x3, 0x6, 0x3, 0x6, 0x3,
+        0x6, 0x3, 0x6, 0x3, 0x6, 0x3, 0x6, 0x3, 0x6, 0x3, 0x6, 0x3, 0x6, 0x3, 0x6, 0x3, 0x6, 0x3, 0x6,
+        0x3, 0x6, 0x5, 0x6, 0x3b, 0xa, 0x6, 0x3, 0x7, 0x3, 0x7, 0x3, 0x7, 0x3, 0x7, 0x3, 0x7, 0x3, 0x7,
+        0x3, 0x7, 0x3, 0x7, 0x3, 0x7, 0x7, 0x7, 0x46, 0xa, 0x7, 0xc, 0x7, 0xe, 0x7, 0x49, 0xb, 0x7, 0x3,
+        0x8, 0x3, 0x8, 0x3, 0x8, 0x3, 0x8, 0x3, 0x8, 0x3, 0x8, 0x5, 0x8, 0x51, 0xa, 0x8, 0x3, 0x8, 0x2,
+        0x3, 0xc, 0x9, 0x2, 0x4, 0x6, 0x8, 0xa, 0xc, 0xe, 0x2, 0x4, 0x3, 0x2, 0xb, 0xc, 0x3, 0x2, 0xd,
+        0xe, 0x2, 0x55, 0x2, 0x11, 0x3, 0x2, 0x2, 0x2, 0x4, 0x15, 0x3, 0x2, 0x2, 0x2, 0x6, 0x23, 0x3,
+        0x2, 0x2, 0x2, 0x8, 0x2b, 0x3, 0x2, 0x2, 0x2, 0xa, 0x3a, 0x3, 0x2, 0x2, 0x2, 0xc, 0x3c, 0x3,
+        0x2, 0x2, 0x2, 0xe, 0x50, 0x3, 0x2, 0x2, 0x2, 0x10, 0x12, 0x5, 0x4, 0x3, 0x2, 0x11, 0x10, 0x3,
+        0x2, 0x2, 0x2, 0x12, 0x13, 0x3, 0x2, 0x2, 0x2, 0x13, 0x11, 0x3, 0x2, 0x2, 0x2, 0x13, 0x14, 0x3,
+        0x2, 0x2, 0x2, 0x14, 0x3, 0x3, 0x2, 0x2, 0x2, 0x15, 0x16, 0x7, 0x3, 0x2, 0x2, 0x16, 0x17, 0x7,
+        0x10, 0x2, 0x2, 0x17, 0x18, 0x7, 0x4, 0x2, 0x2, 0x18, 0x1d, 0x5, 0x8, 0x5, 0x2, 0x19, 0x1a, 0x7,
+        0x5, 0x2, 0x2, 0x1a, 0x1c, 0x5, 0x8, 0x5, 0x2, 0x1b, 0x19, 0x3, 0x2, 0x2, 0x2, 0x1c, 0x1f, 0x3,
+        0x2, 0x2, 0x2, 0x1d, 0x1b, 0x3, 0x2, 0x2, 0x2, 0x1d, 0x1e, 0x3, 0x2, 0x2, 0x2, 0x1e, 0x20, 0x3,
+        0x2, 0x2, 0x2, 0x1f, 0x1d, 0x3, 0x2, 0x2, 0x2, 0x20, 0x21, 0x7, 0x6, 0x2, 0x2, 0x21, 0x22, 0x5,
+        0x6, 0x4, 0x2, 0x22, 0x5, 0x3, 0x2, 0x2, 0x2, 0x23, 0x25, 0x7, 0x7, 0x2, 0x2, 0x24, 0x26, 0x5,
+        0xa, 0x6, 0x2, 0x25, 0x24, 0x3, 0x2, 0x2, 0x2, 0x26, 0x27, 0x3, 0x2, 0x2, 0x2, 0x27, 0x25, 0x3,
+        0x2, 0x2, 0x2, 0x27, 0x28, 0x3, 0x2, 0x2, 0x2, 0x28, 0x29, 0x3, 0x2, 0x2, 0x2, 0x29, 0x2a, 0x7,
+        0x8, 0x2, 0x2, 0x2a, 0x7, 0x3, 0x2, 0x2, 0x2, 0x2b, 0x2c, 0x7, 0x10, 0x2, 0x2, 0x2c, 0x9, 0x3,
+        0x2, 0x2, 0x2, 0x2d, 0x2e, 0x5, 0xc, 0x7, 0x2, 0x2e, 0x2f, 0x7, 0x9, 0x2, 0x2, 0x2f, 0x3b, 0x3,
+        0x2, 0x2, 0x2, 0x30, 0x31, 0x7, 0x10, 0x2, 0x2, 0x31, 0x32, 0x7, 0xa, 0x2, 0x2, 0x32, 0x33, 0x5,
+        0xc, 0x7, 0x2, 0x33, 0x34, 0x7, 0x9, 0x2, 0x2, 0x34, 0x3b, 0x3, 0x2, 0x2, 0x2, 0x35, 0x36, 0x7,
+        0xf, 0x2, 0x2, 0x36, 0x37, 0x5, 0xc, 0x7, 0x2, 0x37, 0x38, 0x7, 0x9, 0x2, 0x2, 0x38, 0x3b, 0x3,
+        0x2, 0x2, 0x2, 0x39, 0x3b, 0x7, 0x9, 0x2, 0x2, 0x3a, 0x2d, 0x3, 0x2, 0x2, 0x2, 0x3a, 0x30, 0x3,
+        0x2, 0x2, 0x2, 0x3a, 0x35, 0x3, 0x2, 0x2, 0x2, 0x3a, 0x39, 0x3, 0x2, 0x2, 0x2, 0x3b, 0xb, 0x3,
+        0x2, 0x2, 0x2, 0x3c, 0x3d, 0x8, 0x7, 0x1, 0x2, 0x3d, 0x3e, 0x5, 0xe, 0x8, 0x2, 0x3e, 0x47, 0x3,
+        0x2, 0x2, 0x2, 0x3f, 0x40, 0xc, 0x5, 0x2, 0x2, 0x40, 0x41, 0x9, 0x2, 0x2, 0x2, 0x41, 0x46, 0x5,
+        0xc, 0x7, 0x6, 0x42, 0x43, 0xc, 0x4, 0x2, 0x2, 0x43, 0x44, 0x9, 0x3, 0x2, 0x2, 0x44, 0x46, 0x5,
+        0xc, 0x7, 0x5, 0x45, 0x3f, 0x3, 0x2, 0x2, 0x2, 0x45, 0x42, 0x3, 0x2, 0x2, 0x2, 0x46, 0x49, 0x3,
+        0x2, 0x2, 0x2, 0x47, 0x45, 0x3, 0x2, 0x2, 0x2, 0x47, 0x48, 0x3, 0x2, 0x2, 0x2, 0x48, 0xd, 0x3,
+        0x2, 0x2, 0x2, 0x49, 0x47, 0x3, 0x2, 0x2, 0x2, 0x4a, 0x51, 0x7, 0x11, 0x2, 0x2, 0x4b, 0x51, 0x7,
+        0x10, 0x2, 0x2, 0x4c, 0x4d, 0x7, 0x4, 0x2, 0x2, 0x4d, 0x4e, 0x5, 0xc, 0x7, 0x2, 0x4e, 0x4f, 0x7,
+        0x6, 0x2, 0x2, 0x4f, 0x51, 0x3, 0x2, 0x2, 0x2, 0x50, 0x4a, 0x3, 0x2, 0x2, 0x2, 0x50, 0x4b, 0x3,
+        0x2, 0x2, 0x2, 0x50, 0x4c, 0x3, 0x2, 0x2, 0x2, 0x51, 0xf, 0x3, 0x2, 0x2, 0x2, 0x9, 0x13, 0x1d,
+        0x27, 0x3a, 0x45, 0x47, 0x50,
+      };
+      return serialized;
+    }
+
+    static const dfa::Vocabulary& vocabulary() {
+      static const dfa::Vocabulary vocabulary({
+        "", "'def'", "'('", "','", "')'", "'{'", "'}'", "';'", "'='", "'*'", "'/'", "'+'", "'-'", "'return'"
+      }, {
+        "", "", "", "", "", "", "", "", "", "MUL", "DIV", "ADD", "SUB", "RETURN", "ID", "INT", "NEWLINE", "WS"
+      });
+      return vocabulary;
+    }
+
+    static const std::vector<std::string>& lexerRuleNames() {
+      static const std::vector<std::string> names = {
+        "T__0", "T__1", "T__2", "T__3", "T__4", "T__5", "T__6", "T__7", "MUL", "DIV", "ADD", "SUB", "RETURN", "ID",
+        "INT", "NEWLINE", "WS"
+      };
+      return names;
+    }
+
+    static const std::vector<std::string>& parserRuleNames() {
+      static const std::vector<std::string> names = { "prog", "func", "body", "arg", "stat", "expr", "primary" };
+      return names;
+    }
+
+    static const std::vector<std::string>& channelNames() {
+      static const std::vector<std::string> names = { "DEFAULT_TOKEN_CHANNEL", "HIDDEN" };
+      return names;
+    }
+
+    static const std::vector<std::string>& modeNames() {
+      static const std::vector<std::string> names = { "DEFAULT_MODE" };
+      return names;
+    }
+
+    static std::unique_ptr<LexerInterpreter> createLexer(CharStream *input, const atn::ATN &atn = lexerATN()) {
+      return std::make_unique<LexerInterpreter>("Expr.g4", vocabulary(), lexerRuleNames(), channelNames(),
+                                                modeNames(), atn, input);
+    }
+
+    static std::unique_ptr<ParserInterpreter> createParser(TokenStream *tokens, const atn::ATN &atn = parserATN()) {
+      return std::make_unique<ParserInterpreter>("Expr.g4", vocabulary(), parserRuleNames(), atn, tokens);
+    }
+
+    // A program of n functions, each spanning two lines.
+    static std::string sampleProgram(size_t n) {
+      std::string text;
+      for (size_t i = 0; i < n; ++i) {
+        text += "def f(a, b) { a = 1 + 2 * b;\n  return (a - 3) / b; }\n";
+      }
+      return text;
+    }
+  };
+
+}
+}
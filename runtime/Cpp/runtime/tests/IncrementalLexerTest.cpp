@@ -0,0 +1,79 @@
+#include "gtest/gtest.h"
+#include "ANTLRInputStream.h"
+#include "BufferedTokenStream.h"
+#include "IncrementalLexer.h"
+#include "Token.h"
+
+#include "ExprGrammar.h"
+
+namespace antlr4 {
+namespace {
+
+  using test::ExprGrammar;
+
+  std::vector<std::string> toStrings(const std::vector<Token *> &tokens) {
+    std::vector<std::string> result;
+    for (Token *token : tokens) {
+      result.push_back(token->toString());
+    }
+    return result;
+  }
+
+  // The tokens of lexing the text from scratch.
+  std::vector<std::string> lex(const std::string &text) {
+    ANTLRInputStream input(text);
+    std::unique_ptr<Lexer> lexer = ExprGrammar::createLexer(&input);
+    BufferedTokenStream tokens(lexer.get());
+    tokens.fill();
+    return toStrings(tokens.getTokens());
+  }
+
+  TEST(IncrementalLexerTest, MatchesFullLexing) {
+    std::string text;
+    for (size_t i = 0; i < 20; ++i) {
+      text += "def f" + std::to_string(i) + "(a, b) { a = 1 + 2 * b;\n  return a; }\n";
+    }
+    ANTLRInputStream input(text);
+    std::unique_ptr<Lexer> lexer = ExprGrammar::createLexer(&input);
+    IncrementalLexer incrementalLexer(lexer.get(), &input);
+    BufferedTokenStream tokens(&incrementalLexer);
+    tokens.fill();
+    size_t tokenCount = tokens.size();
+
+    // Extending an identifier re-lexes it only.
+    std::vector<Token *> before = tokens.getTokens();
+    IncrementalLexer::Change change = incrementalLexer.edit(tokens, { 5, 0, "xyz" });
+    EXPECT_EQ(change.start, 1u);
+    EXPECT_EQ(change.removed, 1u);
+    EXPECT_EQ(change.inserted, 1u);
+    EXPECT_EQ(tokens.get(1)->getText(), "fxyz");
+    EXPECT_EQ(tokens.get(2), before[2]);
+    EXPECT_EQ(toStrings(tokens.getTokens()), lex(input.toString()));
+
+    // Joining lines, splitting a token, deleting across tokens, and edits at the start and the end.
+    std::vector<IncrementalLexer::Edit> edits = {
+      { 47, 3, "" },
+      { 60, 0, "\n\n" },
+      { 100, 1, " 4 5 " },
+      { 20, 30, "x" },
+      { 0, 0, "def g() { }\n" },
+      { 0, 5, "" },
+    };
+    for (const IncrementalLexer::Edit &edit : edits) {
+      ASSERT_LE(edit.offset + edit.deletedLength, input.size());
+      change = incrementalLexer.edit(tokens, edit);
+      EXPECT_LT(change.removed, tokenCount / 4);
+      EXPECT_EQ(toStrings(tokens.getTokens()), lex(input.toString()));
+    }
+
+    incrementalLexer.edit(tokens, { input.size() - 2, 2, "" });
+    EXPECT_EQ(toStrings(tokens.getTokens()), lex(input.toString()));
+    incrementalLexer.edit(tokens, { input.size(), 0, " end" });
+    EXPECT_EQ(tokens.get(tokens.size() - 2)->getText(), "end");
+    EXPECT_EQ(toStrings(tokens.getTokens()), lex(input.toString()));
+
+    EXPECT_THROW(incrementalLexer.edit(tokens, { input.size(), 1, "" }), IllegalArgumentException);
+  }
+
+}
+}
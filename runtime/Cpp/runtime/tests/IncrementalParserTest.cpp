@@ -0,0 +1,86 @@
+#include <string>
+
+#include "gtest/gtest.h"
+#include "ANTLRInputStream.h"
+#include "CommonTokenStream.h"
+#include "IncrementalLexer.h"
+#include "ParserRuleContext.h"
+
+#include "ExprGrammar.h"
+
+namespace antlr4 {
+namespace {
+
+  using test::ExprGrammar;
+
+  std::string function(size_t i) {
+    return "def f" + std::string(i % 26 + 1, 'x') + "(a, b) { a = 1 + 2 * b;\n  return (a - 3) / b; }\n";
+  }
+
+  // The tree of parsing the text from scratch.
+  std::string parse(const std::string &text) {
+    ANTLRInputStream input(text);
+    auto lexer = ExprGrammar::createLexer(&input);
+    CommonTokenStream tokens(lexer.get());
+    auto parser = ExprGrammar::createParser(&tokens);
+    return parser->parse(ExprGrammar::RULE_prog)->toStringTree(parser.get());
+  }
+
+  TEST(IncrementalParserTest, ReusesUnchangedSubtrees) {
+    constexpr size_t count = 30;
+    std::string text;
+    size_t offset = 0;
+    for (size_t i = 0; i < count; ++i) {
+      if (i == 10) {
+        offset = text.size();
+      }
+      text += function(i);
+    }
+
+    ANTLRInputStream input(text);
+    auto lexer = ExprGrammar::createLexer(&input);
+    IncrementalLexer incrementalLexer(lexer.get(), &input);
+    CommonTokenStream tokens(&incrementalLexer);
+    auto parser = ExprGrammar::createParser(&tokens);
+    parser->setIncremental(true);
+    ParserRuleContext *tree = parser->parse(ExprGrammar::RULE_prog);
+    ASSERT_EQ(tree->children.size(), count);
+
+    // Edits within the 11th function: changing an expression, a syntax error and its fix, and whitespace.
+    std::vector<IncrementalLexer::Edit> edits = {
+      { offset + 29, 1, "42" },
+      { offset + 31, 0, " * c" },
+      { offset + 25, 0, "(" },
+      { offset + 25, 1, "" },
+      { offset, 0, "\n\n" },
+    };
+    for (const IncrementalLexer::Edit &edit : edits) {
+      std::vector<tree::ParseTree *> functions = tree->children;
+      IncrementalLexer::Change change = incrementalLexer.edit(tokens, edit);
+      parser->setReusableTree(tree, change.start, change.removed, change.inserted);
+      tree = parser->parse(ExprGrammar::RULE_prog);
+      EXPECT_EQ(tree->toStringTree(parser.get()), parse(input.toString()));
+
+      size_t reused = 0;
+      for (size_t i = 0; i < count; ++i) {
+        if (tree->children[i] == functions[i]) {
+          ++reused;
+        }
+      }
+      EXPECT_GE(reused, count - 2);
+    }
+
+    // Removing a function shifts those after it.
+    std::vector<tree::ParseTree *> functions = tree->children;
+    std::string removed = function(11);
+    IncrementalLexer::Change change =
+      incrementalLexer.edit(tokens, { input.toString().find(removed), removed.size(), "" });
+    parser->setReusableTree(tree, change.start, change.removed, change.inserted);
+    tree = parser->parse(ExprGrammar::RULE_prog);
+    EXPECT_EQ(tree->toStringTree(parser.get()), parse(input.toString()));
+    EXPECT_EQ(tree->children[0], functions[0]);
+    EXPECT_EQ(tree->children[count - 2], functions[count - 1]);
+  }
+
+}
+}
@@ -0,0 +1,164 @@
+#include "gtest/gtest.h"
+#include "ANTLRInputStream.h"
+#include "Token.h"
+#include "atn/ATNDeserializationOptions.h"
+#include "atn/LexerActionExecutor.h"
+#include "atn/LexerATNSimulator.h"
+#include "atn/PredictionContext.h"
+#include "atn/TokensStartState.h"
+#include "dfa/DFA.h"
+
+#include "ExprGrammar.h"
+
+namespace antlr4 {
+namespace {
+
+  using test::ExprGrammar;
+
+  // Counts the DFA edges which had to be computed, i.e. were not found in the DFA.
+  class CountingLexerATNSimulator : public atn::LexerATNSimulator {
+  public:
+    using LexerATNSimulator::LexerATNSimulator;
+
+    size_t computedEdges = 0;
+    size_t matchCalls = 0;
+
+    size_t match(CharStream *input, size_t mode) override {
+      ++matchCalls;
+      return LexerATNSimulator::match(input, mode);
+    }
+
+  protected:
+    dfa::DFAState *computeTargetState(CharStream *input, dfa::DFAState *s, size_t t) override {
+      ++computedEdges;
+      return LexerATNSimulator::computeTargetState(input, s, t);
+    }
+  };
+
+  // Lexes the input with the shared DFA and returns the tokens, the last entry being the number of computed edges.
+  std::vector<std::string> lex(const atn::ATN &atn, std::vector<dfa::DFA> &decisionToDFA, const std::string &text) {
+    atn::PredictionContextCache cache;
+    ANTLRInputStream input(text);
+    auto lexer = ExprGrammar::createLexer(&input, atn);
+    lexer->removeErrorListeners();
+    auto *simulator = new CountingLexerATNSimulator(lexer.get(), atn, decisionToDFA, cache);
+    lexer->setInterpreter(simulator);
+
+    std::vector<std::string> tokens;
+    for (auto token = lexer->nextToken(); token->getType() != Token::EOF; token = lexer->nextToken()) {
+      tokens.push_back(token->getText());
+    }
+    tokens.push_back(std::to_string(simulator->computedEdges));
+    return tokens;
+  }
+
+  std::vector<dfa::DFA> createDFAs(const atn::ATN &atn) {
+    std::vector<dfa::DFA> decisionToDFA;
+    for (size_t i = 0; i < atn.getNumberOfDecisions(); ++i) {
+      decisionToDFA.emplace_back(atn.getDecisionState(i), i);
+    }
+    return decisionToDFA;
+  }
+
+  TEST(LexerATNSimulatorTest, CharacterClassEdges) {
+    const atn::ATN &atn = ExprGrammar::lexerATN();
+    const atn::LexerCharClasses &classes = atn.modeToStartState[0]->charClasses;
+    ASSERT_GT(classes.size(), 0u);
+    EXPECT_EQ(classes.getClass('a'), classes.getClass('Q'));
+    EXPECT_NE(classes.getClass('a'), classes.getClass('1'));
+    EXPECT_EQ(classes.getClass(u'ж'), classes.getClass('#'));
+    EXPECT_EQ(classes.getClass(Token::EOF), INVALID_INDEX);
+
+    // All code points no rule matches share a class. After the first input, the DFA has all edges the second one
+    // needs. ASCII keeps an edge per code point, so the letters and digits must be the same.
+    std::vector<dfa::DFA> decisionToDFA = createDFAs(atn);
+    std::vector<std::string> first = lex(atn, decisionToDFA, "abc x1 ж;");
+    EXPECT_EQ(first, std::vector<std::string>({ "abc", "x", "1", ";", "14" }));
+    std::vector<std::string> second = lex(atn, decisionToDFA, "abcc x1 中;");
+    EXPECT_EQ(second, std::vector<std::string>({ "abcc", "x", "1", ";", "1" })); // Only EOF takes no edge.
+
+    // Without classes, code points beyond ASCII take no DFA edges: 'ж' is simulated on the ATN after the white
+    // space and again at the token start.
+    atn::ATNDeserializationOptions options;
+    options.setGenerateLexerCharClasses(false);
+    atn::ATN plainATN = atn::ATNDeserializer(options).deserialize(ExprGrammar::serializedLexerATN());
+    EXPECT_EQ(plainATN.modeToStartState[0]->charClasses.size(), 0u);
+    std::vector<dfa::DFA> plainDFAs = createDFAs(plainATN);
+    lex(plainATN, plainDFAs, "abc x1 ж;");
+    second = lex(plainATN, plainDFAs, "abcc x1 中;");
+    EXPECT_EQ(second, std::vector<std::string>({ "abcc", "x", "1", ";", "3" }));
+
+    // The ASCII edges print one by one, exactly as without classes.
+    std::string dfa = decisionToDFA[0].toLexerString();
+    EXPECT_NE(dfa.find("s0-'a'->"), std::string::npos) << dfa;
+    EXPECT_EQ(dfa, plainDFAs[0].toLexerString());
+  }
+
+  TEST(LexerATNSimulatorTest, SkipsInline) {
+    const atn::ATN &atn = ExprGrammar::lexerATN();
+    std::vector<dfa::DFA> decisionToDFA = createDFAs(atn);
+    atn::PredictionContextCache cache;
+
+    // Returns the tokens of the input and the number of match() calls.
+    auto lexSkipping = [&](bool inlineSkips) {
+      ANTLRInputStream input("a  b\n c;\n \n");
+      auto lexer = ExprGrammar::createLexer(&input, atn);
+      lexer->setInlineSkipAndChannel(inlineSkips);
+      auto *simulator = new CountingLexerATNSimulator(lexer.get(), atn, decisionToDFA, cache);
+      lexer->setInterpreter(simulator);
+
+      std::vector<std::string> tokens;
+      for (auto token = lexer->nextToken(); token->getType() != Token::EOF; token = lexer->nextToken()) {
+        tokens.push_back(token->getText() + "@" + std::to_string(token->getLine()) + ":" +
+                         std::to_string(token->getCharPositionInLine()) + "/" + std::to_string(token->getStartIndex()));
+      }
+      return std::make_pair(tokens, simulator->matchCalls);
+    };
+
+    // By default every skip returns to the lexer, which calls skip().
+    std::vector<std::string> expected = { "a@1:0/0", "b@1:3/3", "c@2:1/6", ";@2:2/7" };
+    auto result = lexSkipping(false);
+    EXPECT_EQ(result.first, expected);
+    EXPECT_EQ(result.second, 10u);
+
+    // Inlined, white space and newlines before a token are skipped within the match() call of that token.
+    // Skipped input at the end still takes a call of its own, so the lexer sees EOF.
+    result = lexSkipping(true);
+    EXPECT_EQ(result.first, expected);
+    EXPECT_EQ(result.second, 5u);
+
+    const dfa::DFA &dfa = decisionToDFA[0];
+    size_t skipStates = 0;
+    for (dfa::DFAState *state : dfa.states) {
+      skipStates += state->isLexerSkip ? 1 : 0;
+      EXPECT_EQ(state->lexerChannel, INVALID_INDEX);
+    }
+    EXPECT_GT(skipStates, 0u);
+  }
+
+  TEST(LexerATNSimulatorTest, InternsActionExecutors) {
+    atn::ATN atn = atn::ATNDeserializer().deserialize(ExprGrammar::serializedLexerATN());
+    ASSERT_EQ(atn.lexerActions.size(), 1u); // NEWLINE and WS share their skip action.
+    std::vector<dfa::DFA> decisionToDFA = createDFAs(atn);
+    lex(atn, decisionToDFA, "a \n b\n");
+    ASSERT_EQ(atn.lexerActionExecutors.size(), 1u);
+
+    atn::LexerActionExecutor *skip = atn.lexerActionExecutors.append(nullptr, atn.lexerActions[0]);
+    EXPECT_EQ(atn.lexerActionExecutors.append(nullptr, atn.lexerActions[0]), skip);
+    EXPECT_FALSE(skip->hasUnfixedOffsets());
+    EXPECT_EQ(atn.lexerActionExecutors.fixOffsetBeforeMatch(skip, 3), skip);
+    atn::LexerActionExecutor *skipTwice = atn.lexerActionExecutors.append(skip, atn.lexerActions[0]);
+    EXPECT_NE(skipTwice, skip);
+    EXPECT_EQ(skipTwice->getLexerActions().size(), 2u);
+    EXPECT_EQ(atn.lexerActionExecutors.size(), 2u);
+
+    // The accept states of the DFA share the interned executor.
+    for (dfa::DFAState *state : decisionToDFA[0].states) {
+      if (state->lexerActionExecutor != nullptr) {
+        EXPECT_EQ(state->lexerActionExecutor.get(), skip);
+      }
+    }
+  }
+
+}
+}
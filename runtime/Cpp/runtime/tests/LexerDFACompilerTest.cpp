@@ -0,0 +1,108 @@
+#include "gtest/gtest.h"
+#include "ANTLRInputStream.h"
+#include "Token.h"
+#include "atn/LexerDFACompiler.h"
+#include "atn/LexerDFATableSimulator.h"
+#include "atn/LexerKeywordTable.h"
+#include "atn/PredictionContext.h"
+#include "dfa/DFA.h"
+
+#include "ExprGrammar.h"
+#include "ExprLexerDFA.h"
+
+namespace antlr4 {
+namespace {
+
+  using test::ExprGrammar;
+
+  constexpr const char *INPUT =
+    "def f(a, b) { a = 1 + 2 * b; return (a - 3) / b; }\n"
+    "def g(x) {\r\n  x; ; return x * x + x;\n}\n";
+
+  // Lexes the input on the ATN, or with the given table if not null. The last entry is the error count.
+  std::vector<std::string> lex(const std::string &text, const dfa::LexerDFATable *table,
+                               const atn::ATN &atn = ExprGrammar::lexerATN()) {
+    std::vector<dfa::DFA> decisionToDFA;
+    atn::PredictionContextCache cache;
+
+    ANTLRInputStream input(text);
+    auto lexer = ExprGrammar::createLexer(&input, atn);
+    lexer->removeErrorListeners();
+    if (table != nullptr) {
+      for (size_t i = 0; i < atn.getNumberOfDecisions(); ++i) {
+        decisionToDFA.emplace_back(atn.getDecisionState(i), i);
+      }
+      lexer->setInterpreter(new atn::LexerDFATableSimulator(lexer.get(), atn, decisionToDFA, cache, *table));
+    }
+
+    std::vector<std::string> tokens;
+    for (;;) {
+      std::unique_ptr<Token> token = lexer->nextToken();
+      tokens.push_back(token->toString());
+      if (token->getType() == Token::EOF) {
+        break;
+      }
+    }
+    tokens.push_back(std::to_string(lexer->getNumberOfSyntaxErrors()));
+    return tokens;
+  }
+
+  TEST(LexerDFACompilerTest, MatchesATNSimulation) {
+    atn::LexerDFACompiler compiler(ExprGrammar::lexerATN());
+    compiler.compile();
+    ASSERT_TRUE(compiler.isModeCompiled(0));
+
+    dfa::LexerDFATable table = compiler.table();
+    EXPECT_EQ(table.getClass('a'), table.getClass('Z'));
+    EXPECT_NE(table.getClass('a'), table.getClass('0'));
+    EXPECT_EQ(table.getClass(0x4E2D), table.getClass('@')); // Neither is used by the grammar.
+    EXPECT_EQ(table.getClass(0x110000), table.classCount);
+
+    EXPECT_EQ(lex(INPUT, &table), lex(INPUT, nullptr));
+
+    // Input the table rejects is handed back to the ATN simulator, which reports the error.
+    std::string bad = "def f(x) { x @ 1; }\n";
+    std::vector<std::string> expected = lex(bad, nullptr);
+    EXPECT_EQ(expected.back(), "1");
+    EXPECT_EQ(lex(bad, &table), expected);
+  }
+
+  TEST(LexerDFACompilerTest, IgnoresKeywordTable) {
+    atn::ATN atn = atn::ATNDeserializer().deserialize(ExprGrammar::serializedLexerATN());
+    atn::LexerKeywordTable::install(atn, 0, ExprGrammar::vocabulary(), ExprGrammar::ID);
+    atn::LexerDFACompiler compiler(atn);
+    compiler.compile();
+    ASSERT_TRUE(compiler.isModeCompiled(0));
+
+    // The keyword rules are compiled into the DFA, which is the same as without the keyword table.
+    atn::LexerDFACompiler plain(ExprGrammar::lexerATN());
+    plain.compile();
+    dfa::LexerDFATable table = compiler.table();
+    EXPECT_EQ(table.stateCount, plain.table().stateCount);
+
+    std::vector<std::string> expected = lex(INPUT, nullptr);
+    EXPECT_EQ(lex(INPUT, nullptr, atn), expected);
+    EXPECT_EQ(lex(INPUT, &table, atn), expected);
+  }
+
+  TEST(LexerDFACompilerTest, GeneratedTable) {
+    atn::LexerDFACompiler compiler(ExprGrammar::lexerATN());
+    compiler.compile();
+    dfa::LexerDFATable table = compiler.table();
+
+    // ExprLexerDFA.h is generated by antlr4_lexer_dfa from ExprLexer.interp at build time.
+    const dfa::LexerDFATable &generated = test::ExprLexerDFA;
+    static_assert(test::ExprLexerDFA.modeCount == 1, "generated tables are constant expressions");
+    ASSERT_EQ(generated.stateCount, table.stateCount);
+    ASSERT_EQ(generated.classCount, table.classCount);
+    size_t size = table.stateCount * table.classCount;
+    EXPECT_EQ(std::vector<int32_t>(generated.transitions, generated.transitions + size),
+              std::vector<int32_t>(table.transitions, table.transitions + size));
+    EXPECT_EQ(lex(INPUT, &generated), lex(INPUT, nullptr));
+
+    EXPECT_NE(compiler.toCppSource("Table", "ns").find("inline constexpr antlr4::dfa::LexerDFATable Table = {"),
+              std::string::npos);
+  }
+
+}
+}
@@ -0,0 +1,60 @@
+#include "gtest/gtest.h"
+#include "ANTLRInputStream.h"
+#include "Exceptions.h"
+#include "Token.h"
+#include "atn/LexerATNSimulator.h"
+#include "atn/LexerKeywordTable.h"
+#include "atn/TokensStartState.h"
+#include "dfa/DFA.h"
+
+#include "ExprGrammar.h"
+
+namespace antlr4 {
+namespace {
+
+  using test::ExprGrammar;
+
+  constexpr const char *INPUT = "def f(a) { return a; }\ndef definitely(b) { returns = b; return def; }\n";
+
+  // Returns the tokens of the input and the number of states of the lexer DFA.
+  std::pair<std::vector<std::string>, size_t> lex(const atn::ATN &atn, const std::string &text) {
+    ANTLRInputStream input(text);
+    auto lexer = ExprGrammar::createLexer(&input, atn);
+    std::vector<std::string> tokens;
+    for (auto token = lexer->nextToken(); token->getType() != Token::EOF; token = lexer->nextToken()) {
+      tokens.push_back(token->toString());
+    }
+    return { tokens, lexer->getInterpreter<atn::LexerATNSimulator>()->getDFA(0).states.size() };
+  }
+
+  TEST(LexerKeywordTableTest, KeywordsBypassDFA) {
+    atn::ATN atn = atn::ATNDeserializer().deserialize(ExprGrammar::serializedLexerATN());
+    atn::LexerKeywordTable::install(atn, 0, ExprGrammar::vocabulary(), ExprGrammar::ID);
+    const atn::LexerKeywordTable &keywords = atn.modeToStartState[0]->keywords;
+    ASSERT_EQ(keywords.size(), 2u);
+    EXPECT_TRUE(keywords.isKeywordRule(ExprGrammar::T__0 - 1));
+    EXPECT_TRUE(keywords.isKeywordRule(ExprGrammar::RETURN - 1));
+    EXPECT_FALSE(keywords.isKeywordRule(ExprGrammar::T__1 - 1)); // '(' is not an identifier.
+    EXPECT_EQ(keywords.getType(U"def", 3), static_cast<size_t>(ExprGrammar::T__0));
+    EXPECT_EQ(keywords.getType(U"return", 6), static_cast<size_t>(ExprGrammar::RETURN));
+    EXPECT_EQ(keywords.getType(U"ret", 3), Token::INVALID_TYPE);
+    EXPECT_EQ(keywords.getType(U"DEF", 3), Token::INVALID_TYPE);
+
+    // Same tokens as with the keyword rules in the DFA, which takes fewer states.
+    auto expected = lex(ExprGrammar::lexerATN(), INPUT);
+    auto actual = lex(atn, INPUT);
+    EXPECT_EQ(actual.first, expected.first);
+    EXPECT_LT(actual.second, expected.second);
+
+    atn::ATN caseInsensitive = atn::ATNDeserializer().deserialize(ExprGrammar::serializedLexerATN());
+    atn::LexerKeywordTable::install(caseInsensitive, 0, ExprGrammar::vocabulary(), ExprGrammar::ID, true);
+    std::vector<std::string> tokens = lex(caseInsensitive, "DeF Return").first;
+    ASSERT_EQ(tokens.size(), 2u);
+    EXPECT_NE(tokens[0].find("<1>"), std::string::npos) << tokens[0];
+    EXPECT_NE(tokens[1].find("<13>"), std::string::npos) << tokens[1];
+
+    EXPECT_THROW(atn::LexerKeywordTable(atn, 0, ExprGrammar::vocabulary(), 99), IllegalArgumentException);
+  }
+
+}
+}
@@ -0,0 +1,180 @@
+#include <algorithm>
+
+#include "gtest/gtest.h"
+#include "ANTLRInputStream.h"
+#include "CommonTokenFactory.h"
+#include "CommonTokenStream.h"
+#include "LexerInterpreter.h"
+#include "Token.h"
+#include "WritableToken.h"
+
+#include "ExprGrammar.h"
+
+namespace antlr4 {
+namespace {
+
+  using test::ExprGrammar;
+
+  constexpr const char *INPUT = "def f(a, b) { a = 1 + 2 * b; return a; }\ndef g(x) { x; }\n";
+
+  class ExprLexer {
+  public:
+    ExprLexer(const std::string &text) : ExprLexer(text, input) {
+    }
+
+    ExprLexer(const std::string &text, CharStream &stream)
+      : input(text), lexer(ExprGrammar::createLexer(&stream)) {
+    }
+
+    ANTLRInputStream input;
+    std::unique_ptr<LexerInterpreter> lexer;
+  };
+
+  TEST(LexerTest, NextTokens) {
+    ExprLexer single(INPUT);
+    std::vector<std::string> expected;
+    for (auto token = single.lexer->nextToken(); ; token = single.lexer->nextToken()) {
+      expected.push_back(token->toString());
+      if (token->getType() == Token::EOF) {
+        break;
+      }
+    }
+
+    // Batches stop after EOF.
+    ExprLexer batched(INPUT);
+    std::vector<std::unique_ptr<Token>> tokens;
+    EXPECT_EQ(batched.lexer->nextTokens(tokens, 5), 5u);
+    EXPECT_EQ(batched.lexer->nextTokens(tokens, 1000), expected.size() - 5);
+    std::vector<std::string> actual;
+    for (const auto &token : tokens) {
+      actual.push_back(token->toString());
+    }
+    EXPECT_EQ(actual, expected);
+
+    ExprLexer all(INPUT);
+    EXPECT_EQ(all.lexer->getAllTokens().size(), expected.size() - 1);
+
+    // Token streams fetch through nextTokens() and index the tokens.
+    ExprLexer streamed(INPUT);
+    CommonTokenStream stream(streamed.lexer.get());
+    stream.fill();
+    ASSERT_EQ(stream.size(), expected.size());
+    for (size_t i = 0; i < stream.size(); ++i) {
+      EXPECT_EQ(stream.get(i)->getTokenIndex(), i);
+      EXPECT_EQ(stream.get(i)->getText(), tokens[i]->getText());
+    }
+  }
+
+  // Post-processes its tokens, like lexers injecting INDENT/DEDENT tokens do.
+  class UpperCaseLexer : public LexerInterpreter {
+  public:
+    UpperCaseLexer(CharStream *input)
+      : LexerInterpreter("Expr.g4", ExprGrammar::vocabulary(), ExprGrammar::lexerRuleNames(),
+                         ExprGrammar::channelNames(), ExprGrammar::modeNames(), ExprGrammar::lexerATN(), input) {
+    }
+
+    size_t calls = 0;
+
+    std::unique_ptr<Token> nextToken() override {
+      ++calls;
+      std::unique_ptr<Token> token = LexerInterpreter::nextToken();
+      if (token->getType() == ExprGrammar::ID) {
+        std::string text = token->getText();
+        std::transform(text.begin(), text.end(), text.begin(), ::toupper);
+        static_cast<WritableToken *>(token.get())->setText(text);
+      }
+      return token;
+    }
+  };
+
+  TEST(LexerTest, NextTokensUsesOverriddenNextToken) {
+    ANTLRInputStream input(INPUT);
+    UpperCaseLexer lexer(&input);
+    CommonTokenStream tokens(&lexer);
+    tokens.fill();
+    EXPECT_EQ(lexer.calls, tokens.size());
+    EXPECT_EQ(tokens.get(1)->getText(), "F");
+
+    input.seek(0);
+    lexer.reset();
+    lexer.calls = 0;
+    std::vector<std::unique_ptr<Token>> all = lexer.getAllTokens();
+    EXPECT_EQ(lexer.calls, all.size() + 1);
+    EXPECT_EQ(all[1]->getText(), "F");
+  }
+
+  // A stream without contiguous data.
+  class ForwardingCharStream : public CharStream {
+  public:
+    ForwardingCharStream(CharStream &stream) : _stream(stream) {
+    }
+
+    void consume() override { _stream.consume(); }
+    size_t LA(ssize_t i) override { return _stream.LA(i); }
+    ssize_t mark() override { return _stream.mark(); }
+    void release(ssize_t marker) override { _stream.release(marker); }
+    size_t index() override { return _stream.index(); }
+    void seek(size_t index) override { _stream.seek(index); }
+    size_t size() override { return _stream.size(); }
+    std::string getSourceName() const override { return _stream.getSourceName(); }
+    std::string getText(const misc::Interval &interval) override { return _stream.getText(interval); }
+    std::string toString() const override { return _stream.toString(); }
+
+  private:
+    CharStream &_stream;
+  };
+
+  TEST(LexerTest, NonContiguousInput) {
+    // ANTLRInputStream is matched directly on its buffer, other streams through LA() and consume().
+    std::string text = std::string(INPUT) + "a\n\n  b\r\nc";
+    ANTLRInputStream input(text);
+    ForwardingCharStream forwarding(input);
+    ExprLexer contiguous(text);
+    ExprLexer streamed(text, forwarding);
+    CommonTokenFactory factory(true);
+    contiguous.lexer->setTokenFactory(&factory);
+    streamed.lexer->setTokenFactory(&factory);
+
+    for (size_t i = 0; ; ++i) {
+      std::unique_ptr<Token> expected = contiguous.lexer->nextToken();
+      std::unique_ptr<Token> actual = streamed.lexer->nextToken();
+      EXPECT_EQ(actual->toString(), expected->toString()) << "token " << i;
+      if (expected->getType() == Token::EOF) {
+        break;
+      }
+    }
+    EXPECT_EQ(contiguous.input.index(), text.size());
+  }
+
+  // The usual case-insensitive stream: the grammar matches lower case, LA() folds the input.
+  class LowerCaseStream : public ANTLRInputStream {
+  public:
+    using ANTLRInputStream::ANTLRInputStream;
+
+    size_t LA(ssize_t i) override {
+      size_t c = ANTLRInputStream::LA(i);
+      return c >= 'A' && c <= 'Z' ? c - 'A' + 'a' : c;
+    }
+  };
+
+  TEST(LexerTest, OverriddenLA) {
+    // Subclasses are lexed through LA(), not on the buffer.
+    LowerCaseStream input("DEF F(A) { RETURN A; }");
+    size_t size = 0;
+    EXPECT_EQ(input.getContiguousData(size), nullptr);
+
+    ExprLexer lexer("", input);
+    std::vector<size_t> types;
+    for (const auto &token : lexer.lexer->getAllTokens()) {
+      if (token->getChannel() == Token::DEFAULT_CHANNEL) {
+        types.push_back(token->getType());
+      }
+    }
+    ASSERT_FALSE(types.empty());
+    EXPECT_EQ(types[0], ExprGrammar::T__0);
+    EXPECT_EQ(types[1], ExprGrammar::ID);
+    EXPECT_NE(std::find(types.begin(), types.end(), ExprGrammar::RETURN), types.end());
+  }
+
+}
+}
@@ -0,0 +1,137 @@
+#include "gtest/gtest.h"
+#include "ANTLRInputStream.h"
+#include "BaseErrorListener.h"
+#include "ParallelLexer.h"
+#include "Token.h"
+#include "atn/LexerATNSimulator.h"
+#include "atn/PredictionContext.h"
+#include "dfa/DFA.h"
+#include "tree/xpath/XPathLexer.h"
+
+#include "ExprGrammar.h"
+
+namespace antlr4 {
+namespace {
+
+  using test::ExprGrammar;
+
+  constexpr const char *INPUT = "def f(a, b) { a = 1 + 2 * b; return a; }\n  def g(x) {\n\n x; }\n";
+
+  class ExprLexers {
+  public:
+    ExprLexers() {
+      const atn::ATN &atn = ExprGrammar::lexerATN();
+      for (size_t i = 0; i < atn.getNumberOfDecisions(); ++i) {
+        _decisionToDFA.emplace_back(atn.getDecisionState(i), i);
+      }
+    }
+
+    // Lexers sharing their DFA, like generated ones do.
+    std::unique_ptr<Lexer> create(CharStream *input) {
+      const atn::ATN &atn = ExprGrammar::lexerATN();
+      auto lexer = ExprGrammar::createLexer(input, atn);
+      lexer->setInterpreter(new atn::LexerATNSimulator(lexer.get(), atn, _decisionToDFA, _cache));
+      return lexer;
+    }
+
+  private:
+    std::vector<dfa::DFA> _decisionToDFA;
+    atn::PredictionContextCache _cache;
+  };
+
+  std::vector<std::string> toStrings(const std::vector<std::unique_ptr<Token>> &tokens) {
+    std::vector<std::string> result;
+    for (const auto &token : tokens) {
+      result.push_back(token->toString());
+    }
+    return result;
+  }
+
+  TEST(ParallelLexerTest, MatchesSequentialLexing) {
+    std::string text;
+    for (size_t i = 0; i < 200; ++i) {
+      text += INPUT;
+    }
+    ANTLRInputStream input(text);
+    ExprLexers lexers;
+    std::vector<std::unique_ptr<Token>> expected;
+    std::unique_ptr<Lexer> lexer = lexers.create(&input);
+    for (expected.push_back(lexer->nextToken()); expected.back()->getType() != Token::EOF;
+         expected.push_back(lexer->nextToken())) {
+    }
+
+    ParallelLexer parallel([&lexers](CharStream *stream) { return lexers.create(stream); });
+    parallel.setMinChunkSize(100);
+    input.seek(0);
+    EXPECT_EQ(toStrings(parallel.tokenize(&input, 8)), toStrings(expected));
+    EXPECT_EQ(parallel.getRelexedChunks(), 0u);
+
+    // Splitting anywhere, also within tokens, speculates wrong. The lexer before the split point then continues
+    // until it meets the tokens of the next chunk.
+    parallel.setSplitPointPredicate([](const char32_t *, size_t, size_t) { return true; });
+    input.seek(0);
+    EXPECT_EQ(toStrings(parallel.tokenize(&input, 8)), toStrings(expected));
+
+    // Small inputs are not split.
+    ANTLRInputStream small(INPUT);
+    std::vector<std::unique_ptr<Token>> tokens = parallel.tokenize(&small, 8);
+    EXPECT_EQ(tokens.size(), 30u);
+    EXPECT_EQ(tokens.back()->getType(), Token::EOF);
+  }
+
+  class ErrorCollector : public BaseErrorListener {
+  public:
+    std::vector<std::string> errors;
+
+    void syntaxError(Recognizer * /*recognizer*/, Token * /*offendingSymbol*/, size_t line,
+                     size_t charPositionInLine, const std::string &msg, std::exception_ptr /*e*/) override {
+      errors.push_back(std::to_string(line) + ":" + std::to_string(charPositionInLine) + " " + msg);
+    }
+  };
+
+  TEST(ParallelLexerTest, ReportsErrorsOfKeptTokensOnly) {
+    // The only line breaks are inside XPath strings, so chunks start in a string, where a space is an error.
+    std::string text;
+    for (size_t i = 0; i < 100; ++i) {
+      text += "/a'x\n y'";
+    }
+    ANTLRInputStream input(text);
+    ErrorCollector collector;
+    ParallelLexer parallel([&collector](CharStream *stream) {
+      auto lexer = std::make_unique<XPathLexer>(stream);
+      lexer->removeErrorListeners();
+      lexer->addErrorListener(&collector);
+      return lexer;
+    });
+    parallel.setMinChunkSize(16);
+
+    XPathLexer lexer(&input);
+    std::vector<std::unique_ptr<Token>> expected = lexer.getAllTokens();
+    expected.push_back(lexer.nextToken());
+    input.seek(0);
+    EXPECT_EQ(toStrings(parallel.tokenize(&input, 4)), toStrings(expected));
+    EXPECT_GT(parallel.getRelexedChunks(), 0u);
+    EXPECT_TRUE(collector.errors.empty());
+
+    // Real errors are reported once, in order, also when the chunk lexing them gets in sync.
+    std::string invalidText;
+    for (size_t i = 0; i < 100; ++i) {
+      invalidText += i % 40 == 20 ? "#/a'x\n y'" : "/a'x\n y'";
+    }
+    ANTLRInputStream invalid(invalidText);
+    ErrorCollector expectedErrors;
+    XPathLexer serial(&invalid);
+    serial.removeErrorListeners();
+    serial.addErrorListener(&expectedErrors);
+    expected = serial.getAllTokens();
+    expected.push_back(serial.nextToken());
+    ASSERT_EQ(expectedErrors.errors.size(), 2u);
+
+    parallel.setSplitPointPredicate([](const char32_t *, size_t, size_t) { return true; });
+    invalid.seek(0);
+    EXPECT_EQ(toStrings(parallel.tokenize(&invalid, 4)), toStrings(expected));
+    EXPECT_EQ(collector.errors, expectedErrors.errors);
+  }
+
+}
+}
@@ -0,0 +1,193 @@
+#include <string>
+
+#include "gtest/gtest.h"
+#include "ANTLRInputStream.h"
+#include "CommonTokenStream.h"
+#include "ParserInterpreter.h"
+#include "ParserRuleContext.h"
+#include "atn/ATNDeserializationOptions.h"
+#include "atn/DecisionState.h"
+#include "atn/ParserATNSimulator.h"
+#include "atn/StarLoopEntryState.h"
+#include "dfa/DFA.h"
+
+#include "ExprGrammar.h"
+
+namespace antlr4 {
+namespace {
+
+  constexpr const char *INPUT =
+    "def f(a, b) { a = 1 + 2 * b; return (a - 3) / b; }\n"
+    "def g(x) { x; ; return x * x + x; }\n";
+
+  using test::ExprGrammar;
+
+  size_t countStates(ParserInterpreter &parser) {
+    size_t count = 0;
+    for (const dfa::DFA &dfa : parser.getInterpreter<atn::ParserATNSimulator>()->decisionToDFA) {
+      count += dfa.states.size();
+    }
+    return count;
+  }
+
+  std::string parseExpr(bool compact, size_t *compactedStates, size_t *states) {
+    ANTLRInputStream input(INPUT);
+    auto lexer = ExprGrammar::createLexer(&input);
+    CommonTokenStream tokens(lexer.get());
+    auto parser = ExprGrammar::createParser(&tokens);
+    parser->getInterpreter<atn::ParserATNSimulator>()->setCompactDFAStates(compact);
+
+    std::string tree = parser->parse(ExprGrammar::RULE_prog)->toStringTree(parser.get());
+    *states = countStates(*parser);
+
+    // Parse a second time to run over the now warm DFA, which must not grow.
+    tokens.seek(0);
+    parser->reset();
+    EXPECT_EQ(parser->parse(ExprGrammar::RULE_prog)->toStringTree(parser.get()), tree);
+    EXPECT_EQ(parser->getNumberOfSyntaxErrors(), 0u);
+    EXPECT_EQ(countStates(*parser), *states);
+
+    *compactedStates = 0;
+    for (const dfa::DFA &dfa : parser->getInterpreter<atn::ParserATNSimulator>()->decisionToDFA) {
+      for (dfa::DFAState *state : dfa.states) {
+        if (state->isCompacted()) {
+          ++*compactedStates;
+        } else {
+          EXPECT_NE(state->configs, nullptr);
+        }
+      }
+    }
+    return tree;
+  }
+
+  TEST(ParserATNSimulatorTest, CompactDFAStates) {
+    size_t compacted = 0;
+    size_t states = 0;
+    std::string expected = parseExpr(false, &compacted, &states);
+    EXPECT_EQ(compacted, 0u);
+
+    // Targets recomputed along other edges still find the compacted states, so the DFA has as many states.
+    size_t compactStates = 0;
+    EXPECT_EQ(parseExpr(true, &compacted, &compactStates), expected);
+    EXPECT_GT(compacted, 0u);
+    EXPECT_EQ(compactStates, states);
+  }
+
+  TEST(ParserATNSimulatorTest, DenseEdges) {
+    ANTLRInputStream input(INPUT);
+    auto lexer = ExprGrammar::createLexer(&input);
+    CommonTokenStream tokens(lexer.get());
+    auto parser = ExprGrammar::createParser(&tokens);
+    parser->parse(ExprGrammar::RULE_prog);
+    EXPECT_EQ(parser->getNumberOfSyntaxErrors(), 0u);
+
+    size_t denseEdges = 0;
+    for (const dfa::DFA &dfa : parser->getInterpreter<atn::ParserATNSimulator>()->decisionToDFA) {
+      EXPECT_LE(dfa.getEdgeSlotCount(), ExprGrammar::parserATN().maxTokenType + 1);
+      for (size_t slot = 0; slot < dfa.getEdgeSlotCount(); ++slot) {
+        EXPECT_EQ(dfa.getEdgeSlot(dfa.getEdgeSlotTokenType(slot)), slot);
+      }
+      for (dfa::DFAState *state : dfa.states) {
+        EXPECT_TRUE(state->edges.empty());
+        EXPECT_LE(state->denseEdges.size(), dfa.getEdgeSlotCount());
+        for (dfa::DFAState *target : state->denseEdges) {
+          denseEdges += target != nullptr ? 1 : 0;
+        }
+      }
+    }
+    EXPECT_GT(denseEdges, 0u);
+
+    // Dense edges show up in the DFA dump like sparse ones did.
+    std::string dump;
+    for (const dfa::DFA &dfa : parser->getInterpreter<atn::ParserATNSimulator>()->decisionToDFA) {
+      dump += dfa.toString(ExprGrammar::vocabulary());
+    }
+    EXPECT_NE(dump.find("-ID->"), std::string::npos);
+    EXPECT_NE(dump.find("-'='->"), std::string::npos);
+  }
+
+  std::string parseWith(const atn::ATN &atn, size_t *predictions) {
+    ANTLRInputStream input(INPUT);
+    auto lexer = ExprGrammar::createLexer(&input);
+    CommonTokenStream tokens(lexer.get());
+    auto parser = ExprGrammar::createParser(&tokens, atn);
+    std::string tree = parser->parse(ExprGrammar::RULE_prog)->toStringTree(parser.get());
+    EXPECT_EQ(parser->getNumberOfSyntaxErrors(), 0u);
+
+    *predictions = 0;
+    for (const dfa::DFA &dfa : parser->getInterpreter<atn::ParserATNSimulator>()->decisionToDFA) {
+      *predictions += dfa.states.size();
+    }
+    return tree;
+  }
+
+  TEST(ParserATNSimulatorTest, LL1Decisions) {
+    const atn::ATN &atn = ExprGrammar::parserATN();
+    size_t ll1Decisions = 0;
+    for (atn::DecisionState *state : atn.decisionToState) {
+      if (state->ll1Alts.empty()) {
+        continue;
+      }
+      ++ll1Decisions;
+      auto *loopEntry = dynamic_cast<atn::StarLoopEntryState *>(state);
+      EXPECT_TRUE(loopEntry == nullptr || !loopEntry->isPrecedenceDecision);
+    }
+    EXPECT_GT(ll1Decisions, 0u);
+
+    // primary: INT | ID | '(' expr ')'
+    atn::DecisionState *primary = nullptr;
+    for (atn::DecisionState *state : atn.decisionToState) {
+      if (state->ruleIndex == ExprGrammar::RULE_primary) {
+        primary = state;
+      }
+    }
+    ASSERT_NE(primary, nullptr);
+    EXPECT_EQ(primary->getLL1Alt(ExprGrammar::INT), 1u);
+    EXPECT_EQ(primary->getLL1Alt(ExprGrammar::ID), 2u);
+    EXPECT_EQ(primary->getLL1Alt(ExprGrammar::T__1), 3u);
+    EXPECT_EQ(primary->getLL1Alt(ExprGrammar::MUL), atn::ATN::INVALID_ALT_NUMBER);
+    EXPECT_EQ(primary->getLL1Alt(Token::EOF), atn::ATN::INVALID_ALT_NUMBER);
+
+    atn::ATNDeserializationOptions options;
+    options.setGenerateLL1Tables(false);
+    atn::ATN plainATN = atn::ATNDeserializer(options).deserialize(ExprGrammar::serializedParserATN());
+    for (atn::DecisionState *state : plainATN.decisionToState) {
+      EXPECT_TRUE(state->ll1Alts.empty());
+    }
+
+    // Same trees, but LL(1) decisions no longer build DFA states.
+    size_t fastPredictions = 0;
+    size_t plainPredictions = 0;
+    EXPECT_EQ(parseWith(atn, &fastPredictions), parseWith(plainATN, &plainPredictions));
+    EXPECT_LT(fastPredictions, plainPredictions);
+  }
+
+  std::string parseWithClosureThreads(size_t threads, std::string *dfaDump) {
+    ANTLRInputStream input(INPUT);
+    auto lexer = ExprGrammar::createLexer(&input);
+    CommonTokenStream tokens(lexer.get());
+    auto parser = ExprGrammar::createParser(&tokens);
+    parser->getInterpreter<atn::ParserATNSimulator>()->setParallelClosure(threads, 1);
+    std::string tree = parser->parse(ExprGrammar::RULE_prog)->toStringTree(parser.get());
+    EXPECT_EQ(parser->getNumberOfSyntaxErrors(), 0u);
+
+    dfaDump->clear();
+    for (const dfa::DFA &dfa : parser->getInterpreter<atn::ParserATNSimulator>()->decisionToDFA) {
+      *dfaDump += dfa.toString(ExprGrammar::vocabulary());
+    }
+    return tree;
+  }
+
+  TEST(ParserATNSimulatorTest, ParallelClosure) {
+    std::string serialDump;
+    std::string serialTree = parseWithClosureThreads(0, &serialDump);
+
+    // Merging per-root results in order must give the very same DFA as the serial closure.
+    std::string parallelDump;
+    EXPECT_EQ(parseWithClosureThreads(4, &parallelDump), serialTree);
+    EXPECT_EQ(parallelDump, serialDump);
+    EXPECT_FALSE(serialDump.empty());
+  }
+
+}
+}
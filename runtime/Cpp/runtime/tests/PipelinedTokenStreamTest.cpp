@@ -0,0 +1,108 @@
+#include <string>
+
+#include "gtest/gtest.h"
+#include "ANTLRInputStream.h"
+#include "CommonToken.h"
+#include "CommonTokenStream.h"
+#include "Exceptions.h"
+#include "ListTokenSource.h"
+#include "ParserRuleContext.h"
+#include "PipelinedTokenStream.h"
+
+#include "ExprGrammar.h"
+
+namespace antlr4 {
+namespace {
+
+  using test::ExprGrammar;
+
+  std::string parse(TokenStream *tokens) {
+    auto parser = ExprGrammar::createParser(tokens);
+    return parser->parse(ExprGrammar::RULE_prog)->toStringTree(parser.get());
+  }
+
+  // Fails after passing on a few tokens.
+  class FailingTokenSource : public ListTokenSource {
+  public:
+    FailingTokenSource() : ListTokenSource(tokens()) {
+    }
+
+    std::unique_ptr<Token> nextToken() override {
+      if (++_count > 10) {
+        throw IllegalStateException("broken input");
+      }
+      return ListTokenSource::nextToken();
+    }
+
+  private:
+    size_t _count = 0;
+
+    static std::vector<std::unique_ptr<Token>> tokens() {
+      std::vector<std::unique_ptr<Token>> result;
+      for (size_t i = 0; i < 20; ++i) {
+        result.push_back(std::make_unique<CommonToken>(ExprGrammar::ID, "x"));
+      }
+      return result;
+    }
+  };
+
+  TEST(PipelinedTokenStreamTest, MatchesCommonTokenStream) {
+    ANTLRInputStream input(ExprGrammar::sampleProgram(2000));
+    auto lexer = ExprGrammar::createLexer(&input);
+    CommonTokenStream expected(lexer.get());
+    std::string tree = parse(&expected);
+
+    // Small batches in a small ring, so the producer waits for the parser and the ring wraps around.
+    input.reset();
+    lexer = ExprGrammar::createLexer(&input);
+    PipelinedTokenStream tokens(lexer.get());
+    tokens.setBatchSize(7);
+    tokens.setCapacity(3);
+    EXPECT_EQ(parse(&tokens), tree);
+    ASSERT_EQ(tokens.size(), expected.size());
+    for (size_t i = 0; i < tokens.size(); ++i) {
+      EXPECT_EQ(tokens.get(i)->toString(), expected.get(i)->toString());
+    }
+
+    tokens.seek(0);
+    EXPECT_EQ(tokens.LT(1)->getText(), "def");
+    EXPECT_EQ(tokens.LT(2)->getText(), "f");
+  }
+
+  TEST(PipelinedTokenStreamTest, StopsProducerEarly) {
+    std::string text;
+    for (size_t i = 0; i < 1000; ++i) {
+      text += "a = b;\n";
+    }
+
+    ANTLRInputStream input(text);
+    auto lexer = ExprGrammar::createLexer(&input);
+    {
+      PipelinedTokenStream tokens(lexer.get());
+      tokens.setBatchSize(4);
+      tokens.setCapacity(2);
+      EXPECT_EQ(tokens.LT(1)->getText(), "a");
+    }
+
+    ANTLRInputStream other("b;");
+    auto otherLexer = ExprGrammar::createLexer(&other);
+    PipelinedTokenStream tokens(lexer.get());
+    tokens.setBatchSize(1);
+    tokens.setCapacity(1);
+    EXPECT_EQ(tokens.LT(1)->getType(), ExprGrammar::ID);
+    tokens.setTokenSource(otherLexer.get());
+    tokens.fill();
+    EXPECT_EQ(tokens.size(), 3u);
+  }
+
+  TEST(PipelinedTokenStreamTest, RethrowsErrors) {
+    FailingTokenSource source;
+    PipelinedTokenStream tokens(&source);
+    tokens.setBatchSize(4);
+    EXPECT_THROW(tokens.fill(), IllegalStateException);
+    EXPECT_EQ(tokens.size(), 10u);
+    EXPECT_THROW(tokens.fill(), IllegalStateException);
+  }
+
+}
+}
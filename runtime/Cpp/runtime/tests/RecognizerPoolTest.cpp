@@ -0,0 +1,81 @@
+#include <string>
+#include <thread>
+
+#include "gtest/gtest.h"
+#include "ANTLRInputStream.h"
+#include "CommonTokenStream.h"
+#include "ParserInterpreter.h"
+#include "ParserRuleContext.h"
+#include "RecognizerPool.h"
+
+#include "ExprGrammar.h"
+
+namespace antlr4 {
+namespace {
+
+  using test::ExprGrammar;
+
+  RecognizerPool createPool() {
+    return RecognizerPool([](CharStream *input) { return ExprGrammar::createLexer(input); },
+                          [](TokenStream *input) { return ExprGrammar::createParser(input); });
+  }
+
+  std::string parse(RecognizerPool &pool, const std::string &text, Parser **parser = nullptr) {
+    ANTLRInputStream input(text);
+    RecognizerPool::Lease lease = pool.acquire(&input);
+    if (parser != nullptr) {
+      *parser = lease.getParser();
+    }
+    ParserRuleContext *tree = lease.getParser<ParserInterpreter>()->parse(ExprGrammar::RULE_prog);
+    return std::to_string(lease.getParser()->getNumberOfSyntaxErrors()) + " " +
+      tree->toStringTree(lease.getParser());
+  }
+
+  TEST(RecognizerPoolTest, ReusesRecognizers) {
+    RecognizerPool pool(createPool());
+    Parser *first = nullptr;
+    Parser *second = nullptr;
+    std::string text = "def f(a) { return a * 2; }\n";
+    std::string expected = parse(pool, text, &first);
+    EXPECT_EQ(expected.substr(0, 2), "0 ");
+
+    // The input of the first parse is gone, the next one starts afresh.
+    EXPECT_EQ(parse(pool, "def g(b) { b = ; }", &second).substr(0, 2), "1 ");
+    EXPECT_EQ(first, second);
+    EXPECT_TRUE(first->getTreeTracker().isRetainingMemory());
+    EXPECT_EQ(parse(pool, text), expected);
+    EXPECT_EQ(pool.size(), 1u);
+
+    // Recognizers in use are not handed out again.
+    ANTLRInputStream input(text);
+    RecognizerPool::Lease lease = pool.acquire(&input);
+    EXPECT_EQ(parse(pool, text, &second), expected);
+    EXPECT_NE(lease.getParser(), second);
+    EXPECT_EQ(pool.size(), 2u);
+  }
+
+  TEST(RecognizerPoolTest, IsSharedByThreads) {
+    RecognizerPool pool(createPool());
+    std::string text = ExprGrammar::sampleProgram(20);
+    std::string expected = parse(pool, text);
+
+    std::vector<std::thread> threads;
+    std::vector<size_t> mismatches(4);
+    for (size_t t = 0; t < mismatches.size(); ++t) {
+      threads.emplace_back([&, t]() {
+        for (size_t i = 0; i < 25; ++i) {
+          if (parse(pool, text) != expected) {
+            ++mismatches[t];
+          }
+        }
+      });
+    }
+    for (std::thread &thread : threads) {
+      thread.join();
+    }
+    EXPECT_EQ(mismatches, std::vector<size_t>(4, 0));
+    EXPECT_LE(pool.size(), 4u);
+  }
+
+}
+}
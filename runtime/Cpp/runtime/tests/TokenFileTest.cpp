@@ -0,0 +1,104 @@
+#include <fstream>
+#include <string>
+
+#include "gtest/gtest.h"
+#include "ANTLRInputStream.h"
+#include "CommonTokenStream.h"
+#include "Exceptions.h"
+#include "MappedTokenSource.h"
+#include "ParserRuleContext.h"
+#include "Token.h"
+#include "TokenFile.h"
+
+#include "ExprGrammar.h"
+
+namespace antlr4 {
+namespace {
+
+  using test::ExprGrammar;
+
+  std::vector<std::string> describe(const std::vector<Token *> &tokens) {
+    std::vector<std::string> result;
+    for (Token *token : tokens) {
+      result.push_back(token->toString() + " " + std::to_string(token->getTokenIndex()));
+    }
+    return result;
+  }
+
+  TEST(TokenFileTest, LoadsTokensWithoutLexing) {
+    ANTLRInputStream input(ExprGrammar::sampleProgram(100));
+    auto lexer = ExprGrammar::createLexer(&input);
+    CommonTokenStream lexed(lexer.get());
+    lexed.fill();
+
+    std::string withText = ::testing::TempDir() + "tokens-with-text.bin";
+    std::string withoutText = ::testing::TempDir() + "tokens-without-text.bin";
+    TokenFile::write(withText, lexed.getTokens(), "Expr input");
+    TokenFile::write(withoutText, lexed.getTokens(), "", false);
+
+    TokenFile file(withText);
+    EXPECT_TRUE(file.hasText());
+    EXPECT_EQ(file.size(), lexed.size());
+    EXPECT_EQ(file.getSourceName(), "Expr input");
+
+    MappedTokenSource source(file);
+    CommonTokenStream tokens(&source);
+    tokens.fill();
+    EXPECT_EQ(describe(tokens.getTokens()), describe(lexed.getTokens()));
+    EXPECT_EQ(tokens.getText(), lexed.getText());
+
+    auto parser = ExprGrammar::createParser(&tokens);
+    auto *tree = parser->parse(ExprGrammar::RULE_prog);
+    EXPECT_EQ(parser->getNumberOfSyntaxErrors(), 0u);
+    EXPECT_EQ(tree->getText(), lexed.getText());
+
+    // Without text, it is taken from the input.
+    TokenFile plain(withoutText);
+    EXPECT_FALSE(plain.hasText());
+    MappedTokenSource plainSource(plain, &input);
+    CommonTokenStream plainTokens(&plainSource);
+    plainTokens.fill();
+    EXPECT_EQ(describe(plainTokens.getTokens()), describe(lexed.getTokens()));
+    EXPECT_EQ(plainSource.getSourceName(), input.getSourceName());
+
+    std::remove(withText.c_str());
+    std::remove(withoutText.c_str());
+  }
+
+  TEST(TokenFileTest, RejectsInvalidFiles) {
+    EXPECT_THROW(TokenFile(::testing::TempDir() + "no-such-token-file.bin"), IOException);
+
+    std::string fileName = ::testing::TempDir() + "invalid-tokens.bin";
+    {
+      std::ofstream output(fileName, std::ios::binary);
+      output << "not a token file, but long enough for a header";
+    }
+    EXPECT_THROW(TokenFile file(fileName), IllegalArgumentException);
+
+    // A truncated file.
+    std::string valid;
+    {
+      std::ostringstream output;
+      TokenFile::write(output, {}, "empty");
+      valid = output.str();
+    }
+    {
+      std::ofstream output(fileName, std::ios::binary);
+      output << valid.substr(0, valid.size() - 1);
+    }
+    EXPECT_THROW(TokenFile file(fileName), IllegalArgumentException);
+
+    // Without tokens, EOF is written.
+    {
+      std::ofstream output(fileName, std::ios::binary);
+      output << valid;
+    }
+    TokenFile file(fileName);
+    ASSERT_EQ(file.size(), 1u);
+    EXPECT_EQ(file.getType(0), Token::EOF);
+    EXPECT_THROW(file.getType(1), IndexOutOfBoundsException);
+    std::remove(fileName.c_str());
+  }
+
+}
+}
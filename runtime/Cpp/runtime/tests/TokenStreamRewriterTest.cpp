@@ -0,0 +1,175 @@
+#include <sstream>
+#include <string>
+
+#include "gtest/gtest.h"
+#include "CommonToken.h"
+#include "CommonTokenStream.h"
+#include "Exceptions.h"
+#include "ListTokenSource.h"
+#include "TokenStreamRewriter.h"
+#include "misc/Interval.h"
+
+namespace antlr4 {
+namespace {
+
+  // One token per character of text.
+  class Rewriter {
+  public:
+    explicit Rewriter(const std::string &text) : _source(createTokens(text)), _tokens(&_source), rewriter(&_tokens) {
+      _tokens.fill();
+    }
+
+    TokenStreamRewriter& operator*() { return rewriter; }
+    TokenStreamRewriter* operator->() { return &rewriter; }
+
+  private:
+    static std::vector<std::unique_ptr<Token>> createTokens(const std::string &text) {
+      std::vector<std::unique_ptr<Token>> tokens;
+      for (char c : text) {
+        tokens.push_back(std::make_unique<CommonToken>(1, std::string(1, c)));
+      }
+      return tokens;
+    }
+
+    ListTokenSource _source;
+    CommonTokenStream _tokens;
+    TokenStreamRewriter rewriter;
+  };
+
+  TEST(TokenStreamRewriterTest, CombinesOperations) {
+    Rewriter inserts("abc");
+    inserts->insertBefore(size_t(0), "0");
+    inserts->insertAfter(2, "x");
+    inserts->insertBefore(1, "x");
+    inserts->insertAfter(1, "y");
+    inserts->insertBefore(1, "y");
+    EXPECT_EQ(inserts->getText(), "0ayxbycx");
+
+    Rewriter replaces("abcccba");
+    replaces->replace(2, 4, "xyz");
+    replaces->replace(size_t(0), "X");
+    replaces->insertBefore(size_t(0), "0");
+    replaces->insertBefore(2, "_");
+    EXPECT_EQ(replaces->getText(), "0Xb_xyzba");
+    EXPECT_EQ(replaces->getText(misc::Interval(size_t(2), size_t(4))), "_xyz");
+
+    // A replace drops the inserts and replaces within it, except for inserts at its start.
+    Rewriter containing("abcc");
+    containing->insertBefore(2, "u");
+    containing->replace(1, 2, "foo");
+    containing->insertBefore(size_t(0), "y");
+    containing->replace(0, 3, "bar");
+    EXPECT_EQ(containing->getText(), "ybar");
+
+    Rewriter repeated("abc");
+    repeated->replace(1, "x");
+    repeated->insertBefore(1, "0");
+    repeated->replace(1, "z");
+    EXPECT_EQ(repeated->getText(), "a0zc");
+
+    // Overlapping deletes are combined.
+    Rewriter deletes("abcdefg");
+    deletes->Delete(1, 3);
+    deletes->Delete(2, 5);
+    deletes->insertAfter(6, "!");
+    EXPECT_EQ(deletes->getText(), "ag!");
+    EXPECT_EQ(deletes->getText(misc::Interval(size_t(0), size_t(5))), "a");
+  }
+
+  TEST(TokenStreamRewriterTest, ThrowsOnConflicts) {
+    Rewriter overlapping("abcde");
+    overlapping->replace(1, 3, "x");
+    overlapping->replace(2, 4, "y");
+    EXPECT_THROW(overlapping->getText(), IllegalArgumentException);
+
+    Rewriter within("abcde");
+    within->replace(1, 3, "x");
+    within->insertBefore(2, "y");
+    EXPECT_THROW(within->getText(), IllegalArgumentException);
+
+    // Rolling back the conflicting operation works, as the program was not changed by rendering.
+    within->rollback(1);
+    EXPECT_EQ(within->getText(), "axe");
+    within->deleteProgram();
+    EXPECT_EQ(within->getText(), "abcde");
+  }
+
+  TEST(TokenStreamRewriterTest, RendersManyOperations) {
+    std::string text;
+    for (size_t i = 0; i < 20000; ++i) {
+      text += "ab";
+    }
+
+    Rewriter rewriter(text);
+    for (size_t i = 0; i < text.size(); i += 2) {
+      rewriter->replace(i, "x");
+      rewriter->insertAfter(i + 1, ";");
+    }
+    rewriter->insertBefore("other", size_t(0), "<");
+
+    std::string expected;
+    for (size_t i = 0; i < text.size(); i += 2) {
+      expected += "xb;";
+    }
+    EXPECT_EQ(rewriter->getText(), expected);
+    EXPECT_EQ(rewriter->getText(), expected);
+    EXPECT_EQ(rewriter->getText("other"), "<" + text);
+
+    std::ostringstream output;
+    rewriter->getText(TokenStreamRewriter::DEFAULT_PROGRAM_NAME, misc::Interval(size_t(0), text.size()), output);
+    EXPECT_EQ(output.str(), expected);
+
+    // The rendering is updated with the program.
+    rewriter->Delete(0, 1);
+    EXPECT_EQ(rewriter->getText(), expected.substr(2));
+  }
+
+  TEST(TokenStreamRewriterTest, RendersConcurrently) {
+    std::string text;
+    for (size_t i = 0; i < 1000; ++i) {
+      text += "abc";
+    }
+
+    Rewriter rewriter(text);
+    std::vector<std::string> names;
+    for (size_t p = 0; p < 8; ++p) {
+      names.push_back("fix" + std::to_string(p));
+      for (size_t i = p; i < text.size(); i += 8) {
+        rewriter->replace(names.back(), i, i, std::to_string(p));
+      }
+    }
+    rewriter->insertBefore("conflict", size_t(1), "x");
+    rewriter->replace("conflict", 0, 2, "y");
+    rewriter->insertBefore("conflict", size_t(1), "z");
+
+    std::vector<std::string> expected;
+    for (const std::string &name : names) {
+      expected.push_back(rewriter->getText(name));
+    }
+    EXPECT_EQ(rewriter->getTexts(names, 4), expected);
+    EXPECT_THROW(rewriter->getTexts({ "fix0", "conflict" }, 4), IllegalArgumentException);
+    rewriter->deleteProgram("conflict");
+
+    std::map<std::string, std::string> all;
+    for (size_t threadCount : { 1, 3, 0 }) {
+      rewriter->Delete("fix1", 0, 1);
+      all = rewriter->getTexts(threadCount);
+      EXPECT_EQ(all.size(), 10u);
+      EXPECT_EQ(all["fix1"], rewriter->getText("fix1"));
+    }
+    EXPECT_EQ(all["default"], text);
+    EXPECT_EQ(all["fix1"].substr(0, 3), "cab");
+
+    std::vector<misc::Interval> intervals;
+    for (size_t i = 0; i < text.size(); i += 100) {
+      intervals.push_back(misc::Interval(i, i + 99));
+    }
+    std::vector<std::string> texts = rewriter->getTexts("fix2", intervals, 4);
+    ASSERT_EQ(texts.size(), intervals.size());
+    for (size_t i = 0; i < intervals.size(); ++i) {
+      EXPECT_EQ(texts[i], rewriter->getText("fix2", intervals[i]));
+    }
+  }
+
+}
+}
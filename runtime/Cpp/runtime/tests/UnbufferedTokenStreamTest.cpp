@@ -0,0 +1,88 @@
+#include <string>
+
+#include "gtest/gtest.h"
+#include "ANTLRInputStream.h"
+#include "Exceptions.h"
+#include "Token.h"
+#include "UnbufferedTokenStream.h"
+
+#include "ExprGrammar.h"
+
+namespace antlr4 {
+namespace {
+
+  using test::ExprGrammar;
+
+  std::string statements(size_t count) {
+    std::string text;
+    for (size_t i = 0; i < count; ++i) {
+      text += "a = b;\n";
+    }
+    return text;
+  }
+
+  TEST(UnbufferedTokenStreamTest, KeepsAWindow) {
+    ANTLRInputStream input(statements(1000));
+    auto lexer = ExprGrammar::createLexer(&input);
+    UnbufferedTokenStream tokens(lexer.get(), 8);
+
+    for (size_t i = 0; i < 100; ++i) {
+      tokens.consume();
+    }
+    EXPECT_EQ(tokens.index(), 100u);
+    EXPECT_EQ(tokens.LT(1)->getTokenIndex(), 100u);
+    EXPECT_EQ(tokens.LT(-1)->getTokenIndex(), 99u);
+    EXPECT_EQ(tokens.LT(3)->getText(), "b");
+    EXPECT_THROW(tokens.get(50), IndexOutOfBoundsException);
+
+    // Marks keep the tokens from their position on, until the window is full.
+    ssize_t marker = tokens.mark();
+    for (size_t i = 0; i < 6; ++i) {
+      tokens.consume();
+    }
+    tokens.seek(100);
+    EXPECT_EQ(tokens.LT(1)->getTokenIndex(), 100u);
+    EXPECT_EQ(tokens.LT(-1)->getTokenIndex(), 99u);
+    EXPECT_THROW(tokens.LT(8), IllegalStateException);
+    tokens.release(marker);
+
+    // Without the mark, the window moves on.
+    for (size_t i = 0; i < 10; ++i) {
+      tokens.consume();
+    }
+    EXPECT_EQ(tokens.LT(7)->getTokenIndex(), 116u);
+    EXPECT_THROW(tokens.seek(100), UnsupportedOperationException);
+  }
+
+  TEST(UnbufferedTokenStreamTest, GrowsWithoutBufferSize) {
+    ANTLRInputStream input(statements(1000));
+    auto lexer = ExprGrammar::createLexer(&input);
+    UnbufferedTokenStream tokens(lexer.get());
+
+    // A mark keeps all tokens from its position on, however many.
+    tokens.consume();
+    ssize_t marker = tokens.mark();
+    for (size_t i = 0; i < 1000; ++i) {
+      tokens.consume();
+    }
+    EXPECT_EQ(tokens.LT(1000)->getTokenIndex(), 2000u);
+    tokens.seek(1);
+    EXPECT_EQ(tokens.LT(1)->getTokenIndex(), 1u);
+    EXPECT_EQ(tokens.LT(-1)->getTokenIndex(), 0u);
+    EXPECT_EQ(tokens.LT(2)->getText(), "b");
+    tokens.release(marker);
+  }
+
+  TEST(UnbufferedTokenStreamTest, ParsesInBoundedMemory) {
+    ANTLRInputStream input(ExprGrammar::sampleProgram(500));
+    auto lexer = ExprGrammar::createLexer(&input);
+    UnbufferedTokenStream tokens(lexer.get(), 16);
+    auto parser = ExprGrammar::createParser(&tokens);
+    parser->setBuildParseTree(false);
+    parser->parse(ExprGrammar::RULE_prog);
+    EXPECT_EQ(parser->getNumberOfSyntaxErrors(), 0u);
+    EXPECT_EQ(tokens.LA(1), Token::EOF);
+  }
+
+}
+}
@@ -0,0 +1,104 @@
+#include <sstream>
+#include <string>
+
+#include "gtest/gtest.h"
+#include "ANTLRInputStream.h"
+#include "CommonTokenFactory.h"
+#include "Exceptions.h"
+#include "Token.h"
+#include "UnbufferedUtf8CharStream.h"
+#include "misc/Interval.h"
+
+#ifndef _WIN32
+#include <unistd.h>
+#endif
+
+#include "ExprGrammar.h"
+
+namespace antlr4 {
+namespace {
+
+  using test::ExprGrammar;
+
+  std::vector<std::string> lex(CharStream *input) {
+    CommonTokenFactory factory(true);
+    auto lexer = ExprGrammar::createLexer(input);
+    lexer->setTokenFactory(&factory);
+
+    // Token by token, as the lexer keeps the text of a batch of tokens. The text of EOF is looked up in the input,
+    // by its size, which is unknown.
+    std::vector<std::string> result;
+    while (true) {
+      std::unique_ptr<Token> token = lexer->nextToken();
+      result.push_back(std::to_string(token->getType()) + " " +
+                       (token->getType() == Token::EOF ? "<EOF>" : token->getText()) + " " +
+                       std::to_string(token->getStartIndex()) + " " + std::to_string(token->getLine()) + ":" +
+                       std::to_string(token->getCharPositionInLine()));
+      if (token->getType() == Token::EOF) {
+        break;
+      }
+    }
+    return result;
+  }
+
+  TEST(UnbufferedUtf8CharStreamTest, DecodesAcrossBlocks) {
+    std::istringstream bytes("\xef\xbb\xbf" "a\xc3\xa4\xe2\x82\xac\xf0\x9f\x98\x80z");
+    UnbufferedUtf8CharStream input(bytes, false, 2);
+    EXPECT_EQ(input.LA(1), U'a');
+    EXPECT_EQ(input.LA(2), U'ä');
+    EXPECT_EQ(input.LA(3), U'€');
+    EXPECT_EQ(input.LA(4), U'\U0001f600');
+    EXPECT_EQ(input.LA(5), U'z');
+    EXPECT_EQ(input.LA(6), static_cast<size_t>(IntStream::EOF));
+    EXPECT_EQ(input.getText(misc::Interval(size_t(1), size_t(3))), "\xc3\xa4\xe2\x82\xac\xf0\x9f\x98\x80");
+
+    std::istringstream illegal("ab\xc3");
+    UnbufferedUtf8CharStream strict(illegal, false, 2);
+    EXPECT_EQ(strict.LA(2), U'b');
+    EXPECT_THROW(strict.LA(3), IllegalArgumentException);
+
+    std::istringstream replaced("ab\xc3");
+    UnbufferedUtf8CharStream lenient(replaced, true, 2);
+    EXPECT_EQ(lenient.LA(3), 0xfffdu);
+  }
+
+  TEST(UnbufferedUtf8CharStreamTest, KeepsOnlyMarkedData) {
+    std::string text = ExprGrammar::sampleProgram(1000);
+
+    ANTLRInputStream buffered(text);
+    std::istringstream bytes(text);
+    UnbufferedUtf8CharStream input(bytes, false, 64);
+    EXPECT_EQ(lex(&input), lex(&buffered));
+    EXPECT_THROW(input.seek(0), UnsupportedOperationException);
+    EXPECT_LT(input.toString().size(), 128u);
+
+    // Marked data stays.
+    std::istringstream more(text);
+    UnbufferedUtf8CharStream marked(more, false, 16);
+    marked.seek(6);
+    ssize_t marker = marked.mark();
+    marked.seek(200);
+    marked.seek(6);
+    EXPECT_EQ(marked.getText(misc::Interval(size_t(6), size_t(9))), "a, b");
+    marked.release(marker);
+    marked.seek(1000);
+    EXPECT_THROW(marked.seek(10), UnsupportedOperationException);
+  }
+
+#ifndef _WIN32
+  TEST(UnbufferedUtf8CharStreamTest, ReadsFileDescriptors) {
+    int fds[2];
+    ASSERT_EQ(pipe(fds), 0);
+    std::string text = "def g() { 1; }\n";
+    ASSERT_EQ(write(fds[1], text.data(), text.size()), static_cast<ssize_t>(text.size()));
+    close(fds[1]);
+
+    UnbufferedUtf8CharStream input(fds[0], false, 4);
+    ANTLRInputStream buffered(text);
+    EXPECT_EQ(lex(&input), lex(&buffered));
+    close(fds[0]);
+  }
+#endif
+
+}
+}
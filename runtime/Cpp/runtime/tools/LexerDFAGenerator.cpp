@@ -0,0 +1,56 @@
+/* Copyright (c) 2012-2017 The ANTLR Project. All rights reserved.
+ * Use of this file is governed by the BSD 3-clause license that
+ * can be found in the LICENSE.txt file in the project root.
+ */
+
+// antlr4_lexer_dfa: compiles the lexer described by an interpreter data file (the <Lexer>.interp file written
+// by the ANTLR tool) ahead of time into a DFA table and writes it as a C++ header.
+//
+//   antlr4_lexer_dfa <Lexer.interp> <output.h> <table name> [<namespace>]
+//
+// Use the table with atn::LexerDFATableSimulator.
+
+#include <fstream>
+#include <iostream>
+
+#include "atn/ATN.h"
+#include "atn/ATNType.h"
+#include "atn/LexerDFACompiler.h"
+#include "misc/InterpreterDataReader.h"
+
+using namespace antlr4;
+
+int main(int argc, const char *argv[]) {
+  if (argc < 4 || argc > 5) {
+    std::cerr << "usage: " << argv[0] << " <Lexer.interp> <output.h> <table name> [<namespace>]" << std::endl;
+    return 2;
+  }
+
+  try {
+    misc::InterpreterData data = misc::InterpreterDataReader::parseFile(argv[1]);
+    if (data.atn.grammarType != atn::ATNType::LEXER || data.atn.modeToStartState.empty()) {
+      std::cerr << argv[1] << ": not a lexer interpreter data file" << std::endl;
+      return 1;
+    }
+
+    atn::LexerDFACompiler compiler(data.atn);
+    compiler.compile();
+    for (size_t mode = 0; mode < data.atn.modeToStartState.size(); ++mode) {
+      if (!compiler.isModeCompiled(mode)) {
+        std::string name = mode < data.modes.size() ? data.modes[mode] : std::to_string(mode);
+        std::cerr << "note: mode " << name << " uses predicates or custom actions and stays on the ATN" << std::endl;
+      }
+    }
+
+    std::ofstream output(argv[2], std::ios::binary);
+    output << compiler.toCppSource(argv[3], argc == 5 ? argv[4] : "");
+    if (!output.good()) {
+      std::cerr << argv[2] << ": cannot write" << std::endl;
+      return 1;
+    }
+  } catch (std::exception &e) {
+    std::cerr << argv[1] << ": " << e.what() << std::endl;
+    return 1;
+  }
+  return 0;
+}